@@ -0,0 +1,315 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/pch.h"
+
+#include <fstream>
+
+#include "bench/benchmark.h"
+#include "client/graphics/meshBuilder.h"
+#include "core/chunk.h"
+#include "core/compression.h"
+#include "core/entities/ECS.h"
+#include "core/entities/physicsBodies.h"
+#include "core/entities/components/physicsComponent.h"
+#include "core/entities/components/transformComponent.h"
+#include "core/lighting.h"
+#include "core/random.h"
+#include "core/serverWorld.h"
+#include "core/terrainGen.h"
+
+using namespace lonelycube;
+
+using namespace lonelycube::bench;
+
+static constexpr int BLOCKS_PER_CHUNK = constants::CHUNK_SIZE * constants::CHUNK_SIZE
+    * constants::CHUNK_SIZE;
+static constexpr std::array<uint64_t, 3> SEEDS = { 1, 42, 1234567 };
+// Seed 42 has a hillside here, so the chunk has a mix of uniform and varied layers
+static constexpr uint64_t ACCESS_SEED = 42;
+static const IVec3 ACCESS_CHUNK_POSITION(0, 1, 0);
+// The chunks that are generated, lit and meshed cover the surface of the world, from
+// underground to the sky
+static constexpr int MIN_CHUNK_Y = -2;
+static constexpr int MAX_CHUNK_Y = 3;
+static constexpr int NUM_PHYSICS_ENTITIES = 10000;
+
+using ChunkPacket = Packet<uint8_t, 9 * BLOCKS_PER_CHUNK>;
+
+static void printUsage()
+{
+    std::cout << "Usage: bench [options]\n"
+        << "  --filter <text>       Only run benchmarks with names containing the text\n"
+        << "  --min-time <seconds>  Minimum time to spend on each benchmark (default 1)\n"
+        << "  --output <path>       Write the JSON results to a file instead of stdout\n";
+}
+
+static void seedWorld(uint64_t seed)
+{
+    PCG_SeedRandom32(seed);
+    seedNoise();
+}
+
+// Generates a column of chunks at x and z from MIN_CHUNK_Y to MAX_CHUNK_Y, with a border of
+// chunks around it so that the column can be lit and meshed
+static void generateRegion(std::unordered_map<IVec3, Chunk>& chunks, uint64_t seed)
+{
+    seedWorld(seed);
+    for (int x = -1; x <= 1; x++)
+    {
+        for (int y = MIN_CHUNK_Y - 1; y <= MAX_CHUNK_Y + 1; y++)
+        {
+            for (int z = -1; z <= 1; z++)
+            {
+                IVec3 chunkPosition(x, y, z);
+                chunks[chunkPosition] = { chunkPosition };
+                Chunk& chunk = chunks.at(chunkPosition);
+                TerrainGen().generateTerrain(chunk, seed);
+                chunk.setSkyLightBeingRelit(false);
+                chunk.setBlockLightBeingRelit(false);
+            }
+        }
+    }
+}
+
+// Lights the column from the top down, as the client does once each chunk's neighbours load
+static void lightColumn(std::unordered_map<IVec3, Chunk>& chunks, const ResourcePack& resourcePack)
+{
+    bool neighbouringChunksToRelight[6];
+    bool chunksToRemesh[7];
+    for (int y = MAX_CHUNK_Y; y >= MIN_CHUNK_Y; y--)
+    {
+        IVec3 chunkPosition(0, y, 0);
+        chunks.at(chunkPosition).clearSkyLight();
+        Lighting::propagateSkyLight(
+            chunkPosition, chunks, neighbouringChunksToRelight, chunksToRemesh, resourcePack
+        );
+    }
+}
+
+static void benchmarkChunkAccess(BenchmarkRunner& runner, ServerWorld<true>& world)
+{
+    std::unordered_map<IVec3, Chunk>& chunks = world.chunkManager.getWorldChunks();
+    generateRegion(chunks, ACCESS_SEED);
+    lightColumn(chunks, world.getResourcePack());
+    const Chunk& chunk = chunks.at(ACCESS_CHUNK_POSITION);
+
+    runner.run("chunk/getBlock/sequential", BLOCKS_PER_CHUNK, nullptr, [&]() {
+        uint32_t sum = 0;
+        for (uint32_t blockNum = 0; blockNum < BLOCKS_PER_CHUNK; blockNum++)
+            sum += chunk.getBlock(blockNum);
+        doNotOptimise(sum);
+    });
+
+    std::vector<uint32_t> randomBlockNums(BLOCKS_PER_CHUNK);
+    for (uint32_t i = 0; i < BLOCKS_PER_CHUNK; i++)
+        randomBlockNums[i] = PCG_Hash32(i) % BLOCKS_PER_CHUNK;
+    runner.run("chunk/getBlock/random", BLOCKS_PER_CHUNK, nullptr, [&]() {
+        uint32_t sum = 0;
+        for (uint32_t blockNum : randomBlockNums)
+            sum += chunk.getBlock(blockNum);
+        doNotOptimise(sum);
+    });
+
+    runner.run("chunk/getSkyLight/sequential", BLOCKS_PER_CHUNK, nullptr, [&]() {
+        uint32_t sum = 0;
+        for (uint32_t blockNum = 0; blockNum < BLOCKS_PER_CHUNK; blockNum++)
+            sum += chunk.getSkyLight(blockNum);
+        doNotOptimise(sum);
+    });
+
+    Chunk writableChunk(ACCESS_CHUNK_POSITION);
+    runner.run("chunk/setBlock/sequential", BLOCKS_PER_CHUNK, nullptr, [&]() {
+        for (uint32_t blockNum = 0; blockNum < BLOCKS_PER_CHUNK; blockNum++)
+            writableChunk.setBlock(blockNum, chunk.getBlock(blockNum));
+        doNotOptimise(writableChunk);
+    });
+    writableChunk.unload();
+
+    Chunk& compressibleChunk = chunks.at(ACCESS_CHUNK_POSITION);
+    runner.run("chunk/compressBlocksAndLight", 1, [&]() {
+        compressibleChunk.uncompressBlocksAndLight();
+    }, [&]() {
+        compressibleChunk.compressBlocksAndLight();
+    });
+
+    auto packet = std::make_unique<ChunkPacket>(0, PacketType::ChunkSent, 0);
+    runner.run("compression/compressChunk", 1, nullptr, [&]() {
+        Compression::compressChunk(*packet, compressibleChunk);
+        doNotOptimise(*packet);
+    });
+
+    Chunk decompressedChunk(ACCESS_CHUNK_POSITION);
+    runner.run("compression/decompressChunk", 1, [&]() {
+        decompressedChunk.unload();
+        decompressedChunk = { ACCESS_CHUNK_POSITION };
+    }, [&]() {
+        Compression::decompressChunk(*packet, decompressedChunk);
+    });
+    decompressedChunk.unload();
+
+    for (auto& [chunkPosition, chunk] : chunks)
+        chunk.unload();
+    chunks.clear();
+}
+
+static void benchmarkTerrainGen(BenchmarkRunner& runner)
+{
+    constexpr int NUM_CHUNKS = 4 * (MAX_CHUNK_Y - MIN_CHUNK_Y + 1);
+    std::vector<Chunk> chunks;
+    for (uint64_t seed : SEEDS)
+    {
+        std::string name = "terrainGen/generateTerrain/seed" + std::to_string(seed);
+        if (!runner.shouldRun(name))
+            continue;
+
+        seedWorld(seed);
+        runner.run(name, NUM_CHUNKS, [&]() {
+            for (Chunk& chunk : chunks)
+                chunk.unload();
+            chunks.clear();
+            for (int x = 0; x < 2; x++)
+            {
+                for (int y = MIN_CHUNK_Y; y <= MAX_CHUNK_Y; y++)
+                {
+                    for (int z = 0; z < 2; z++)
+                        chunks.emplace_back(IVec3(x, y, z));
+                }
+            }
+        }, [&]() {
+            for (Chunk& chunk : chunks)
+                TerrainGen().generateTerrain(chunk, seed);
+        });
+    }
+    for (Chunk& chunk : chunks)
+        chunk.unload();
+}
+
+static void benchmarkLightingAndMeshing(BenchmarkRunner& runner, ServerWorld<true>& world)
+{
+    constexpr int NUM_CHUNKS = MAX_CHUNK_Y - MIN_CHUNK_Y + 1;
+    std::unordered_map<IVec3, Chunk>& chunks = world.chunkManager.getWorldChunks();
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<float> waterVertices;
+    std::vector<uint32_t> waterIndices;
+    for (uint64_t seed : SEEDS)
+    {
+        std::string lightingName = "lighting/propagateSkyLight/seed" + std::to_string(seed);
+        std::string meshingName = "meshing/buildMesh/seed" + std::to_string(seed);
+        if (!runner.shouldRun(lightingName) && !runner.shouldRun(meshingName))
+            continue;
+
+        generateRegion(chunks, seed);
+        runner.run(lightingName, NUM_CHUNKS, nullptr, [&]() {
+            lightColumn(chunks, world.getResourcePack());
+        });
+        lightColumn(chunks, world.getResourcePack());
+
+        runner.run(meshingName, NUM_CHUNKS, nullptr, [&]() {
+            std::shared_lock<std::shared_mutex> lock(world.chunkManager.mutex);
+            for (int y = MIN_CHUNK_Y; y <= MAX_CHUNK_Y; y++)
+            {
+                client::MeshBuilder(
+                    chunks.at(IVec3(0, y, 0)), world, vertices, indices, waterVertices,
+                    waterIndices
+                ).buildMesh();
+                doNotOptimise(vertices.data());
+            }
+        });
+
+        for (auto& [chunkPosition, chunk] : chunks)
+            chunk.unload();
+        chunks.clear();
+    }
+}
+
+static void benchmarkPhysicsIntegration(BenchmarkRunner& runner)
+{
+    ECS ecs(NUM_PHYSICS_ENTITIES);
+    PhysicsBodies bodies;
+    for (int i = 0; i < NUM_PHYSICS_ENTITIES; i++)
+    {
+        EntityId entity = ecs.newEntity();
+        const TransformComponent& transform = ecs.assign<TransformComponent>(
+            entity, IVec3(i, 0, 0), Vec3(0.5f, 0.5f, 0.5f), 0.25f, Vec3(0.0f, 0.0f, 0.0f)
+        );
+        const PhysicsComponent& physics = ecs.assign<PhysicsComponent>(
+            entity, Vec3(1.0f, 2.0f, 3.0f), Vec3(0.0f, -0.5f, 0.0f)
+        );
+        bodies.add(entity, physics, transform);
+    }
+
+    runner.run("physics/integrate", NUM_PHYSICS_ENTITIES, nullptr, [&]() {
+        bodies.integrate(0.05f);
+    });
+    runner.run("physics/storePreviousTransforms", NUM_PHYSICS_ENTITIES, nullptr, [&]() {
+        bodies.storePreviousTransforms();
+    });
+}
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    double minTime = 1.0;
+    std::string outputPath;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if (i + 1 >= argc || argument == "--help")
+        {
+            printUsage();
+            return argument == "--help" ? 0 : 1;
+        }
+        std::string value = argv[++i];
+        if (argument == "--filter")
+            filter = value;
+        else if (argument == "--min-time")
+            minTime = std::atof(value.c_str());
+        else if (argument == "--output")
+            outputPath = value;
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    BenchmarkRunner runner(filter, minTime);
+    std::mutex networkingMtx;
+    // Loads the resource pack from res/ in the working directory
+    ServerWorld<true> world(SEEDS[0], networkingMtx);
+    benchmarkChunkAccess(runner, world);
+    benchmarkTerrainGen(runner);
+    benchmarkLightingAndMeshing(runner, world);
+    benchmarkPhysicsIntegration(runner);
+
+    if (outputPath.empty())
+    {
+        runner.writeJson(std::cout);
+        return 0;
+    }
+    std::ofstream file(outputPath);
+    runner.writeJson(file);
+    if (!file)
+    {
+        std::cerr << "Failed to write " << outputPath << "\n";
+        return 1;
+    }
+    return 0;
+}
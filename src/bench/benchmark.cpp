@@ -0,0 +1,100 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "bench/benchmark.h"
+
+#include "core/pch.h"
+
+#include <iomanip>
+
+namespace lonelycube::bench {
+
+// Enough runs for the median to be stable, even for slow benchmarks
+static constexpr uint64_t MIN_ITERATIONS = 10;
+
+BenchmarkRunner::BenchmarkRunner(const std::string& filter, double minTime)
+    : m_filter(filter), m_minTime(minTime) {}
+
+void BenchmarkRunner::run(
+    const std::string& name, uint64_t itemsPerIteration, const std::function<void()>& setup,
+    const std::function<void()>& function
+) {
+    if (!shouldRun(name))
+        return;
+
+    // Warm up the caches and branch predictors
+    if (setup)
+        setup();
+    function();
+
+    std::vector<double> times;
+    double totalTime = 0.0;
+    while (times.size() < MIN_ITERATIONS || totalTime < m_minTime * 1e9)
+    {
+        if (setup)
+            setup();
+        auto start = std::chrono::steady_clock::now();
+        function();
+        auto end = std::chrono::steady_clock::now();
+        double time = std::chrono::duration<double, std::nano>(end - start).count();
+        times.push_back(time);
+        totalTime += time;
+    }
+
+    std::sort(times.begin(), times.end());
+    m_results.push_back({
+        name, times.size(), itemsPerIteration, times.front(), times[times.size() / 2],
+        totalTime / times.size()
+    });
+    std::cerr << std::fixed << std::setprecision(1) << name << ": "
+        << m_results.back().medianNanoseconds / itemsPerIteration << " ns per item\n";
+}
+
+void BenchmarkRunner::writeJson(std::ostream& stream) const
+{
+    stream << std::fixed << std::setprecision(3) << "{\n"
+        << "  \"context\": {\n"
+        << "    \"timestamp\": " << std::time(nullptr) << ",\n"
+        << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef RELEASE
+        << "    \"build_type\": \"release\"\n"
+#else
+        << "    \"build_type\": \"debug\"\n"
+#endif
+        << "  },\n"
+        << "  \"benchmarks\": [";
+    for (size_t resultNum = 0; resultNum < m_results.size(); resultNum++)
+    {
+        const BenchmarkResult& result = m_results[resultNum];
+        // The names are chosen by the benchmarks and never need escaping
+        stream << (resultNum == 0 ? "\n" : ",\n")
+            << "    {\n"
+            << "      \"name\": \"" << result.name << "\",\n"
+            << "      \"iterations\": " << result.iterations << ",\n"
+            << "      \"items_per_iteration\": " << result.itemsPerIteration << ",\n"
+            << "      \"min_ns\": " << result.minNanoseconds << ",\n"
+            << "      \"median_ns\": " << result.medianNanoseconds << ",\n"
+            << "      \"mean_ns\": " << result.meanNanoseconds << ",\n"
+            << "      \"median_ns_per_item\": "
+            << result.medianNanoseconds / result.itemsPerIteration << "\n"
+            << "    }";
+    }
+    stream << "\n  ]\n}\n";
+}
+
+}  // namespace lonelycube::bench
@@ -0,0 +1,69 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+namespace lonelycube::bench {
+
+// Stops the compiler from optimising away the calculation of value
+template<typename T>
+inline void doNotOptimise(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct BenchmarkResult
+{
+    std::string name;
+    uint64_t iterations;
+    uint64_t itemsPerIteration;
+    double minNanoseconds;
+    double medianNanoseconds;
+    double meanNanoseconds;
+};
+
+// Times functions by running them repeatedly for a minimum amount of time, and reports the
+// results as JSON so that they can be compared against a baseline
+class BenchmarkRunner
+{
+private:
+    std::string m_filter;
+    double m_minTime;  // seconds
+    std::vector<BenchmarkResult> m_results;
+
+public:
+    BenchmarkRunner(const std::string& filter, double minTime);
+    // Runs function until at least the minimum time has been spent in it, calling setup, which
+    // isn't timed, before each run. Benchmarks whose names don't contain the filter are skipped.
+    // itemsPerIteration is the number of items, such as blocks or chunks, that each call of
+    // function processes.
+    void run(
+        const std::string& name, uint64_t itemsPerIteration, const std::function<void()>& setup,
+        const std::function<void()>& function
+    );
+    void writeJson(std::ostream& stream) const;
+
+    inline bool shouldRun(const std::string& name) const
+    {
+        return name.find(m_filter) != std::string::npos;
+    }
+};
+
+}  // namespace lonelycube::bench
@@ -0,0 +1,270 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/pch.h"
+
+#include <iomanip>
+
+#include "core/chunk.h"
+#include "core/lighting.h"
+#include "core/random.h"
+#include "core/resourcePack.h"
+#include "core/terrainGen.h"
+#include "core/workerPool.h"
+
+using namespace lonelycube;
+
+// Checks that terrain generation and sky lighting still produce exactly the same worlds, by
+// hashing a fixed grid of chunks for several seeds and comparing the hashes with the ones that
+// were recorded when the world generation last changed on purpose. Also measures how the speed
+// of generation scales with the number of threads.
+
+static constexpr int BLOCKS_PER_CHUNK = constants::CHUNK_SIZE * constants::CHUNK_SIZE
+    * constants::CHUNK_SIZE;
+// The chunks that are lit. A border of chunks around them is generated as well, so that every
+// lit chunk has all of its neighbours.
+static constexpr int GRID_RADIUS = 2;
+static constexpr int MIN_CHUNK_Y = -2;
+static constexpr int MAX_CHUNK_Y = 3;
+
+struct GoldenHashes
+{
+    uint64_t seed;
+    uint64_t blockHash;
+    uint64_t lightHash;
+};
+
+// Update these with the output of --print-hashes when a change to the world generation is
+// intended
+static constexpr std::array<GoldenHashes, 3> GOLDEN_HASHES = {{
+    { 1, 0x0c2d67700fe53c65, 0xe0a858058b6c1bc7 },
+    { 42, 0xdebaa79cc5f428f4, 0xa41650cf41559baf },
+    { 1234567, 0xc9499c8861f7d9ca, 0xf53d0b0c69e56cb1 },
+}};
+
+static void printUsage()
+{
+    std::cout << "Usage: worldgencheck [options]\n"
+        << "  --threads <n>     Maximum number of threads to generate with (default: all)\n"
+        << "  --print-hashes    Print the hashes in the form used for the golden values\n";
+}
+
+static uint64_t hashBytes(uint64_t hash, uint32_t value, int numBytes)
+{
+    // FNV-1a
+    for (int byte = 0; byte < numBytes; byte++)
+    {
+        hash ^= (value >> (byte * 8)) & 0xff;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+class WorldGenRun
+{
+private:
+    std::unordered_map<IVec3, Chunk> m_chunks;
+    std::vector<IVec3> m_chunkPositions;  // In a fixed order, so that hashes are repeatable
+
+public:
+    WorldGenRun()
+    {
+        for (int x = -GRID_RADIUS - 1; x <= GRID_RADIUS + 1; x++)
+        {
+            for (int y = MIN_CHUNK_Y - 1; y <= MAX_CHUNK_Y + 1; y++)
+            {
+                for (int z = -GRID_RADIUS - 1; z <= GRID_RADIUS + 1; z++)
+                {
+                    IVec3 chunkPosition(x, y, z);
+                    m_chunkPositions.push_back(chunkPosition);
+                    m_chunks[chunkPosition] = { chunkPosition };
+                }
+            }
+        }
+    }
+
+    ~WorldGenRun()
+    {
+        for (auto& [chunkPosition, chunk] : m_chunks)
+            chunk.unload();
+    }
+
+    size_t getNumChunks() const
+    {
+        return m_chunkPositions.size();
+    }
+
+    // The noise must have been seeded for the seed already
+    void generate(uint64_t seed, WorkerPool& workerPool)
+    {
+        workerPool.parallelFor(m_chunkPositions.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t chunkNum = begin; chunkNum < end; chunkNum++)
+            {
+                Chunk& chunk = m_chunks.at(m_chunkPositions[chunkNum]);
+                TerrainGen().generateTerrain(chunk, seed);
+                chunk.setSkyLightBeingRelit(false);
+                chunk.setBlockLightBeingRelit(false);
+            }
+        });
+    }
+
+    // Lights each column from the top down, in a fixed order
+    void light(const ResourcePack& resourcePack)
+    {
+        bool neighbouringChunksToRelight[6];
+        bool chunksToRemesh[7];
+        for (int x = -GRID_RADIUS; x <= GRID_RADIUS; x++)
+        {
+            for (int z = -GRID_RADIUS; z <= GRID_RADIUS; z++)
+            {
+                for (int y = MAX_CHUNK_Y; y >= MIN_CHUNK_Y; y--)
+                {
+                    IVec3 chunkPosition(x, y, z);
+                    m_chunks.at(chunkPosition).clearSkyLight();
+                    Lighting::propagateSkyLight(
+                        chunkPosition, m_chunks, neighbouringChunksToRelight, chunksToRemesh,
+                        resourcePack
+                    );
+                }
+            }
+        }
+    }
+
+    uint64_t hashBlocks() const
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (const IVec3& chunkPosition : m_chunkPositions)
+        {
+            const Chunk& chunk = m_chunks.at(chunkPosition);
+            for (uint32_t blockNum = 0; blockNum < BLOCKS_PER_CHUNK; blockNum++)
+                hash = hashBytes(hash, chunk.getBlock(blockNum), 1);
+        }
+        return hash;
+    }
+
+    uint64_t hashLight() const
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (const IVec3& chunkPosition : m_chunkPositions)
+        {
+            const Chunk& chunk = m_chunks.at(chunkPosition);
+            for (uint32_t blockNum = 0; blockNum < BLOCKS_PER_CHUNK; blockNum++)
+            {
+                hash = hashBytes(
+                    hash, chunk.getSkyLight(blockNum) | chunk.getBlockLight(blockNum) << 8, 2
+                );
+            }
+        }
+        return hash;
+    }
+};
+
+// Returns the number of chunks generated per second
+static double measureThroughput(uint64_t seed, int numThreads)
+{
+    WorkerPool workerPool(numThreads);
+    WorldGenRun run;
+    auto start = std::chrono::steady_clock::now();
+    run.generate(seed, workerPool);
+    double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return run.getNumChunks() / time;
+}
+
+int main(int argc, char** argv)
+{
+    int maxNumThreads = std::max(1u, std::thread::hardware_concurrency());
+    bool printHashes = false;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if (argument == "--print-hashes")
+        {
+            printHashes = true;
+        }
+        else if (argument == "--threads" && i + 1 < argc)
+        {
+            maxNumThreads = std::max(1, std::atoi(argv[++i]));
+        }
+        else
+        {
+            printUsage();
+            return argument == "--help" ? 0 : 1;
+        }
+    }
+
+    // Loads the resource pack from res/ in the working directory
+    ResourcePack resourcePack("res/resourcePack");
+    bool hashesMatch = true;
+    std::cout << std::hex << std::setfill('0');
+    for (const GoldenHashes& golden : GOLDEN_HASHES)
+    {
+        PCG_SeedRandom32(golden.seed);
+        seedNoise();
+
+        WorkerPool workerPool(maxNumThreads);
+        WorldGenRun run;
+        run.generate(golden.seed, workerPool);
+        uint64_t blockHash = run.hashBlocks();
+        run.light(resourcePack);
+        uint64_t lightHash = run.hashLight();
+
+        if (printHashes)
+        {
+            std::cout << "    { " << std::dec << golden.seed << std::hex << ", 0x"
+                << std::setw(16) << blockHash << ", 0x" << std::setw(16) << lightHash << " },\n";
+            continue;
+        }
+        std::cout << "Seed " << std::dec << golden.seed << std::hex << ": blocks "
+            << std::setw(16) << blockHash << (blockHash == golden.blockHash ? " ok" : " CHANGED")
+            << ", light " << std::setw(16) << lightHash
+            << (lightHash == golden.lightHash ? " ok" : " CHANGED") << "\n";
+        hashesMatch &= blockHash == golden.blockHash && lightHash == golden.lightHash;
+    }
+    if (printHashes)
+        return 0;
+
+    // The hashes above were already checked with every thread, so only the speed is measured
+    std::vector<int> threadCounts;
+    for (int numThreads = 1; numThreads < maxNumThreads; numThreads *= 2)
+        threadCounts.push_back(numThreads);
+    threadCounts.push_back(maxNumThreads);
+    std::cout << std::dec << std::fixed << std::setprecision(1) << std::setfill(' ');
+    double singleThreadThroughput = 0.0;
+    for (int numThreads : threadCounts)
+    {
+        double throughput = 0.0;
+        for (const GoldenHashes& golden : GOLDEN_HASHES)
+        {
+            PCG_SeedRandom32(golden.seed);
+            seedNoise();
+            throughput += measureThroughput(golden.seed, numThreads) / GOLDEN_HASHES.size();
+        }
+        if (numThreads == 1)
+            singleThreadThroughput = throughput;
+        std::cout << std::setw(3) << numThreads << " threads: " << throughput << " chunks/s, "
+            << 100.0 * throughput / (singleThreadThroughput * numThreads) << "% efficiency\n";
+    }
+
+    if (!hashesMatch)
+    {
+        std::cout << "The generated world has changed. If this was intended, update "
+            << "GOLDEN_HASHES with the output of --print-hashes.\n";
+        return 1;
+    }
+    return 0;
+}
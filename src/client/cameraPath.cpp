@@ -0,0 +1,135 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "client/cameraPath.h"
+
+#include "core/pch.h"
+
+#include <iomanip>
+
+namespace lonelycube::client {
+
+CameraPath::CameraPath(uint64_t seed, int renderDistance)
+    : m_seed(seed), m_renderDistance(renderDistance) {}
+
+bool CameraPath::load(const std::filesystem::path& path)
+{
+    std::ifstream stream(path);
+    if (!stream)
+        return false;
+
+    m_keyframes.clear();
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        std::istringstream lineStream(line);
+        std::string field;
+        if (!(lineStream >> field) || field[0] == '#')
+            continue;
+
+        if (field == "seed")
+        {
+            lineStream >> m_seed;
+        }
+        else if (field == "renderDistance")
+        {
+            lineStream >> m_renderDistance;
+        }
+        else
+        {
+            CameraKeyframe keyframe;
+            lineStream.clear();
+            lineStream.seekg(0);
+            if (!(lineStream >> keyframe.time >> keyframe.position[0] >> keyframe.position[1]
+                >> keyframe.position[2] >> keyframe.yaw >> keyframe.pitch))
+            {
+                return false;
+            }
+            if (!m_keyframes.empty() && keyframe.time <= m_keyframes.back().time)
+                return false;
+            m_keyframes.push_back(keyframe);
+        }
+    }
+
+    return !m_keyframes.empty();
+}
+
+bool CameraPath::save(const std::filesystem::path& path) const
+{
+    std::ofstream stream(path);
+    if (!stream)
+        return false;
+
+    stream << "seed " << m_seed << "\n";
+    if (m_renderDistance > 0)
+        stream << "renderDistance " << m_renderDistance << "\n";
+    stream << "# time x y z yaw pitch\n" << std::fixed << std::setprecision(3);
+    for (const CameraKeyframe& keyframe : m_keyframes)
+    {
+        stream << keyframe.time << " " << keyframe.position[0] << " " << keyframe.position[1]
+            << " " << keyframe.position[2] << " " << keyframe.yaw << " " << keyframe.pitch
+            << "\n";
+    }
+
+    return static_cast<bool>(stream);
+}
+
+void CameraPath::addKeyframe(const CameraKeyframe& keyframe)
+{
+    m_keyframes.push_back(keyframe);
+}
+
+static double catmullRom(double p0, double p1, double p2, double p3, double t)
+{
+    return 0.5 * (2.0 * p1 + (p2 - p0) * t + (2.0 * p0 - 5.0 * p1 + 4.0 * p2 - p3) * t * t
+        + (3.0 * p1 - p0 - 3.0 * p2 + p3) * t * t * t);
+}
+
+CameraKeyframe CameraPath::sample(double time) const
+{
+    assert(!m_keyframes.empty());
+    if (time <= m_keyframes.front().time)
+        return m_keyframes.front();
+    if (time >= m_keyframes.back().time)
+        return m_keyframes.back();
+
+    size_t next = std::upper_bound(
+        m_keyframes.begin(), m_keyframes.end(), time,
+        [](double time, const CameraKeyframe& keyframe) { return time < keyframe.time; }
+    ) - m_keyframes.begin();
+    // The end keyframes are repeated to give the first and last segments their outer points
+    const CameraKeyframe& k0 = m_keyframes[next >= 2 ? next - 2 : 0];
+    const CameraKeyframe& k1 = m_keyframes[next - 1];
+    const CameraKeyframe& k2 = m_keyframes[next];
+    const CameraKeyframe& k3 = m_keyframes[std::min(next + 1, m_keyframes.size() - 1)];
+    double t = (time - k1.time) / (k2.time - k1.time);
+
+    CameraKeyframe keyframe;
+    keyframe.time = time;
+    for (int i = 0; i < 3; i++)
+    {
+        keyframe.position[i] = catmullRom(
+            k0.position[i], k1.position[i], k2.position[i], k3.position[i], t
+        );
+    }
+    keyframe.yaw = catmullRom(k0.yaw, k1.yaw, k2.yaw, k3.yaw, t);
+    keyframe.pitch = catmullRom(k0.pitch, k1.pitch, k2.pitch, k3.pitch, t);
+    return keyframe;
+}
+
+}  // namespace lonelycube::client
@@ -0,0 +1,72 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+namespace lonelycube::client {
+
+struct CameraKeyframe
+{
+    double time;  // seconds from the start of the path
+    double position[3];
+    float yaw;
+    float pitch;
+};
+
+// A camera flight through a world, recorded in game with F7 and replayed by the flythrough
+// benchmark. The file starts with the seed and render distance of the world it was recorded
+// in, followed by one "time x y z yaw pitch" line per keyframe.
+class CameraPath
+{
+private:
+    uint64_t m_seed;
+    int m_renderDistance;
+    std::vector<CameraKeyframe> m_keyframes;
+
+public:
+    CameraPath(uint64_t seed = 0, int renderDistance = 0);
+    bool load(const std::filesystem::path& path);
+    bool save(const std::filesystem::path& path) const;
+    // Keyframes must be added in time order
+    void addKeyframe(const CameraKeyframe& keyframe);
+    // Interpolates between the keyframes with a Catmull-Rom spline, so that the camera moves
+    // smoothly through each of them. Times outside of the path give its first or last keyframe.
+    CameraKeyframe sample(double time) const;
+
+    inline uint64_t getSeed() const
+    {
+        return m_seed;
+    }
+    // 0 if the path doesn't specify one
+    inline int getRenderDistance() const
+    {
+        return m_renderDistance;
+    }
+    inline size_t getNumKeyframes() const
+    {
+        return m_keyframes.size();
+    }
+    inline double getDuration() const
+    {
+        return m_keyframes.empty() ? 0.0 : m_keyframes.back().time;
+    }
+};
+
+}  // namespace lonelycube::client
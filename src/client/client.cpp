@@ -18,9 +18,48 @@
 
 #include "client/renderThread.h"
 
+#include "core/pch.h"
+
+#include "client/flythroughBenchmark.h"
+#include "core/config.h"
+
+using namespace lonelycube;
 using namespace lonelycube::client;
 
+static void printUsage()
+{
+    std::cout << "Usage: client [options]\n"
+        << "  --flythrough <path>         Run the flythrough benchmark along a camera path\n"
+        << "  --flythrough-output <path>  Where to write the benchmark's frame times CSV\n";
+}
+
 int main(int argc, char* argv[]) {
+    // The flythrough benchmark can be started with a camera path from the command line or
+    // settings.txt
+    std::string flythroughPath = Config("res/settings.txt").getFlythroughPath();
+    std::string flythroughOutput = "flythrough_" + std::to_string(std::time(nullptr)) + ".csv";
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if (i + 1 >= argc || argument == "--help")
+        {
+            printUsage();
+            return argument == "--help" ? 0 : 1;
+        }
+        std::string value = argv[++i];
+        if (argument == "--flythrough")
+            flythroughPath = value;
+        else if (argument == "--flythrough-output")
+            flythroughOutput = value;
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+    if (!flythroughPath.empty())
+        return runFlythroughBenchmark(flythroughPath, flythroughOutput);
+
     renderThread();
 
     return 0;
@@ -20,6 +20,7 @@
 
 #include "core/log.h"
 #include "core/packet.h"
+#include "core/profiler.h"
 #include <cstring>
 #include <string>
 
@@ -95,6 +96,7 @@ void ClientNetworking::disconnect(ClientWorld& mainWorld)
 }
 
 void ClientNetworking::receivePacket(ENetPacket* packet, ClientWorld& mainWorld) {
+    PROFILE_ZONE("Receive packet");
     Packet<int, 0> head;
     memcpy(&head, packet->data, head.getSize());
     switch (head.getPacketType())
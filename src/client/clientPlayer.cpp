@@ -21,7 +21,9 @@
 
 #include "client/clientPlayer.h"
 #include "core/constants.h"
+#include "core/hitboxCollision.h"
 #include "core/packet.h"
+#include "core/worldCursor.h"
 
 namespace lonelycube::client {
 
@@ -38,13 +40,6 @@ const float ClientPlayer::m_hitBoxCorners[36] = { 0.0f, 0.0f, 0.0f,
                                             0.6f, 1.8f, 0.6f,
                                             0.0f, 1.8f, 0.6f };
 
-const int ClientPlayer::m_directions[18] = { 1, 0, 0,
-                                      -1, 0, 0,
-                                       0, 1, 0,
-                                       0,-1, 0,
-                                       0, 0, 1,
-                                       0, 0,-1 };
-
 ClientPlayer::ClientPlayer(
     const IVec3& playerPos, ClientWorld* mainWorld, ResourcePack& resourcePack
 ) : m_mainWorld(mainWorld), m_resourcePack(resourcePack)
@@ -208,7 +203,7 @@ void ClientPlayer::processUserInput(
                     viewCamera.position, cameraBlockPosition, viewCamera.front, breakBlockCoords,
                     placeBlockCoords) != 0)
                 {
-                    if ((!intersectingBlock(placeBlockCoords)) || (!m_resourcePack.getBlockData(m_blockHolding).collidable))
+                    if ((!intersectingBlock(placeBlockCoords)) || (!m_resourcePack.isCollidable(m_blockHolding)))
                     {
                         //TODO:
                         //(investigate) fix the replace block function to scan the unmeshed chunks too
@@ -390,6 +385,24 @@ void ClientPlayer::processUserInput(
     m_lastPlaying = m_playing;
 }
 
+void ClientPlayer::setCameraPose(const double* position, float yaw, float pitch)
+{
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        cameraBlockPosition[i] = std::floor(position[i]);
+        viewCamera.position[i] = position[i] - cameraBlockPosition[i];
+        // Keep the hitbox in the same place relative to the camera as when walking around
+        m_hitboxMinBlock[i] = cameraBlockPosition[i];
+        m_hitboxMinOffset[i] = viewCamera.position[i] - 0.3f;
+    }
+    m_hitboxMinOffset[1] -= 1.32f;
+
+    m_yaw = yaw;
+    m_pitch = std::clamp(pitch, -89.999f, 89.999f);
+    viewCamera.updateRotationVectors(m_yaw, m_pitch);
+    m_mainWorld->updateViewCamera(viewCamera);
+}
+
 void ClientPlayer::unfocus(GLFWwindow* window, int* windowDimensions)
 {
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
@@ -416,80 +429,34 @@ void ClientPlayer::focus(GLFWwindow* window, int* windowDimensions)
 }
 
 void ClientPlayer::resolveHitboxCollisions(float DT) {
-    m_touchGround = false;
-    bool lastTouchWater = m_touchWater;
-    m_touchWater = false;
-    float penetration;
-    float minPenetration;
-    uint8_t axisOfLeastPenetration = 2;
-    int position[3];
-    int neighbouringBlockPosition[3];
-
-    //TODO: investigate the effect of changing subdivisions (causes bugs)
-    float subdivisions = 32;
-
-    for (uint8_t subdivision = 0; subdivision < subdivisions; subdivision++) {
-        m_hitboxMinOffset += m_velocity * DT / subdivisions;
-
-        for (uint8_t i = 0; i < 3; i++) {
-            m_hitboxMinBlock[i] += floor(m_hitboxMinOffset[i]);
-            m_hitboxMinOffset[i] -= floor(m_hitboxMinOffset[i]);
-        }
-
-        bool resolved = false;
-        while (!resolved) {
-            axisOfLeastPenetration = 2;
-            resolved = true;
-            minPenetration = 1000.0f;
-            for (uint8_t hitboxCorner = 0; hitboxCorner < 12; hitboxCorner++) {
-                for (uint8_t i = 0; i < 3; i++) {
-                    position[i] = m_hitboxMinBlock[i] + floor(m_hitboxMinOffset[i] + m_hitBoxCorners[hitboxCorner * 3 + i]);
-                }
-
-                int16_t blockType = m_mainWorld->integratedServer.chunkManager.getBlock(position);
-                if (m_resourcePack.getBlockData(blockType).collidable) {
-                    for (uint8_t direction = 0; direction < 6; direction++) {
-                        penetration = m_hitboxMinOffset[direction / 2] + m_hitBoxCorners[hitboxCorner * 3 + direction / 2] - floor(m_hitboxMinOffset[direction / 2] + m_hitBoxCorners[hitboxCorner * 3 + direction / 2]);
-                        if (direction % 2 == 0) {
-                            penetration = 1.0f - penetration;
-                        }
-                        if (penetration < minPenetration) {
-                            for (uint8_t i = 0; i < 3; i++) {
-                                neighbouringBlockPosition[i] = position[i] + m_directions[direction * 3 + i];
-                            }
-                            blockType = m_mainWorld->integratedServer.chunkManager.getBlock(neighbouringBlockPosition);
-                            if ((!m_resourcePack.getBlockData(blockType).collidable) && (m_velocity[direction / 2] != 0.0f)) {
-                                minPenetration = penetration;
-                                axisOfLeastPenetration = direction;
-                                resolved = false;
-                            }
-                        }
-                    }
-                }
-                else {
-                    if (blockType == 4) {
-                        if (lastTouchWater) {
-                            m_touchWater = true;
-                        }
-                        else {
-                            if (hitboxCorner > 3) {
-                                m_touchWater = true;
-                            }
-                        }
-                    }
-                }
-            }
-
-            if (!resolved) {
-                m_hitboxMinOffset -= m_velocity * DT / subdivisions;
-                m_velocity[axisOfLeastPenetration / 2] = 0.0f;
-                m_hitboxMinOffset += m_velocity * DT / subdivisions;
-                if (axisOfLeastPenetration == 2) {
-                    m_touchGround = true;
-                }
-            }
-        }
+    // The blocks around the player are nearly always in the same few chunks, so read them
+    // through a cursor that remembers them rather than looking each one up in the hash map
+    ChunkManager& chunkManager = m_mainWorld->integratedServer.chunkManager;
+    std::shared_lock<std::shared_mutex> lock(chunkManager.mutex);
+    WorldCursor cursor(chunkManager);
+    auto getBlock = [&](const IVec3& position) {
+        return cursor.getBlock(position);
+    };
+    auto isCollidable = [&](uint8_t blockType) {
+        return m_resourcePack.isCollidable(blockType);
+    };
+
+    IVec3 minBlock(m_hitboxMinBlock);
+    Vec3 minOffset(m_hitboxMinOffset.x, m_hitboxMinOffset.y, m_hitboxMinOffset.z);
+    Vec3 velocity(m_velocity.x, m_velocity.y, m_velocity.z);
+    HitboxContacts contacts = moveHitbox(
+        minBlock, minOffset, Vec3(0.6f, 1.8f, 0.6f), velocity, DT, m_touchWater, 0.9f, getBlock,
+        isCollidable
+    );
+
+    for (int i = 0; i < 3; i++)
+    {
+        m_hitboxMinBlock[i] = minBlock[i];
+        m_hitboxMinOffset[i] = minOffset[i];
+        m_velocity[i] = velocity[i];
     }
+    m_touchGround = contacts.touchingGround;
+    m_touchWater = contacts.touchingWater;
 }
 
 bool ClientPlayer::collidingWithBlock() {
@@ -500,7 +467,7 @@ bool ClientPlayer::collidingWithBlock() {
         }
 
         int16_t blockType = m_mainWorld->integratedServer.chunkManager.getBlock(position);
-        if (m_resourcePack.getBlockData(blockType).collidable) {
+        if (m_resourcePack.isCollidable(blockType)) {
             return true;
         }
     }
@@ -31,7 +31,6 @@ namespace lonelycube::client {
 class ClientPlayer {
 private:
     static const float m_hitBoxCorners[36];
-    static const int m_directions[18];
 
     double m_time;
     double m_physicsTime;
@@ -89,6 +88,21 @@ public:
     );
     void unfocus(GLFWwindow* window, int* windowDimensions);
     void focus(GLFWwindow* window, int* windowDimensions);
+    // Moves the camera without any input or physics, for following a recorded camera path
+    void setCameraPose(const double* position, float yaw, float pitch);
+
+    inline float getYaw() const
+    {
+        return m_yaw;
+    }
+    inline float getPitch() const
+    {
+        return m_pitch;
+    }
+    inline void setPaused(bool paused)
+    {
+        m_paused = paused;
+    }
 
     inline bool gamePaused()
     {
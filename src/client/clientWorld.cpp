@@ -24,10 +24,13 @@
 
 #include "client/graphics/camera.h"
 #include "client/graphics/meshBuilder.h"
+#include "core/chunkPipelineStats.h"
 #include "core/constants.h"
 #include "core/lighting.h"
 #include "core/log.h"
+#include "core/profiler.h"
 #include "core/random.h"
+#include "core/raycast.h"
 #include "core/serverWorld.h"
 #include "core/utils/iVec3.h"
 #include "glm/ext/matrix_transform.hpp"
@@ -64,6 +67,7 @@ ClientWorld::ClientWorld(
     m_chunkWaterVertices.resize(m_numChunkLoadingThreads);
     m_chunkWaterIndices.resize(m_numChunkLoadingThreads);
     m_chunkPosition.resize(m_numChunkLoadingThreads);
+    m_chunkMeshReadyTime.resize(m_numChunkLoadingThreads);
     m_chunkMeshReady.resize(m_numChunkLoadingThreads);
     m_chunkMeshReadyMtx = std::make_unique<std::mutex[]>(m_numChunkLoadingThreads);
     m_chunkMeshReadyCV = std::make_unique<std::condition_variable[]>(m_numChunkLoadingThreads);
@@ -71,11 +75,17 @@ ClientWorld::ClientWorld(
     m_unmeshNeeded = false;
     m_readyForChunkUnload = false;
 
-    m_entityMeshes.reserve(VulkanEngine::MAX_FRAMES_IN_FLIGHT);
+    std::vector<float> entityModelVertices;
+    std::vector<uint32_t> entityModelIndices;
+    m_entityMeshManager.buildModelMeshes(entityModelVertices, entityModelIndices);
+    m_entityModelMesh = m_renderer.getVulkanEngine().uploadMesh(
+        entityModelVertices, entityModelIndices
+    );
+    m_entityInstanceBuffers.reserve(VulkanEngine::MAX_FRAMES_IN_FLIGHT);
     for (int i = 0; i < VulkanEngine::MAX_FRAMES_IN_FLIGHT; i++)
     {
-        m_entityMeshes.push_back(m_renderer.getVulkanEngine().allocateDynamicMesh(
-            1680000 * sizeof(float), 360000 * sizeof(uint32_t)
+        m_entityInstanceBuffers.push_back(m_renderer.getVulkanEngine().allocateDynamicBuffer(
+            EntityMeshManager::MAX_INSTANCES * sizeof(EntityInstance)
         ));
     }
 
@@ -114,6 +124,7 @@ void ClientWorld::renderWorld(
     const glm::mat4& viewProj, const int* playerBlockPos, const glm::vec3& playerSubBlockPos,
     float aspectRatio, float fov, float skyLightIntensity, double DT
 ) {
+    PROFILE_ZONE("Render world");
     unloadMeshes();
 
     Frustum viewFrustum = m_viewCamera.createViewFrustum(aspectRatio, fov, 0, 20);
@@ -132,7 +143,7 @@ void ClientWorld::renderWorld(
 
     if (m_meshUpdates.size() > 0)
     {
-        // auto tp1 = std::chrono::high_resolution_clock::now();
+        PROFILE_ZONE("Wait for chunks to remesh");
         while (m_meshUpdates.size() > 0)
         {
             m_meshUpdatesMtx.lock();
@@ -146,11 +157,11 @@ void ClientWorld::renderWorld(
             m_meshUpdatesMtx.unlock();
             doRenderThreadJobs();
         }
-        // auto tp2 = std::chrono::high_resolution_clock::now();
-        // LOG("waited " + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(tp2 - tp1).count()) + "us for chunks to remesh");
     }
 
     // Render Blocks
+    GpuProfiler& gpuProfiler = m_renderer.getGpuProfiler();
+    gpuProfiler.beginPass(GpuPass::Blocks);
     m_renderer.beginDrawingBlocks();
     int prevChunkDistance = -1;
     for (std::size_t i = 0; i < m_meshes.size(); i++) {
@@ -191,16 +202,19 @@ void ClientWorld::renderWorld(
     ) {
         m_meshes.pop_back();
     }
+    gpuProfiler.endPass(GpuPass::Blocks);
 
     // Render entities
-    GPUDynamicMeshBuffers& entityMesh = m_entityMeshes[
+    GPUDynamicBuffer& entityInstances = m_entityInstanceBuffers[
         m_renderer.getVulkanEngine().getFrameDataIndex()
     ];
-    m_renderer.blockRenderInfo.chunkCoordinates = glm::vec3(0.0f);
     m_renderer.blockRenderInfo.playerSubBlockPos = -playerSubBlockPos;
-    m_renderer.drawEntities(entityMesh);
+    gpuProfiler.beginPass(GpuPass::Entities);
+    m_renderer.drawEntities(m_entityMeshManager, m_entityModelMesh, entityInstances);
+    gpuProfiler.endPass(GpuPass::Entities);
 
     // Render water
+    gpuProfiler.beginPass(GpuPass::Water);
     m_renderer.beginDrawingWater();
     for (const auto& mesh : m_meshes) {
         if (mesh.waterMesh.indexCount > 0) {
@@ -215,6 +229,7 @@ void ClientWorld::renderWorld(
             doRenderThreadJobs();
         }
     }
+    gpuProfiler.endPass(GpuPass::Water);
 
     // LOG(std::to_string(m_meshes.size()) + ", " + std::to_string(m_meshArrayIndices.size()));
 
@@ -225,7 +240,12 @@ void ClientWorld::doRenderThreadJobs()
 {
     for (int threadNum = 0; threadNum < m_numChunkLoadingThreads; threadNum++) {
         if (m_chunkMeshReady[threadNum]) {
+            int64_t uploadStart = Profiler::now();
+            ChunkPipelineStats::record(
+                ChunkStage::UploadWait, m_chunkMeshReadyTime[threadNum], uploadStart
+            );
             uploadChunkMesh(threadNum);
+            ChunkPipelineStats::record(ChunkStage::Upload, uploadStart, Profiler::now());
             std::unique_lock<std::mutex> lock(m_chunkMeshReadyMtx[threadNum]);
             m_chunkMeshReady[threadNum] = false;
             lock.unlock();
@@ -284,7 +304,7 @@ void ClientWorld::unloadOutOfRangeMeshesIfNeeded()
     if (m_unmeshNeeded && !(m_readyForChunkUnload || m_unloadingChunks))
     {
         m_readyForChunkUnloadMtx.unlock();
-        auto tp1 = std::chrono::high_resolution_clock::now();
+        PROFILE_ZONE("Queue mesh unloads");
         unmeshChunks();
         std::unique_lock<std::mutex> lock(m_unmeshNeededMtx);
         m_unmeshNeeded = false;
@@ -292,13 +312,41 @@ void ClientWorld::unloadOutOfRangeMeshesIfNeeded()
         lock.unlock();
         m_unmeshNeededCV.notify_all();
         m_readyForChunkUnloadCV.notify_one();
-        auto tp2 = std::chrono::high_resolution_clock::now();
-        LOG("waited " + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(tp2 - tp1).count()) + "us for mesh unloads to be queued");
     }
     else
         m_readyForChunkUnloadMtx.unlock();
 }
 
+bool ClientWorld::chunksMeshedAround(const IVec3& centreChunkPosition, int radius)
+{
+    std::vector<IVec3> chunkPositions;
+    for (int x = -radius; x <= radius; x++)
+    {
+        for (int y = -radius; y <= radius; y++)
+        {
+            for (int z = -radius; z <= radius; z++)
+                chunkPositions.push_back(centreChunkPosition + IVec3(x, y, z));
+        }
+    }
+
+    // The two locks are taken one after the other to avoid imposing an order on them
+    {
+        std::shared_lock<std::shared_mutex> lock(integratedServer.chunkManager.mutex);
+        for (const IVec3& chunkPosition : chunkPositions)
+        {
+            if (!integratedServer.chunkManager.chunkLoaded(chunkPosition))
+                return false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(m_unmeshedChunksMtx);
+    for (const IVec3& chunkPosition : chunkPositions)
+    {
+        if (m_unmeshedChunks.contains(chunkPosition))
+            return false;
+    }
+    return true;
+}
+
 void ClientWorld::waitIfMeshesNeedUnloading(int threadNum)
 {
     while (m_unmeshNeeded && (m_meshUpdates.size() == 0))
@@ -472,11 +520,17 @@ void ClientWorld::addChunkMesh(const IVec3& chunkPosition, int threadNum) {
     int chunkCoords[3] = { chunkPosition.x, chunkPosition.y, chunkPosition.z };
 
     //generate the mesh
-    MeshBuilder(
-        integratedServer.chunkManager.getChunk(chunkPosition), integratedServer,
-        m_chunkVertices[threadNum], m_chunkIndices[threadNum], m_chunkWaterVertices[threadNum],
-        m_chunkWaterIndices[threadNum]
-    ).buildMesh();
+    int64_t meshStart = Profiler::now();
+    {
+        // Other chunk loader threads may be adding chunks to the map while this one meshes
+        std::shared_lock<std::shared_mutex> lock(integratedServer.chunkManager.mutex);
+        MeshBuilder(
+            integratedServer.chunkManager.getChunk(chunkPosition), integratedServer,
+            m_chunkVertices[threadNum], m_chunkIndices[threadNum],
+            m_chunkWaterVertices[threadNum], m_chunkWaterIndices[threadNum]
+        ).buildMesh();
+    }
+    ChunkPipelineStats::record(ChunkStage::Mesh, meshStart, Profiler::now());
 
     //if the mesh is empty dont upload it to save interrupting the render thread
     if ((m_chunkIndices[threadNum].size() == 0) && (m_chunkWaterIndices[threadNum].size() == 0))
@@ -499,6 +553,7 @@ void ClientWorld::addChunkMesh(const IVec3& chunkPosition, int threadNum) {
     //wait for the render thread to upload the mesh to the GPU
     m_chunkPosition[threadNum] = chunkPosition;
     std::unique_lock<std::mutex> lock(m_chunkMeshReadyMtx[threadNum]);
+    m_chunkMeshReadyTime[threadNum] = Profiler::now();
     m_chunkMeshReady[threadNum] = true;
 
     if (!m_meshArrayIndices.contains(chunkPosition))
@@ -516,6 +571,7 @@ void ClientWorld::addChunkMesh(const IVec3& chunkPosition, int threadNum) {
 }
 
 void ClientWorld::uploadChunkMesh(int threadNum) {
+    PROFILE_ZONE("Upload chunk mesh");
     MeshData newMesh;
     newMesh.chunkPosition = m_chunkPosition[threadNum];
 
@@ -578,6 +634,14 @@ bool ClientWorld::buildMeshesForNewChunksWithNeighbours(int threadNum)
                     m_unmeshedChunks.erase(chunkPosition);
                     m_unmeshedChunksMtx.unlock();
                     Chunk& chunk = integratedServer.chunkManager.getChunk(chunkPosition);
+                    // Only the first time a chunk is meshed counts towards its load latency
+                    int64_t loadedTime = chunk.getLoadedTime();
+                    if (loadedTime >= 0) {
+                        chunk.setLoadedTime(-1);
+                        ChunkPipelineStats::record(
+                            ChunkStage::NeighbourWait, loadedTime, Profiler::now()
+                        );
+                    }
                     if (!chunk.isSkyLightUpToDate()) {
                         Chunk::s_checkingNeighbourSkyRelightsMtx.lock();
                         bool neighbourBeingRelit = true;
@@ -597,14 +661,23 @@ bool ClientWorld::buildMeshesForNewChunksWithNeighbours(int threadNum)
                         chunk.clearSkyLight();
                         bool neighbouringChunksToRelight[6];
                         bool chunksToRemesh[7];
+                        int64_t lightingStart = Profiler::now();
                         Lighting::propagateSkyLight(
                             chunkPosition, integratedServer.chunkManager.getWorldChunks(),
                             neighbouringChunksToRelight, chunksToRemesh,
                             integratedServer.getResourcePack()
                         );
+                        ChunkPipelineStats::record(
+                            ChunkStage::Lighting, lightingStart, Profiler::now()
+                        );
                         chunk.setSkyLightToBeUpToDate();
                     }
                     addChunkMesh(chunkPosition, threadNum);
+                    if (loadedTime >= 0) {
+                        ChunkPipelineStats::record(
+                            ChunkStage::LoadedToDrawn, loadedTime, Profiler::now()
+                        );
+                    }
                     m_unmeshedChunksMtx.lock();
                     meshBuilt = true;
                 }
@@ -621,50 +694,38 @@ bool ClientWorld::buildMeshesForNewChunksWithNeighbours(int threadNum)
 }
 
 uint8_t ClientWorld::shootRay(glm::vec3 startSubBlockPos, int* startBlockPosition, glm::vec3 direction, int* breakBlockCoords, int* placeBlockCoords) {
-    //TODO: improve this to make it need less steps
-    glm::vec3 rayPos = startSubBlockPos;
-    int blockPos[3];
-    int steps = 0;
-    while (steps < 180) {
-        rayPos += direction * 0.025f;
-        for (int ii = 0; ii < 3; ii++)
-            blockPos[ii] = floor(rayPos[ii]) + startBlockPosition[ii];
-        if (!integratedServer.isChunkLoaded(Chunk::getChunkCoords(blockPos)))
-            return 0;
-
-        uint8_t blockType = integratedServer.chunkManager.getBlock(blockPos);
-        if ((blockType != 0) && (blockType != 4)) {
-            bool hit = true;
-            for (int ii = 0; ii < 3; ii++) {
-                if (rayPos[ii] < blockPos[ii] - startBlockPosition[ii] + integratedServer.getResourcePack().
-                        getBlockData(blockType).model ->boundingBoxVertices[ii] + 0.5f
-                    || rayPos[ii] > blockPos[ii] - startBlockPosition[ii] + integratedServer.getResourcePack().
-                        getBlockData(blockType).model->boundingBoxVertices[ii + 15] + 0.5f) {
-                    hit = false;
-                }
-            }
-            if (hit) {
-                for (int ii = 0; ii < 3; ii++)
-                    breakBlockCoords[ii] = blockPos[ii];
-
-                bool equal = true;
-                while (equal) {
-                    rayPos -= direction * 0.025f;
-                    for (int ii = 0; ii < 3; ii++) {
-                        placeBlockCoords[ii] = floor(rayPos[ii]) + startBlockPosition[ii];
-                        equal &= placeBlockCoords[ii] == blockPos[ii];
-                    }
-                }
-
-                for (int ii = 0; ii < 3; ii++)
-                    placeBlockCoords[ii] = floor(rayPos[ii]) + startBlockPosition[ii];
-
-                return blockType;
-            }
-        }
-        steps++;
+    const float REACH = 4.5f;
+    auto getBlock = [&](const IVec3& position, uint8_t& blockType) {
+        if (!integratedServer.isChunkLoaded(Chunk::getChunkCoords(position)))
+            return false;
+        blockType = integratedServer.chunkManager.getBlock(position);
+        return true;
+    };
+    auto getBlockBounds = [&](uint8_t blockType, Vec3& min, Vec3& max) {
+        // Air and water can't be targeted
+        if (blockType == 0 || blockType == 4)
+            return false;
+        const float* boundingBox = integratedServer.getResourcePack().getBlockData(blockType).model
+            ->boundingBoxVertices;
+        min = Vec3(boundingBox) + Vec3(0.5f);
+        max = Vec3(boundingBox + 15) + Vec3(0.5f);
+        return true;
+    };
+
+    RaycastHit hit;
+    if (!raycastBlocks(
+        IVec3(startBlockPosition), Vec3(startSubBlockPos.x, startSubBlockPos.y, startSubBlockPos.z),
+        Vec3(direction.x, direction.y, direction.z), REACH, getBlock, getBlockBounds, &hit
+    )) {
+        return 0;
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+        breakBlockCoords[i] = hit.blockCoords[i];
+        placeBlockCoords[i] = hit.blockCoords[i] + hit.normal[i];
     }
-    return 0;
+    return hit.blockType;
 }
 
 void ClientWorld::replaceBlock(const IVec3& blockCoords, uint8_t blockType)
@@ -678,12 +739,8 @@ void ClientWorld::replaceBlock(const IVec3& blockCoords, uint8_t blockType)
     std::vector<IVec3> chunksToRemesh;
     addChunksToRemesh(chunksToRemesh, blockCoords, chunkPosition);
 
-    auto tp1 = std::chrono::high_resolution_clock::now();
     Lighting::relightChunksAroundBlock(blockCoords, chunkPosition, originalBlockType, blockType,
         chunksToRemesh, integratedServer.chunkManager.getWorldChunks(), integratedServer.getResourcePack());
-    auto tp2 = std::chrono::high_resolution_clock::now();
-    // LOG(std::to_string(chunksToRemesh.size()) + " chunks remeshed\n");
-    // LOG("relight took " + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(tp2 - tp1).count()) + "us");
 
     std::lock_guard<std::mutex> lock(m_meshesToUpdateMtx);
     for (auto& chunk : chunksToRemesh)
@@ -747,25 +804,24 @@ void ClientWorld::unloadAllMeshes()
 
 void ClientWorld::buildEntityMesh(const IVec3& playerBlockPos)
 {
+    PROFILE_ZONE("Build entity instances");
     float timeSinceLastTick = integratedServer.getTimeSinceLastTick();
-    integratedServer.getEntityManager().getPhysicsEngine().extrapolateTransforms(timeSinceLastTick);
-    GPUDynamicMeshBuffers& entityMesh = m_entityMeshes[
+    GPUDynamicBuffer& entityInstances = m_entityInstanceBuffers[
         m_renderer.getVulkanEngine().getFrameDataIndex()
     ];
-    m_entityMeshManager.createBatch(
-        playerBlockPos, reinterpret_cast<float*>(entityMesh.vertexBuffer.mappedData),
-        reinterpret_cast<uint32_t*>(entityMesh.indexBuffer.mappedData), timeSinceLastTick
+    m_entityMeshManager.createInstances(
+        playerBlockPos, reinterpret_cast<EntityInstance*>(entityInstances.buffer.mappedData),
+        timeSinceLastTick
     );
-    m_renderer.updateEntityMesh(m_entityMeshManager, entityMesh);
+    m_renderer.updateEntityInstances(m_entityMeshManager, entityInstances);
 }
 
 void ClientWorld::freeEntityMeshes()
 {
-    for (GPUDynamicMeshBuffers mesh : m_entityMeshes)
-    {
-        m_renderer.getVulkanEngine().destroyHostVisibleAndDeviceLocalBuffer(mesh.vertexBuffer);
-        m_renderer.getVulkanEngine().destroyHostVisibleAndDeviceLocalBuffer(mesh.indexBuffer);
-    }
+    m_renderer.getVulkanEngine().destroyBuffer(m_entityModelMesh.vertexBuffer);
+    m_renderer.getVulkanEngine().destroyBuffer(m_entityModelMesh.indexBuffer);
+    for (GPUDynamicBuffer buffer : m_entityInstanceBuffers)
+        m_renderer.getVulkanEngine().destroyHostVisibleAndDeviceLocalBuffer(buffer.buffer);
 }
 
 }  // namespace lonelycube::client
@@ -80,6 +80,7 @@ private:
     // accessed from multiple threads
     // Vectors to allow for each mesh-building thread to have its own value
     std::vector<IVec3> m_chunkPosition;
+    std::vector<int64_t> m_chunkMeshReadyTime;
     std::vector<std::vector<float>> m_chunkVertices;
     std::vector<std::vector<uint32_t>> m_chunkIndices;
     std::vector<std::vector<float>> m_chunkWaterVertices;
@@ -110,7 +111,8 @@ private:
     bool m_chunkRequestScheduled;
 
     EntityMeshManager m_entityMeshManager;
-    std::vector<GPUDynamicMeshBuffers> m_entityMeshes;
+    GPUMeshBuffers m_entityModelMesh;
+    std::vector<GPUDynamicBuffer> m_entityInstanceBuffers;
 
     void unloadMesh(MeshData& mesh);
     bool chunkHasNeighbours(const IVec3& chunkPosition);
@@ -147,6 +149,9 @@ public:
     void updateMeshes();
     void updatePlayerPos(IVec3 playerBlockCoords, Vec3 playerSubBlockCoords);
     void unloadOutOfRangeMeshesIfNeeded();
+    // Returns true once every chunk within radius chunks of the centre on each axis has been
+    // loaded and handed to a meshing thread
+    bool chunksMeshedAround(const IVec3& centreChunkPosition, int radius);
     void unloadAllMeshes();
     void buildEntityMesh(const IVec3& playerBlockPos);
     void freeEntityMeshes();
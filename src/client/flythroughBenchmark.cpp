@@ -0,0 +1,226 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "client/flythroughBenchmark.h"
+
+#include "core/pch.h"
+
+#include <iomanip>
+
+#include "client/cameraPath.h"
+#include "client/game.h"
+#include "client/graphics/renderer.h"
+#include "core/chunk.h"
+#include "core/chunkPipelineStats.h"
+#include "core/config.h"
+#include "core/profiler.h"
+
+namespace lonelycube::client {
+
+// The path is always followed at this step, however long frames take to draw, so that every
+// run draws the same frames
+static constexpr double FRAME_STEP = 1.0 / 60.0;
+static constexpr int WARMUP_RADIUS = 3;  // chunks
+static constexpr double WARMUP_TIMEOUT = 300.0;  // seconds
+// Frames drawn after the chunks around the start are meshed, to let the last meshes upload
+// and the auto exposure settle
+static constexpr int NUM_SETTLING_FRAMES = 120;
+static constexpr int NUM_GPU_PASSES = static_cast<int>(GpuPass::Count);
+
+// GPU pass times are only read back MAX_FRAMES_IN_FLIGHT frames after they are drawn, so rows
+// are kept until every column is filled in
+struct FlythroughRow
+{
+    uint64_t engineFrameNum;
+    std::string cpuColumns;
+    std::array<float, NUM_GPU_PASSES> gpuPassTimes;
+};
+
+int runFlythroughBenchmark(
+    const std::filesystem::path& cameraPathFile, const std::filesystem::path& outputFile
+) {
+    Profiler::setThreadName("Render");
+    CameraPath cameraPath;
+    if (!cameraPath.load(cameraPathFile))
+    {
+        std::cerr << "Failed to load camera path " << cameraPathFile.string() << "\n";
+        return 1;
+    }
+    std::ofstream output(outputFile);
+    if (!output)
+    {
+        std::cerr << "Failed to open " << outputFile.string() << "\n";
+        return 1;
+    }
+
+    int renderDistance = cameraPath.getRenderDistance();
+    if (renderDistance <= 0)
+        renderDistance = Config("res/settings.txt").getRenderDistance();
+    std::cout << "Flythrough of seed " << cameraPath.getSeed() << " with render distance "
+        << renderDistance << " for " << cameraPath.getDuration() << "s" << std::endl;
+
+    Renderer renderer(VK_SAMPLE_COUNT_4_BIT, 1.0f, true);
+    GpuProfiler& gpuProfiler = renderer.getGpuProfiler();
+    gpuProfiler.setEnabled(true);
+    std::vector<double> cpuFrameTimes;
+    std::vector<FlythroughRow> rows;
+    {
+        Game game(renderer, false, "", renderDistance, cameraPath.getSeed());
+        game.getPlayer().setPaused(false);
+
+        auto runFrame = [&](double time, double* cpuTime) -> bool {
+            CameraKeyframe keyframe = cameraPath.sample(time);
+            game.getPlayer().setCameraPose(keyframe.position, keyframe.yaw, keyframe.pitch);
+            // Waiting for the GPU to finish with the frame's resources isn't counted as CPU
+            // time
+            if (!renderer.beginRenderingFrame())
+                return false;
+            auto start = std::chrono::steady_clock::now();
+            game.renderFrame(FRAME_STEP);
+            renderer.beginDrawingUi();
+            renderer.menuRenderer.draw();
+            renderer.font.draw();
+            renderer.submitFrame();
+            game.getWorld().unloadOutOfRangeMeshesIfNeeded();
+            game.getWorld().doRenderThreadJobs();
+            *cpuTime = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start
+            ).count();
+            return true;
+        };
+
+        CameraKeyframe start = cameraPath.sample(0.0);
+        IVec3 startChunkPosition = Chunk::getChunkCoords(IVec3(
+            std::floor(start.position[0]), std::floor(start.position[1]),
+            std::floor(start.position[2])
+        ));
+        int warmupRadius = std::clamp(renderDistance - 2, 1, WARMUP_RADIUS);
+        auto warmupStart = std::chrono::steady_clock::now();
+        double warmupTime = 0.0;
+        double cpuTime;
+        while (!game.getWorld().chunksMeshedAround(startChunkPosition, warmupRadius))
+        {
+            runFrame(0.0, &cpuTime);
+            warmupTime = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - warmupStart
+            ).count();
+            if (warmupTime > WARMUP_TIMEOUT)
+            {
+                std::cerr << "Timed out waiting for the chunks around the start of the path\n";
+                break;
+            }
+        }
+        for (int frameNum = 0; frameNum < NUM_SETTLING_FRAMES; frameNum++)
+            runFrame(0.0, &cpuTime);
+        std::cout << "Chunks around the start were drawn after " << warmupTime << "s"
+            << std::endl;
+
+        auto getStageCount = [](ChunkStage stage) {
+            return ChunkPipelineStats::getHistogram(stage).getCount();
+        };
+        uint64_t lastGenerated = getStageCount(ChunkStage::Generate);
+        uint64_t lastMeshed = getStageCount(ChunkStage::Mesh);
+        uint64_t lastDrawn = getStageCount(ChunkStage::LoadedToDrawn);
+        auto storeGpuPassTimes = [&]() {
+            int64_t resultFrameNum = gpuProfiler.getResultFrameNum();
+            for (auto row = rows.rbegin(); row != rows.rend(); row++)
+            {
+                if (static_cast<int64_t>(row->engineFrameNum) != resultFrameNum)
+                    continue;
+                for (int passNum = 0; passNum < NUM_GPU_PASSES; passNum++)
+                {
+                    row->gpuPassTimes[passNum] =
+                        gpuProfiler.getPassTime(static_cast<GpuPass>(passNum));
+                }
+                break;
+            }
+        };
+
+        int numFrames = std::ceil(cameraPath.getDuration() / FRAME_STEP) + 1;
+        for (int frameNum = 0; frameNum < numFrames; frameNum++)
+        {
+            double time = frameNum * FRAME_STEP;
+            uint64_t engineFrameNum = renderer.getVulkanEngine().getCurrentFrame();
+            auto frameStart = std::chrono::steady_clock::now();
+            if (!runFrame(time, &cpuTime))
+                continue;
+            double frameTime = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - frameStart
+            ).count();
+            cpuFrameTimes.push_back(cpuTime);
+
+            uint64_t generated = getStageCount(ChunkStage::Generate);
+            uint64_t meshed = getStageCount(ChunkStage::Mesh);
+            uint64_t drawn = getStageCount(ChunkStage::LoadedToDrawn);
+            std::ostringstream cpuColumns;
+            cpuColumns << std::fixed << std::setprecision(3) << frameNum << "," << time << ","
+                << frameTime * 1000.0 << "," << cpuTime * 1000.0 << ","
+                << generated - lastGenerated << "," << meshed - lastMeshed << ","
+                << drawn - lastDrawn;
+            FlythroughRow& row = rows.emplace_back();
+            row.engineFrameNum = engineFrameNum;
+            row.cpuColumns = cpuColumns.str();
+            row.gpuPassTimes.fill(-1.0f);
+            storeGpuPassTimes();
+            lastGenerated = generated;
+            lastMeshed = meshed;
+            lastDrawn = drawn;
+        }
+        // Draw a few more frames so that the last frames' GPU pass times are read back
+        for (int frameNum = 0; frameNum < VulkanEngine::MAX_FRAMES_IN_FLIGHT; frameNum++)
+        {
+            if (runFrame(cameraPath.getDuration(), &cpuTime))
+                storeGpuPassTimes();
+        }
+    }
+
+    output << "frame,time,frame_ms,cpu_ms,chunks_generated,chunks_meshed,chunks_drawn";
+    for (int passNum = 0; passNum < NUM_GPU_PASSES; passNum++)
+        output << "," << GpuProfiler::getCsvColumnName(static_cast<GpuPass>(passNum));
+    output << "\n" << std::fixed << std::setprecision(3);
+    for (const FlythroughRow& row : rows)
+    {
+        output << row.cpuColumns;
+        // Passes that weren't drawn, or a GPU without timestamps, leave the column empty
+        for (float passTime : row.gpuPassTimes)
+        {
+            output << ",";
+            if (passTime >= 0.0f)
+                output << passTime;
+        }
+        output << "\n";
+    }
+
+    if (cpuFrameTimes.empty())
+    {
+        std::cerr << "No frames were drawn\n";
+        return 1;
+    }
+    std::sort(cpuFrameTimes.begin(), cpuFrameTimes.end());
+    double totalTime = 0.0;
+    for (double frameTime : cpuFrameTimes)
+        totalTime += frameTime;
+    std::cout << std::fixed << std::setprecision(3) << "Wrote " << cpuFrameTimes.size()
+        << " frames to " << outputFile.string() << ", CPU time mean "
+        << totalTime / cpuFrameTimes.size() * 1000.0 << "ms, median "
+        << cpuFrameTimes[cpuFrameTimes.size() / 2] * 1000.0 << "ms, p99 "
+        << cpuFrameTimes[cpuFrameTimes.size() * 99 / 100] * 1000.0 << "ms\n";
+    return 0;
+}
+
+}  // namespace lonelycube::client
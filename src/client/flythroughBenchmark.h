@@ -0,0 +1,33 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+namespace lonelycube::client {
+
+// Loads the world of a recorded camera path with an offscreen renderer, waits for the chunks
+// around the start of the path to be drawn, then follows the path at a fixed step of simulated
+// time per frame while writing the time taken by each frame to a CSV file. Returns the
+// process's exit code.
+int runFlythroughBenchmark(
+    const std::filesystem::path& cameraPathFile, const std::filesystem::path& outputFile
+);
+
+}  // namespace lonelycube::client
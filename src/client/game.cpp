@@ -27,8 +27,10 @@
 
 #include "client/logicThread.h"
 #include "client/graphics/camera.h"
+#include "core/chunkPipelineStats.h"
 #include "core/constants.h"
 #include "core/log.h"
+#include "core/profiler.h"
 
 #include "glm/glm.hpp"
 
@@ -65,10 +67,13 @@ Game::Game(
         m_mainPlayer.cameraBlockPosition, &(m_mainPlayer.viewCamera.position[0])
     );
 
-    int windowDimensions[2];
-    m_mainPlayer.processUserInput(
-        renderer.getVulkanEngine().getWindow(), windowDimensions, 0.0, m_networking
-    );
+    if (!renderer.getVulkanEngine().isHeadless())
+    {
+        int windowDimensions[2];
+        m_mainPlayer.processUserInput(
+            renderer.getVulkanEngine().getWindow(), windowDimensions, 0.0, m_networking
+        );
+    }
     m_mainWorld.doRenderThreadJobs();
 }
 
@@ -147,7 +152,7 @@ void Game::unfocus()
 
 void Game::renderFrame(double dt)
 {
-    auto tp1 = std::chrono::high_resolution_clock::now();
+    PROFILE_ZONE("Render frame");
     m_mainWorld.updateMeshes();
     m_mainWorld.updatePlayerPos(
         m_mainPlayer.cameraBlockPosition, &(m_mainPlayer.viewCamera.position[0])
@@ -199,27 +204,12 @@ void Game::renderFrame(double dt)
     // Render the world geometry
     float cameraSubBlockPos[3];
     m_mainPlayer.viewCamera.getPosition(cameraSubBlockPos);
-    #ifdef TIMESTAMPS
-    FrameData& currentFrameData = m_renderer.getVulkanEngine().getCurrentFrameData();
-    VkCommandBuffer command = currentFrameData.commandBuffer;
-    vkCmdWriteTimestamp(
-        command, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, renderer.getVulkanEngine().getCurrentTimestampQueryPool(), 0
-    );
-    #endif
     m_mainWorld.renderWorld(
         viewProjection, m_mainPlayer.cameraBlockPosition,
         glm::vec3(cameraSubBlockPos[0], cameraSubBlockPos[1], cameraSubBlockPos[2]),
         (float)windowDimensions.width / (float)windowDimensions.height, fov, groundLuminance,
         dt
     );
-    #ifdef TIMESTAMPS
-    vkCmdWriteTimestamp(
-        command, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, renderer.getVulkanEngine().getCurrentTimestampQueryPool(), 1
-    );
-    #endif
-
-    // //auto tp2 = std::chrono::high_resolution_clock::now();
-    // //LOG(std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(tp2 - tp1).count()) + "us");
 
     // Draw the block outline
     int breakBlockCoords[3];
@@ -248,9 +238,6 @@ void Game::renderFrame(double dt)
     m_renderer.beginRenderingToSwapchainImage();
     m_renderer.applyToneMap();
     m_renderer.drawCrosshair();
-    auto tp2 = std::chrono::high_resolution_clock::now();
-    if (std::chrono::duration_cast<std::chrono::milliseconds>(tp2 - tp1).count() > 10)
-        LOG("waited " + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(tp2 - tp1).count()) + "ms for frame to render");
 }
 
 void Game::queueDebugText(int guiScale, int FPS)
@@ -261,10 +248,22 @@ void Game::queueDebugText(int guiScale, int FPS)
     std::string text = "Position: X=" + std::to_string(playerPos.x) + " Y="
         + std::to_string(playerPos.y) + " Z=" + std::to_string(playerPos.z);
     m_renderer.font.queue(text, textPos, guiScale, colour);
+    for (const std::string& line : ChunkPipelineStats::getSummary())
+    {
+        textPos.y += (m_renderer.font.getCharHeight() + 1) * guiScale;
+        m_renderer.font.queue(line, textPos, guiScale, colour);
+    }
     text = std::to_string(FPS) + " FPS";
     textPos = glm::ivec2(m_renderer.getVulkanEngine().getSwapchainExtent().width
         - (m_renderer.font.getStringWidth(text) + 1) * guiScale, guiScale);
     m_renderer.font.queue(text, textPos, guiScale, colour);
+    for (const std::string& line : m_renderer.getGpuProfiler().getSummary())
+    {
+        textPos = glm::ivec2(m_renderer.getVulkanEngine().getSwapchainExtent().width
+            - (m_renderer.font.getStringWidth(line) + 1) * guiScale,
+            textPos.y + (m_renderer.font.getCharHeight() + 1) * guiScale);
+        m_renderer.font.queue(line, textPos, guiScale, colour);
+    }
 }
 
 }  // namespace lonelycube::client
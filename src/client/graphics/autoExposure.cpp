@@ -181,8 +181,8 @@ void AutoExposure::createLuminancePipeline()
     pipelineCreateInfo.stage = stageInfo;
 
     VK_CHECK(vkCreateComputePipelines(
-        m_vulkanEngine.getDevice(), VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr,
-        &m_luminancePipeline
+        m_vulkanEngine.getDevice(), m_vulkanEngine.getPipelineCache(), 1, &pipelineCreateInfo,
+        nullptr, &m_luminancePipeline
     ));
 
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), luminanceShader, nullptr);
@@ -239,8 +239,8 @@ void AutoExposure::createParallelReduceMeanPipeline()
     pipelineCreateInfo.stage = stageInfo;
 
     VK_CHECK(vkCreateComputePipelines(
-        m_vulkanEngine.getDevice(), VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr,
-        &m_parallelReduceMeanPipeline
+        m_vulkanEngine.getDevice(), m_vulkanEngine.getPipelineCache(), 1, &pipelineCreateInfo,
+        nullptr, &m_parallelReduceMeanPipeline
     ));
 
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), parallelReduceMeanShader, nullptr);
@@ -295,8 +295,8 @@ void AutoExposure::createAutoExposurePipeline(uint32_t numLuminanceElements)
     pipelineCreateInfo.stage = stageInfo;
 
     VK_CHECK(vkCreateComputePipelines(
-        m_vulkanEngine.getDevice(), VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr,
-        &m_autoExposurePipeline
+        m_vulkanEngine.getDevice(), m_vulkanEngine.getPipelineCache(), 1, &pipelineCreateInfo,
+        nullptr, &m_autoExposurePipeline
     ));
 
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), autoExposureShader, nullptr);
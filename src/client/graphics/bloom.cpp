@@ -28,7 +28,8 @@
 
 namespace lonelycube::client {
 
-Bloom::Bloom(VulkanEngine& vulkanEngine) : m_vulkanEngine(vulkanEngine) {}
+Bloom::Bloom(VulkanEngine& vulkanEngine, GpuProfiler& gpuProfiler) :
+    m_vulkanEngine(vulkanEngine), m_gpuProfiler(gpuProfiler) {}
 
 void Bloom::init(
     DescriptorAllocatorGrowable& descriptorAllocator, AllocatedImage srcImage, VkSampler sampler
@@ -218,7 +219,7 @@ void Bloom::createPipelines()
 
     std::array<VkPipeline, 2> pipelines;
     VK_CHECK(vkCreateComputePipelines(
-        m_vulkanEngine.getDevice(), VK_NULL_HANDLE, pipelineCreateInfos.size(),
+        m_vulkanEngine.getDevice(), m_vulkanEngine.getPipelineCache(), pipelineCreateInfos.size(),
         pipelineCreateInfos.data(), nullptr, pipelines.data()
     ));
     m_downsamplePipeline = pipelines[0];
@@ -355,7 +356,10 @@ void Bloom::renderUpsamples(float filterRadius)
 
 void Bloom::render(float filterRadius, float strength)
 {
+    m_gpuProfiler.beginPass(GpuPass::BloomDownsample);
     renderDownsamples(strength);
+    m_gpuProfiler.endPass(GpuPass::BloomDownsample);
+    m_gpuProfiler.beginPass(GpuPass::BloomUpsample);
     renderUpsamples(filterRadius);
 
     FrameData& currentFrameData = m_vulkanEngine.getCurrentFrameData();
@@ -392,6 +396,7 @@ void Bloom::render(float filterRadius, float strength)
         command,
         (m_srcImage.imageExtent.width + 15) / 16, (m_srcImage.imageExtent.height + 15) / 16, 1
     );
+    m_gpuProfiler.endPass(GpuPass::BloomUpsample);
 }
 
 }  // namespace lonelycube::client
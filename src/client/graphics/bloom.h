@@ -22,6 +22,7 @@
 
 #include "glm/glm.hpp"
 
+#include "client/graphics/gpuProfiler.h"
 #include "client/graphics/vulkan/descriptors.h"
 #include "client/graphics/vulkan/vulkanEngine.h"
 
@@ -53,7 +54,7 @@ struct UpsamplePushConstants
 class Bloom {
 public:
 public:
-    Bloom(VulkanEngine& vulkanEngine);
+    Bloom(VulkanEngine& vulkanEngine, GpuProfiler& gpuProfiler);
     void init(
         DescriptorAllocatorGrowable& descriptorAllocator, AllocatedImage srcImage, VkSampler sampler
     );
@@ -63,6 +64,7 @@ public:
 
 private:
     VulkanEngine& m_vulkanEngine;
+    GpuProfiler& m_gpuProfiler;
 
     int m_smallestMipIndex;
 
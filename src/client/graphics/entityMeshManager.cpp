@@ -19,92 +19,157 @@
 #include "client/graphics/entityMeshManager.h"
 
 #include "core/constants.h"
+#include "core/entities/components/awakeComponent.h"
 #include "core/entities/components/itemComponent.h"
 #include "core/entities/components/meshComponent.h"
+#include "core/entities/components/physicsComponent.h"
 #include "core/entities/components/transformComponent.h"
 #include "core/entities/ECSView.h"
 
 namespace lonelycube {
 
 EntityMeshManager::EntityMeshManager(ServerWorld<true>& serverWorld) :
-    m_ecs(serverWorld.getEntityManager().getECS()), m_serverWorld(serverWorld), numIndices(0) {}
+    m_ecs(serverWorld.getEntityManager().getECS()), m_serverWorld(serverWorld), numInstances(0)
+{
+    m_modelMeshes.fill({ 0, 0, 0 });
+}
+
+void EntityMeshManager::buildModelMeshes(
+    std::vector<float>& vertices, std::vector<uint32_t>& indices
+) {
+    const ResourcePack& resourcePack = m_serverWorld.getResourcePack();
+    for (int blockType = 0; blockType < 256; blockType++)
+    {
+        const BlockData& blockData = resourcePack.getBlockData(blockType);
+        if (blockData.model == nullptr)
+            continue;
 
-void EntityMeshManager::createBatch(
-    const IVec3 playerBlockCoords, float* vertexBuffer, uint32_t* indexBuffer,
+        EntityModelMesh& modelMesh = m_modelMeshes[blockType];
+        modelMesh.firstIndex = indices.size();
+        modelMesh.vertexOffset = vertices.size() / 5;
+        const std::vector<Face>& faces = blockData.model->faces;
+        for (int faceNum = 0; faceNum < static_cast<int>(faces.size()); faceNum++)
+        {
+            const float* texCoords = &blockData.faceTextureCoordinates[faceNum * 8];
+            uint32_t firstVertex = vertices.size() / 5 - modelMesh.vertexOffset;
+            for (int vertexNum = 0; vertexNum < 4; vertexNum++)
+            {
+                for (int element = 0; element < 3; element++)
+                    vertices.push_back(faces[faceNum].coords[vertexNum * 3 + element]);
+                vertices.push_back(texCoords[vertexNum * 2]);
+                vertices.push_back(texCoords[vertexNum * 2 + 1]);
+            }
+
+            indices.push_back(firstVertex);
+            indices.push_back(firstVertex + 1);
+            indices.push_back(firstVertex + 2);
+            indices.push_back(firstVertex);
+            indices.push_back(firstVertex + 2);
+            indices.push_back(firstVertex + 3);
+        }
+        modelMesh.indexCount = indices.size() - modelMesh.firstIndex;
+    }
+}
+
+void EntityMeshManager::createInstances(
+    const IVec3 playerBlockCoords, EntityInstance* instanceBuffer,
     const float timeSinceLastTick
 ) {
-    numIndices = 0;
-    sizeOfVertices = 0;
+    // Entities are drawn up to a tick behind, between their last two simulated transforms, so
+    // that they move smoothly without simulating physics every frame
+    float alpha = std::min(timeSinceLastTick * constants::TICKS_PER_SECOND, 1.0f);
     std::lock_guard<std::mutex> lock(m_ecs.mutex);
-    for (EntityId entity : ECSView<MeshComponent>(m_ecs))
+    std::shared_lock<std::shared_mutex> chunkLock(m_serverWorld.chunkManager.mutex);
+    WorldCursor cursor(m_serverWorld.chunkManager);
+    PhysicsEngine& physicsEngine = m_serverWorld.getEntityManager().getPhysicsEngine();
+
+    // Count the entities of each block type so that each type's instances can be written to
+    // their own contiguous range of the buffer
+    m_numInstancesOfType.fill(0);
+    numInstances = 0;
+    for (EntityId entity : ECSView<MeshComponent, TransformComponent>(m_ecs))
+    {
+        if (numInstances == MAX_INSTANCES)
+            break;
+        const MeshComponent& mesh = m_ecs.get<MeshComponent>(entity);
+        if (m_modelMeshes[mesh.blockType].indexCount == 0)
+            continue;
+        m_numInstancesOfType[mesh.blockType]++;
+        numInstances++;
+    }
+
+    draws.clear();
+    uint32_t firstInstance = 0;
+    for (int blockType = 0; blockType < 256; blockType++)
     {
-        const Model* model = m_ecs.get<MeshComponent>(entity).model;
-        const uint16_t* textureIndices = m_ecs.get<MeshComponent>(entity).faceTextureIndices;
-        const TransformComponent& transform = m_ecs.get<TransformComponent>(entity);
-        float entitySkyLight = interpolateSkyLight(transform.blockCoords, transform.subBlockCoords);
-        float entityBlockLight = interpolateBlockLight(transform.blockCoords,
-                                                       transform.subBlockCoords);
-        glm::vec4 offset = glm::vec4(0.0f);
+        if (m_numInstancesOfType[blockType] == 0)
+            continue;
+        draws.push_back({
+            static_cast<uint8_t>(blockType), firstInstance, m_numInstancesOfType[blockType]
+        });
+        firstInstance += m_numInstancesOfType[blockType];
+        // Reuse the count as the number of instances of the type that are still to be written
+        m_numInstancesOfType[blockType] = draws.back().firstInstance;
+    }
+
+    uint32_t numInstancesWritten = 0;
+    for (EntityId entity : ECSView<MeshComponent, TransformComponent>(m_ecs))
+    {
+        if (numInstancesWritten == numInstances)
+            break;
+        const MeshComponent& mesh = m_ecs.get<MeshComponent>(entity);
+        if (m_modelMeshes[mesh.blockType].indexCount == 0)
+            continue;
+
+        const TransformComponent transform = physicsEngine.getTransform(entity);
+        glm::mat4 subBlockTransform;
+        if (m_ecs.entityHasComponent<PhysicsComponent>(entity)
+            && !m_ecs.entityHasComponent<AwakeComponent>(entity))
+        {
+            subBlockTransform = transform.getInterpolatedTransformMatrix(
+                alpha, physicsEngine.getSleepingRotation(entity, alpha)
+            );
+        }
+        else
+        {
+            subBlockTransform = transform.getInterpolatedTransformMatrix(alpha);
+        }
         if (m_ecs.entityHasComponent<ItemComponent>(entity))
         {
-            float timer = m_ecs.get<ItemComponent>(entity).timer -
-                timeSinceLastTick * constants::TICKS_PER_SECOND;
-            offset[1] = std::sin(timer * 0.15f) * 0.06125f + 0.06125f;
+            float timer = m_ecs.get<ItemComponent>(entity).timer + 1.0f - alpha;
+            subBlockTransform[3][1] += std::sin(timer * 0.15f) * 0.06125f + 0.06125f;
         }
+        for (int axis = 0; axis < 3; axis++)
+            subBlockTransform[3][axis] += transform.blockCoords[axis] - playerBlockCoords[axis];
 
-        sizeOfVertices += 7;
-        for (int faceNum = 0; faceNum < model->faces.size(); faceNum++)
+        EntityInstance& instance = instanceBuffer[m_numInstancesOfType[mesh.blockType]++];
+        for (int row = 0; row < 3; row++)
         {
-            float texCoords[8];
-            ResourcePack::getTextureCoordinates(
-                texCoords, model->faces[faceNum].UVcoords, textureIndices[faceNum]
+            instance.transform[row] = glm::vec4(
+                subBlockTransform[0][row], subBlockTransform[1][row], subBlockTransform[2][row],
+                subBlockTransform[3][row]
             );
-            for (int vertexNum = 0; vertexNum < 4; vertexNum++)
-            {
-                // Vertex coordinates
-                glm::vec4 vertexSubBlock;
-                for (int element = 0; element < 3; element++)
-                    vertexSubBlock[element] = model->faces[faceNum].coords[vertexNum * 3 + element];
-                vertexSubBlock[3] = 1.0f;
-                vertexSubBlock = transform.subBlockTransform * vertexSubBlock;
-                vertexSubBlock += offset;
-                vertexBuffer[sizeOfVertices] = vertexSubBlock.x + (transform.blockCoords.x -
-                    playerBlockCoords.x);
-                vertexBuffer[sizeOfVertices + 1] = vertexSubBlock.y + (transform.blockCoords.y -
-                    playerBlockCoords.y);
-                vertexBuffer[sizeOfVertices + 2] = vertexSubBlock.z + (transform.blockCoords.z -
-                    playerBlockCoords.z);
-                // UV coordinates
-                vertexBuffer[sizeOfVertices + 3] = texCoords[vertexNum * 2];
-                vertexBuffer[sizeOfVertices + 4] = texCoords[vertexNum * 2 + 1];
-                // Sky light
-                vertexBuffer[sizeOfVertices + 5] = entitySkyLight;
-                // Block light
-                vertexBuffer[sizeOfVertices + 6] = entityBlockLight;
-                sizeOfVertices += 7;
-            }
-
-            //index buffer
-            int trueNumVertices = sizeOfVertices / 7;
-            indexBuffer[numIndices] = trueNumVertices - 4;
-            indexBuffer[numIndices + 1] = trueNumVertices - 3;
-            indexBuffer[numIndices + 2] = trueNumVertices - 2;
-            indexBuffer[numIndices + 4] = trueNumVertices - 2;
-            indexBuffer[numIndices + 5] = trueNumVertices - 1;
-            indexBuffer[numIndices + 3] = trueNumVertices - 4;
-            numIndices += 6;
         }
+        instance.skyLight = interpolateSkyLight(
+            transform.blockCoords, transform.subBlockCoords, cursor
+        );
+        instance.blockLight = interpolateBlockLight(
+            transform.blockCoords, transform.subBlockCoords, cursor
+        );
+        numInstancesWritten++;
     }
 }
 
-float EntityMeshManager::interpolateSkyLight(const IVec3& blockCoords, const Vec3& subBlockCoords)
-{
-    return (float)m_serverWorld.chunkManager.getSkyLight(blockCoords) / constants::skyLightMaxValue;
+float EntityMeshManager::interpolateSkyLight(
+    const IVec3& blockCoords, const Vec3& subBlockCoords, WorldCursor& cursor
+) {
+    return (float)cursor.getSkyLight(blockCoords) / constants::skyLightMaxValue;
 }
 
-float EntityMeshManager::interpolateBlockLight(const IVec3& blockCoords, const Vec3& subBlockCoords)
-{
-    return (float)m_serverWorld.chunkManager.getBlockLight(blockCoords) / constants::blockLightMaxValue;
+float EntityMeshManager::interpolateBlockLight(
+    const IVec3& blockCoords, const Vec3& subBlockCoords, WorldCursor& cursor
+) {
+    return (float)cursor.getBlockLight(blockCoords) / constants::blockLightMaxValue;
 }
 
 }  // namespace lonelycube
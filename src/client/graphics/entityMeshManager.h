@@ -20,31 +20,77 @@
 
 #include "core/pch.h"
 
+#include "glm/glm.hpp"
+
 #include "core/entities/ECS.h"
 #include "core/serverWorld.h"
 #include "core/utils/iVec3.h"
 #include "core/utils/vec3.h"
+#include "core/worldCursor.h"
 
 namespace lonelycube {
 
+// The data for one entity that the entity vertex shader reads, matching its Instance struct
+struct EntityInstance
+{
+    // The top three rows of the entity's model matrix, translated relative to the player's block
+    glm::vec4 transform[3];
+    float skyLight;
+    float blockLight;
+    float padding[2];
+};
+
+// Where one block type's model is in the shared entity model mesh
+struct EntityModelMesh
+{
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    int32_t vertexOffset;
+};
+
+// One instanced draw of every entity of a block type
+struct EntityDraw
+{
+    uint8_t blockType;
+    uint32_t firstInstance;
+    uint32_t instanceCount;
+};
+
+// Builds the mesh of every block type's model once, then each frame writes one instance for
+// each entity, grouped by block type so that all of the entities of a type are drawn at once
 class EntityMeshManager
 {
 private:
     ECS& m_ecs;
     ServerWorld<true>& m_serverWorld;
+    std::array<EntityModelMesh, 256> m_modelMeshes;
+    std::array<uint32_t, 256> m_numInstancesOfType;
 
-    float interpolateSkyLight(const IVec3& blockPosition, const Vec3& subBlockPosition);
-    float interpolateBlockLight(const IVec3& blockPosition, const Vec3& subBlockPosition);
+    float interpolateSkyLight(
+        const IVec3& blockPosition, const Vec3& subBlockPosition, WorldCursor& cursor
+    );
+    float interpolateBlockLight(
+        const IVec3& blockPosition, const Vec3& subBlockPosition, WorldCursor& cursor
+    );
 
 public:
-    uint32_t numIndices;
-    uint32_t sizeOfVertices;
+    static constexpr uint32_t MAX_INSTANCES = 16384;
+
+    uint32_t numInstances;
+    std::vector<EntityDraw> draws;
 
     EntityMeshManager(ServerWorld<true>& serverWorld);
-    void createBatch(
-        const IVec3 playerBlockCoords, float* vertexBuffer, uint32_t* indexBuffer,
+    // Vertices have 5 floats: the position, followed by the texture coordinates
+    void buildModelMeshes(std::vector<float>& vertices, std::vector<uint32_t>& indices);
+    void createInstances(
+        const IVec3 playerBlockCoords, EntityInstance* instanceBuffer,
         const float timeSinceLastTick
     );
+
+    inline const EntityModelMesh& getModelMesh(uint8_t blockType) const
+    {
+        return m_modelMeshes[blockType];
+    }
 };
 
 }  // namespace lonelycube
@@ -0,0 +1,238 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "client/graphics/gpuProfiler.h"
+
+#include "core/pch.h"
+
+#include <cctype>
+#include <iomanip>
+
+#include "client/graphics/vulkan/utils.h"
+#include "core/log.h"
+
+namespace lonelycube::client {
+
+static constexpr std::array<const char*, static_cast<int>(GpuPass::Count)> s_passNames = {
+    "Frame", "Sky", "Blocks", "Entities", "Water", "Bloom downsample", "Bloom upsample",
+    "Auto exposure", "Tone map", "UI"
+};
+
+GpuProfiler::GpuProfiler(VulkanEngine& vulkanEngine) : m_vulkanEngine(vulkanEngine),
+    m_supported(false), m_enabled(false), m_recordingFrame(false), m_nanosecondsPerTick(1.0f),
+    m_resultFrameNum(-1)
+{
+    m_queryPools.fill(VK_NULL_HANDLE);
+    m_poolFrameNums.fill(-1);
+    m_passesBegun.fill(false);
+    m_passTimes.fill(-1.0f);
+    m_averagePassTimes.fill(-1.0f);
+}
+
+void GpuProfiler::init()
+{
+    const VkPhysicalDeviceLimits& limits =
+        m_vulkanEngine.getPhysicalDeviceProperties().properties.limits;
+    m_supported = limits.timestampComputeAndGraphics && limits.timestampPeriod > 0.0f;
+    if (!m_supported)
+    {
+        LOG("GPU timestamps are not supported, so the GPU profiler is disabled");
+        return;
+    }
+    m_nanosecondsPerTick = limits.timestampPeriod;
+
+    VkQueryPoolCreateInfo queryPoolInfo{};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = 2 * NUM_PASSES;
+    for (VkQueryPool& queryPool : m_queryPools)
+    {
+        VK_CHECK(vkCreateQueryPool(
+            m_vulkanEngine.getDevice(), &queryPoolInfo, nullptr, &queryPool
+        ));
+    }
+}
+
+void GpuProfiler::cleanup()
+{
+    stopCsvLog();
+    for (VkQueryPool& queryPool : m_queryPools)
+    {
+        if (queryPool != VK_NULL_HANDLE)
+            vkDestroyQueryPool(m_vulkanEngine.getDevice(), queryPool, nullptr);
+        queryPool = VK_NULL_HANDLE;
+    }
+}
+
+void GpuProfiler::readResults(int poolIndex)
+{
+    // Each query gives its timestamp followed by whether it's available
+    std::array<uint64_t, 4 * NUM_PASSES> results;
+    vkGetQueryPoolResults(
+        m_vulkanEngine.getDevice(), m_queryPools[poolIndex], 0, 2 * NUM_PASSES,
+        sizeof(results), results.data(), 2 * sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+    );
+
+    m_resultFrameNum = m_poolFrameNums[poolIndex];
+    m_poolFrameNums[poolIndex] = -1;
+    for (int passNum = 0; passNum < NUM_PASSES; passNum++)
+    {
+        const uint64_t* begin = &results[4 * passNum];
+        const uint64_t* end = &results[4 * passNum + 2];
+        if (!begin[1] || !end[1])
+        {
+            m_passTimes[passNum] = -1.0f;
+            m_averagePassTimes[passNum] = -1.0f;
+            continue;
+        }
+
+        float time = (end[0] - begin[0]) * m_nanosecondsPerTick / 1e6f;
+        m_passTimes[passNum] = time;
+        m_averagePassTimes[passNum] = m_averagePassTimes[passNum] < 0.0f ? time :
+            m_averagePassTimes[passNum] + (time - m_averagePassTimes[passNum]) * AVERAGE_WEIGHT;
+    }
+
+    if (!m_csvLog.is_open())
+        return;
+    m_csvLog << m_resultFrameNum;
+    for (float time : m_passTimes)
+    {
+        m_csvLog << ",";
+        if (time >= 0.0f)
+            m_csvLog << time;
+    }
+    m_csvLog << "\n";
+}
+
+void GpuProfiler::beginFrame()
+{
+    int poolIndex = m_vulkanEngine.getFrameDataIndex();
+    // This frame's fence has been waited on, so whatever the pool's last frame wrote is ready
+    if (m_poolFrameNums[poolIndex] >= 0)
+        readResults(poolIndex);
+
+    m_recordingFrame = m_enabled && m_supported;
+    if (!m_recordingFrame)
+        return;
+
+    VkCommandBuffer command = m_vulkanEngine.getCurrentFrameData().commandBuffer;
+    vkCmdResetQueryPool(command, m_queryPools[poolIndex], 0, 2 * NUM_PASSES);
+    m_poolFrameNums[poolIndex] = m_vulkanEngine.getCurrentFrame();
+    m_passesBegun.fill(false);
+}
+
+void GpuProfiler::writeTimestamp(GpuPass pass, uint32_t queryIndex)
+{
+    VkCommandBuffer command = m_vulkanEngine.getCurrentFrameData().commandBuffer;
+    vkCmdWriteTimestamp2(
+        command, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        m_queryPools[m_vulkanEngine.getFrameDataIndex()],
+        2 * static_cast<uint32_t>(pass) + queryIndex
+    );
+}
+
+void GpuProfiler::beginPass(GpuPass pass)
+{
+    // A query can only be written once between resets
+    if (!m_recordingFrame || m_passesBegun[static_cast<int>(pass)])
+        return;
+    m_passesBegun[static_cast<int>(pass)] = true;
+    writeTimestamp(pass, 0);
+}
+
+void GpuProfiler::endPass(GpuPass pass)
+{
+    if (!m_recordingFrame || !m_passesBegun[static_cast<int>(pass)])
+        return;
+    writeTimestamp(pass, 1);
+}
+
+void GpuProfiler::setEnabled(bool enabled)
+{
+    // Don't show the results from the last time the profiler was enabled
+    if (enabled && !m_enabled)
+    {
+        m_passTimes.fill(-1.0f);
+        m_averagePassTimes.fill(-1.0f);
+        m_resultFrameNum = -1;
+    }
+    m_enabled = enabled;
+}
+
+bool GpuProfiler::startCsvLog(const std::string& path)
+{
+    stopCsvLog();
+    m_csvLog.open(path);
+    if (!m_csvLog.is_open())
+    {
+        LOG("Failed to open " + path);
+        return false;
+    }
+
+    m_csvLog << "frame";
+    for (int passNum = 0; passNum < NUM_PASSES; passNum++)
+        m_csvLog << "," << getCsvColumnName(static_cast<GpuPass>(passNum));
+    m_csvLog << "\n" << std::fixed << std::setprecision(4);
+    return true;
+}
+
+void GpuProfiler::stopCsvLog()
+{
+    if (m_csvLog.is_open())
+        m_csvLog.close();
+}
+
+float GpuProfiler::getPassTime(GpuPass pass) const
+{
+    return m_passTimes[static_cast<int>(pass)];
+}
+
+const char* GpuProfiler::getPassName(GpuPass pass)
+{
+    return s_passNames[static_cast<int>(pass)];
+}
+
+std::string GpuProfiler::getCsvColumnName(GpuPass pass)
+{
+    std::string name = getPassName(pass);
+    for (char& character : name)
+        character = character == ' ' ? '_' : static_cast<char>(std::tolower(character));
+    return "gpu_" + name + "_ms";
+}
+
+std::vector<std::string> GpuProfiler::getSummary() const
+{
+    std::vector<std::string> lines;
+    if (!m_enabled)
+        return lines;
+    for (int passNum = 0; passNum < NUM_PASSES; passNum++)
+    {
+        if (m_averagePassTimes[passNum] < 0.0f)
+            continue;
+
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(2) << "GPU " << s_passNames[passNum] << ": "
+            << m_averagePassTimes[passNum] << "ms";
+        lines.push_back(line.str());
+    }
+    return lines;
+}
+
+}  // namespace lonelycube::client
@@ -0,0 +1,106 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "core/pch.h"
+
+#include "client/graphics/vulkan/vulkanEngine.h"
+
+namespace lonelycube::client {
+
+enum class GpuPass
+{
+    Frame, Sky, Blocks, Entities, Water, BloomDownsample, BloomUpsample, AutoExposure, ToneMap,
+    Ui, Count
+};
+
+// Measures how long each pass of a frame takes on the GPU by writing a timestamp query at the
+// start and end of it. Every frame in flight has its own query pool, which is read back just
+// before the frame that next uses it is recorded. That frame's fence has already been waited on,
+// so the results are ready without stalling, but they are MAX_FRAMES_IN_FLIGHT frames late.
+class GpuProfiler
+{
+private:
+    static constexpr int NUM_PASSES = static_cast<int>(GpuPass::Count);
+    // Weight given to the newest result in the averages shown in the debug text
+    static constexpr float AVERAGE_WEIGHT = 0.05f;
+
+    VulkanEngine& m_vulkanEngine;
+    std::array<VkQueryPool, VulkanEngine::MAX_FRAMES_IN_FLIGHT> m_queryPools;
+    // The frame that wrote to each pool, or -1 if it hasn't been written to since it was read
+    std::array<int64_t, VulkanEngine::MAX_FRAMES_IN_FLIGHT> m_poolFrameNums;
+    bool m_supported;
+    bool m_enabled;
+    // Whether the current frame's pool was reset, which it must be before it's written to
+    bool m_recordingFrame;
+    std::array<bool, NUM_PASSES> m_passesBegun;
+    float m_nanosecondsPerTick;
+
+    int64_t m_resultFrameNum;
+    // Milliseconds, or negative if the pass wasn't drawn that frame
+    std::array<float, NUM_PASSES> m_passTimes;
+    std::array<float, NUM_PASSES> m_averagePassTimes;
+    std::ofstream m_csvLog;
+
+    void readResults(int poolIndex);
+    void writeTimestamp(GpuPass pass, uint32_t queryIndex);
+
+public:
+    GpuProfiler(VulkanEngine& vulkanEngine);
+    void init();
+    void cleanup();
+
+    // Must be called after the command buffer is begun and before any rendering is started
+    void beginFrame();
+    // Each pass can only be measured once per frame
+    void beginPass(GpuPass pass);
+    void endPass(GpuPass pass);
+
+    void setEnabled(bool enabled);
+    // Writes the pass times of every frame to a CSV file until stopCsvLog is called. Returns
+    // false if the file couldn't be opened
+    bool startCsvLog(const std::string& path);
+    void stopCsvLog();
+
+    // Returns the time in milliseconds that the pass took in the frame given by
+    // getResultFrameNum, or a negative number if it wasn't drawn that frame
+    float getPassTime(GpuPass pass) const;
+    static const char* getPassName(GpuPass pass);
+    // The name of the pass's column in CSV files, such as gpu_tone_map_ms
+    static std::string getCsvColumnName(GpuPass pass);
+    // One line for each pass drawn in recent frames, with its average time
+    std::vector<std::string> getSummary() const;
+
+    inline bool isSupported() const
+    {
+        return m_supported;
+    }
+    inline bool isEnabled() const
+    {
+        return m_enabled;
+    }
+    // The frame that the latest results are from, or -1 if there aren't any
+    inline int64_t getResultFrameNum() const
+    {
+        return m_resultFrameNum;
+    }
+};
+
+}  // namespace lonelycube::client
@@ -22,6 +22,7 @@
 
 #include "core/chunk.h"
 #include "core/constants.h"
+#include "core/profiler.h"
 #include <cmath>
 #include <iomanip>
 
@@ -38,7 +39,8 @@ MeshBuilder::MeshBuilder(
     std::vector<uint32_t>& indices, std::vector<float>& waterVertices,
     std::vector<uint32_t>& waterIndices
 ) : m_chunk(chunk), m_serverWorld(serverWorld), m_vertices(vertices), m_indices(indices),
-    m_waterVertices(waterVertices), m_waterIndices(waterIndices)
+    m_waterVertices(waterVertices), m_waterIndices(waterIndices),
+    m_cursor(serverWorld.chunkManager)
 {
     m_chunk.getPosition(m_chunkPosition);
     m_chunkWorldCoords[0] = m_chunkPosition[0] * constants::CHUNK_SIZE;
@@ -48,8 +50,8 @@ MeshBuilder::MeshBuilder(
 
 void MeshBuilder::addFaceToMesh(uint32_t block, int blockType, int faceNum)
 {
-    BlockData blockData = m_serverWorld.getResourcePack().getBlockData(blockType);
-    Face faceData = blockData.model->faces[faceNum];
+    const BlockData& blockData = m_serverWorld.getResourcePack().getBlockData(blockType);
+    const Face& faceData = blockData.model->faces[faceNum];
     int blockCoords[3];
     int lightingBlockPos[3];
     int worldBlockPos[3];
@@ -62,9 +64,7 @@ void MeshBuilder::addFaceToMesh(uint32_t block, int blockType, int faceNum)
     worldBlockPos[2] = m_chunkWorldCoords[2] + blockCoords[2];
     if (blockType == 4)
     {
-        float texCoords[8];
-        ResourcePack::getTextureCoordinates(
-            texCoords, faceData.UVcoords, blockData.faceTextureIndices[faceNum]);
+        const float* texCoords = &blockData.faceTextureCoordinates[faceNum * 8];
         for (int vertex = 0; vertex < 4; vertex++)
         {
             for (int element = 0; element < 3; element++)
@@ -94,10 +94,7 @@ void MeshBuilder::addFaceToMesh(uint32_t block, int blockType, int faceNum)
     }
     else
     {
-        float texCoords[8];
-        ResourcePack::getTextureCoordinates(
-            texCoords, faceData.UVcoords, blockData.faceTextureIndices[faceNum]
-        );
+        const float* texCoords = &blockData.faceTextureCoordinates[faceNum * 8];
         for (int vertex = 0; vertex < 4; vertex++)
         {
             for (int element = 0; element < 3; element++)
@@ -144,12 +141,11 @@ void MeshBuilder::addFaceToMesh(uint32_t block, int blockType, int faceNum)
     }
 }
 
-float MeshBuilder::getSmoothSkyLight(int* blockCoords, float* pointCoords, int direction)
+float MeshBuilder::getSmoothSkyLight(int* blockCoords, const float* pointCoords, int direction)
 {
     if (direction == 6)
     {
-        return static_cast<float>(m_serverWorld.chunkManager.getSkyLight(blockCoords))
-            / constants::skyLightMaxValue;
+        return static_cast<float>(m_cursor.getSkyLight(blockCoords)) / constants::skyLightMaxValue;
     }
     else
     {
@@ -179,14 +175,13 @@ float MeshBuilder::getSmoothSkyLight(int* blockCoords, float* pointCoords, int d
         {
             testBlockCoords[unfixed1] = blockCoords[unfixed1] + mask1[i] * cornerOffset[unfixed1];
             testBlockCoords[unfixed2] = blockCoords[unfixed2] + mask2[i] * cornerOffset[unfixed2];
-            bool transparrentBlock = m_serverWorld.getResourcePack().getBlockData(
-                m_serverWorld.chunkManager.getBlock(testBlockCoords)).transparent;
-            int cornerBrightness = m_serverWorld.chunkManager.getSkyLight(testBlockCoords)
-                * transparrentBlock;
-            testBlockCoords[fixed] += normalDirection;
+            m_cursor.moveTo(testBlockCoords);
+            bool transparrentBlock = m_serverWorld.getResourcePack().isTransparent(
+                m_cursor.getBlock());
+            int cornerBrightness = m_cursor.getSkyLight() * transparrentBlock;
+            m_cursor.move(fixed, normalDirection);
             inShadow |= transparrentBlock && cornerBrightness < constants::skyLightMaxValue
-                && m_serverWorld.chunkManager.getSkyLight(testBlockCoords) <= cornerBrightness;
-            testBlockCoords[fixed] -= normalDirection;
+                && m_cursor.getSkyLight() <= cornerBrightness;
             brightness += cornerBrightness;
             numTransparrentBlocks += transparrentBlock;
             numEdgesBlocked += !transparrentBlock * edges[i];
@@ -198,11 +193,11 @@ float MeshBuilder::getSmoothSkyLight(int* blockCoords, float* pointCoords, int d
     }
 }
 
-float MeshBuilder::getSmoothBlockLight(int* blockCoords, float* pointCoords, int direction)
+float MeshBuilder::getSmoothBlockLight(int* blockCoords, const float* pointCoords, int direction)
 {
     if (direction == 6)
     {
-        return static_cast<float>(m_serverWorld.chunkManager.getBlockLight(blockCoords))
+        return static_cast<float>(m_cursor.getBlockLight(blockCoords))
             / constants::blockLightMaxValue;
     }
     else
@@ -233,14 +228,13 @@ float MeshBuilder::getSmoothBlockLight(int* blockCoords, float* pointCoords, int
         {
             testBlockCoords[unfixed1] = blockCoords[unfixed1] + mask1[i] * cornerOffset[unfixed1];
             testBlockCoords[unfixed2] = blockCoords[unfixed2] + mask2[i] * cornerOffset[unfixed2];
-            bool transparrentBlock = m_serverWorld.getResourcePack().getBlockData(
-                m_serverWorld.chunkManager.getBlock(testBlockCoords)).transparent;
-            int cornerBrightness = m_serverWorld.chunkManager.getBlockLight(testBlockCoords)
-                * transparrentBlock;
-            testBlockCoords[fixed] += normalDirection;
+            m_cursor.moveTo(testBlockCoords);
+            bool transparrentBlock = m_serverWorld.getResourcePack().isTransparent(
+                m_cursor.getBlock());
+            int cornerBrightness = m_cursor.getBlockLight() * transparrentBlock;
+            m_cursor.move(fixed, normalDirection);
             inShadow |= transparrentBlock && cornerBrightness < constants::blockLightMaxValue
-                && m_serverWorld.chunkManager.getBlockLight(testBlockCoords) <= cornerBrightness;
-            testBlockCoords[fixed] -= normalDirection;
+                && m_cursor.getBlockLight() <= cornerBrightness;
             brightness += cornerBrightness;
             numTransparrentBlocks += transparrentBlock;
             numEdgesBlocked += !transparrentBlock * edges[i];
@@ -252,7 +246,7 @@ float MeshBuilder::getSmoothBlockLight(int* blockCoords, float* pointCoords, int
     }
 }
 
-float MeshBuilder::getAmbientOcclusion(int* blockCoords, float* pointCoords, int direction)
+float MeshBuilder::getAmbientOcclusion(int* blockCoords, const float* pointCoords, int direction)
 {
     if (direction == 6)
     {
@@ -282,9 +276,9 @@ float MeshBuilder::getAmbientOcclusion(int* blockCoords, float* pointCoords, int
         {
             testBlockCoords[unfixed1] = blockCoords[unfixed1] + mask1[i] * cornerOffset[unfixed1];
             testBlockCoords[unfixed2] = blockCoords[unfixed2] + mask2[i] * cornerOffset[unfixed2];
-            bool occluder = m_serverWorld.getResourcePack().getBlockData(
-                m_serverWorld.chunkManager.getBlock(testBlockCoords)
-            ).castsAmbientOcclusion;
+            bool occluder = m_serverWorld.getResourcePack().castsAmbientOcclusion(
+                m_cursor.getBlock(testBlockCoords)
+            );
             bool corner = corners[i];
             numSideOccluders += occluder * (1 - corner);
             numCornerOccluders += occluder * (corner);
@@ -297,11 +291,13 @@ float MeshBuilder::getAmbientOcclusion(int* blockCoords, float* pointCoords, int
 
 void MeshBuilder::buildMesh()
 {
+    PROFILE_ZONE("Build chunk mesh");
     m_vertices.clear();
     m_indices.clear();
     m_waterVertices.clear();
     m_waterIndices.clear();
 
+    const ResourcePack& resourcePack = m_serverWorld.getResourcePack();
     int chunkPosition[3];
     m_chunk.getPosition(chunkPosition);
     int blockPos[3];
@@ -331,19 +327,18 @@ void MeshBuilder::buildMesh()
                     blockNum++;
                     continue;
                 }
+                const std::vector<Face>& faces = resourcePack.getBlockData(blockType).model->faces;
                 if (blockType == 4)
                 {
-                    for (int faceNum = 0; faceNum < m_serverWorld.getResourcePack().
-                        getBlockData(blockType).model->faces.size(); faceNum++)
+                    for (int faceNum = 0; faceNum < static_cast<int>(faces.size()); faceNum++)
                     {
-                        int cullFace = m_serverWorld.getResourcePack().getBlockData(blockType).
-                            model->faces[faceNum].cullFace;
+                        int cullFace = faces[faceNum].cullFace;
                         neighbouringBlockPos[0] = blockPos[0] + s_neighbouringBlocksX[cullFace];
                         neighbouringBlockPos[1] = blockPos[1] + s_neighbouringBlocksY[cullFace];
                         neighbouringBlockPos[2] = blockPos[2] + s_neighbouringBlocksZ[cullFace];
-                        int neighbouringBlockType = m_serverWorld.chunkManager.getBlock(neighbouringBlockPos);
-                        if ((neighbouringBlockType != 4) && (m_serverWorld.getResourcePack().
-                            getBlockData(neighbouringBlockType).transparent))
+                        int neighbouringBlockType = m_cursor.getBlock(neighbouringBlockPos);
+                        if (neighbouringBlockType != 4
+                            && resourcePack.isTransparent(neighbouringBlockType))
                         {
                             addFaceToMesh(blockNum, blockType, faceNum);
                         }
@@ -351,26 +346,33 @@ void MeshBuilder::buildMesh()
                 }
                 else
                 {
-                    auto& blockData = m_serverWorld.getResourcePack().getBlockData(blockType);
-                    for (int faceNum = 0; faceNum < m_serverWorld.getResourcePack().
-                        getBlockData(blockType).model->faces.size(); faceNum++)
+                    // Look up each neighbour that the block's faces can be culled by once,
+                    // rather than once per face
+                    uint8_t cullMask = resourcePack.getCullMask(blockType);
+                    uint8_t visibleDirections = 0;
+                    for (int direction = 0; direction < 6; direction++)
                     {
-                        int cullFace = m_serverWorld.getResourcePack().getBlockData(blockType).
-                            model->faces.at(faceNum).cullFace;
-                        if (cullFace < 0)
+                        if (!(cullMask & (1 << direction)))
+                            continue;
+                        neighbouringBlockPos[0] = blockPos[0] + s_neighbouringBlocksX[direction];
+                        neighbouringBlockPos[1] = blockPos[1] + s_neighbouringBlocksY[direction];
+                        neighbouringBlockPos[2] = blockPos[2] + s_neighbouringBlocksZ[direction];
+                        visibleDirections |= resourcePack.isTransparent(
+                            m_cursor.getBlock(neighbouringBlockPos)
+                        ) << direction;
+                    }
+
+                    // Every face of a full cube is culled when all of its neighbours are opaque
+                    if (resourcePack.isFullCube(blockType) && visibleDirections == 0)
+                    {
+                        blockNum++;
+                        continue;
+                    }
+                    for (int faceNum = 0; faceNum < static_cast<int>(faces.size()); faceNum++)
+                    {
+                        int cullFace = faces[faceNum].cullFace;
+                        if (cullFace < 0 || visibleDirections & (1 << cullFace))
                             addFaceToMesh(blockNum, blockType, faceNum);
-                        else
-                        {
-                            neighbouringBlockPos[0] = blockPos[0] + s_neighbouringBlocksX[cullFace];
-                            neighbouringBlockPos[1] = blockPos[1] + s_neighbouringBlocksY[cullFace];
-                            neighbouringBlockPos[2] = blockPos[2] + s_neighbouringBlocksZ[cullFace];
-                            // TODO: investigate splitting up the line below into multiple lines of code (causes bugs)
-                            if (cullFace < 0 || m_serverWorld.getResourcePack().getBlockData(
-                                m_serverWorld.chunkManager.getBlock(neighbouringBlockPos)).transparent)
-                            {
-                                addFaceToMesh(blockNum, blockType, faceNum);
-                            }
-                        }
                     }
                 }
                 blockNum++;
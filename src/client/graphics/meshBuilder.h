@@ -24,9 +24,12 @@
 #include "core/constants.h"
 #include "core/resourcePack.h"
 #include "core/serverWorld.h"
+#include "core/worldCursor.h"
 
 namespace lonelycube::client {
 
+// Reads the chunk's neighbours through a WorldCursor, so it must only be used while
+// chunkManager.mutex is held
 class MeshBuilder {
 private:
     Chunk& m_chunk;
@@ -37,16 +40,18 @@ private:
     std::vector<uint32_t>& m_waterIndices;
     int m_chunkPosition[3];
     int m_chunkWorldCoords[3];
+    // Reads the blocks around the chunk, which can't be unloaded while it is being meshed
+    WorldCursor m_cursor;
 
     static const int s_neighbouringBlocksX[7];
     static const int s_neighbouringBlocksY[7];
     static const int s_neighbouringBlocksZ[7];
 
-    float getAmbientOcclusion(int* blockCoords, float* pointCoords, int direction);
+    float getAmbientOcclusion(int* blockCoords, const float* pointCoords, int direction);
 
-    float getSmoothSkyLight(int* blockCoords, float* pointCoords, int direction);
+    float getSmoothSkyLight(int* blockCoords, const float* pointCoords, int direction);
 
-    float getSmoothBlockLight(int* blockCoords, float* pointCoords, int direction);
+    float getSmoothBlockLight(int* blockCoords, const float* pointCoords, int direction);
 
     void addFaceToMesh(uint32_t block, int blockType, int faceNum);
 
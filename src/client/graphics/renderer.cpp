@@ -20,6 +20,7 @@
 
 #include "client/graphics/vulkan/vulkanEngine.h"
 
+#include "client/graphics/textureCache.h"
 #include "client/graphics/vulkan/images.h"
 #include "client/graphics/vulkan/pipelines.h"
 #include "client/graphics/vulkan/shaders.h"
@@ -30,11 +31,14 @@
 
 namespace lonelycube::client {
 
-Renderer::Renderer(VkSampleCountFlagBits numSamples, float renderScale) :
-    m_renderScale(renderScale), m_minimised(false), m_autoExposure(m_vulkanEngine),
-    m_bloom(m_vulkanEngine), font(m_vulkanEngine), menuRenderer(m_vulkanEngine, font)
+Renderer::Renderer(VkSampleCountFlagBits numSamples, float renderScale, bool headless) :
+    m_renderScale(renderScale), m_minimised(false), m_gpuProfiler(m_vulkanEngine),
+    m_autoExposure(m_vulkanEngine), m_bloom(m_vulkanEngine, m_gpuProfiler), font(m_vulkanEngine),
+    menuRenderer(m_vulkanEngine, font)
 {
-    m_vulkanEngine.init();
+    auto startTime = std::chrono::steady_clock::now();
+    m_vulkanEngine.init(headless);
+    m_gpuProfiler.init();
 
     std::vector<DescriptorAllocatorGrowable::PoolSizeRatio> sizes =
     {
@@ -65,6 +69,12 @@ Renderer::Renderer(VkSampleCountFlagBits numSamples, float renderScale) :
         m_globalDescriptorAllocator, m_uiPipelineLayout, m_uiImageDescriptorLayout,
         { m_vulkanEngine.getSwapchainExtent().width, m_vulkanEngine.getSwapchainExtent().height }
     );
+
+    double startupTime = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime
+    ).count();
+    std::cout << "Renderer started in " << startupTime << "ms with a "
+        << (m_vulkanEngine.isPipelineCacheWarm() ? "warm" : "cold") << " pipeline cache\n";
 }
 
 Renderer::~Renderer()
@@ -82,6 +92,7 @@ Renderer::~Renderer()
     cleanupTextures();
     cleanupSamplers();
     m_globalDescriptorAllocator.destroyPools(m_vulkanEngine.getDevice());
+    m_gpuProfiler.cleanup();
 
     m_vulkanEngine.cleanup();
 }
@@ -134,31 +145,17 @@ void Renderer::cleanupRenderImages()
 
 void Renderer::loadTextures()
 {
-    glm::ivec2 size;
-    int channels;
-    uint8_t* buffer = stbi_load("res/resourcePack/textures.png", &size.x, &size.y, &channels, 4);
-    VkExtent3D extent { static_cast<uint32_t>(size.x), static_cast<uint32_t>(size.y), 1 };
-    m_worldTextures = m_vulkanEngine.createImage(
-        buffer, extent, 4, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_USAGE_SAMPLED_BIT, 5
+    m_worldTextures = loadCachedTexture(
+        m_vulkanEngine, "res/resourcePack/textures.png", 4, VK_FORMAT_R8G8B8A8_SRGB, 5
     );
-    stbi_image_free(buffer);
-
-    buffer = stbi_load("res/resourcePack/gui/crosshair.png", &size.x, &size.y, &channels, 1);
-    extent = { static_cast<uint32_t>(size.x), static_cast<uint32_t>(size.y), 1 };
-    m_crosshairTexture = m_vulkanEngine.createImage(
-        buffer, extent, 1, VK_FORMAT_R8_UNORM, VK_IMAGE_USAGE_SAMPLED_BIT
+    m_crosshairTexture = loadCachedTexture(
+        m_vulkanEngine, "res/resourcePack/gui/crosshair.png", 1, VK_FORMAT_R8_UNORM
     );
-    stbi_image_free(buffer);
-
-    buffer = stbi_load(
-        "res/resourcePack/gui/startMenuBackground.png", &size.x, &size.y, &channels, 4
+    // 0 mip levels for a full mip chain
+    m_startMenuBackgroundTexture = loadCachedTexture(
+        m_vulkanEngine, "res/resourcePack/gui/startMenuBackground.png", 4,
+        VK_FORMAT_R8G8B8A8_SRGB, 0
     );
-    extent = { static_cast<uint32_t>(size.x), static_cast<uint32_t>(size.y), 1 };
-    uint32_t mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(size.x, size.y)))) + 1;
-    m_startMenuBackgroundTexture = m_vulkanEngine.createImage(
-        buffer, extent, 4, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_USAGE_SAMPLED_BIT, mipLevels
-    );
-    stbi_image_free(buffer);
 }
 
 void Renderer::cleanupTextures()
@@ -458,8 +455,8 @@ void Renderer::createSkyPipeline()
     skyPipelineCreateInfo.stage = stageInfo;
 
     VK_CHECK(vkCreateComputePipelines(
-        m_vulkanEngine.getDevice(), VK_NULL_HANDLE, 1, &skyPipelineCreateInfo, nullptr,
-        &m_skyPipeline
+        m_vulkanEngine.getDevice(), m_vulkanEngine.getPipelineCache(), 1, &skyPipelineCreateInfo,
+        nullptr, &m_skyPipeline
     ));
 
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), computeDrawShader, nullptr);
@@ -515,7 +512,9 @@ void Renderer::createSkyBlitPipeline()
         pipelineBuilder.setMultisampling(m_numSamples);
     }
 
-    m_skyCopyPipeline = pipelineBuilder.buildPipeline(m_vulkanEngine.getDevice());
+    m_skyCopyPipeline = pipelineBuilder.buildPipeline(
+        m_vulkanEngine.getDevice(), m_vulkanEngine.getPipelineCache()
+    );
 
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), fullscreenVertexShader, nullptr);
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), blitFragmentShader, nullptr);
@@ -530,7 +529,7 @@ void Renderer::cleanupSkyBlitPipeline()
 void Renderer::createWorldPipelines()
 {
     VkPushConstantRange bufferRange{};
-    bufferRange.size = sizeof(BlockPushConstants);
+    bufferRange.size = std::max(sizeof(BlockPushConstants), sizeof(EntityPushConstants));
     bufferRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
@@ -556,6 +555,12 @@ void Renderer::createWorldPipelines()
     ) {
         LOG("Failed to find shader \"res/shaders/block.frag.spv\"");
     }
+    VkShaderModule entityVertexShader;
+    if (!createShaderModule(
+        m_vulkanEngine.getDevice(), "res/shaders/entity.vert.spv", entityVertexShader)
+    ) {
+        LOG("Failed to find shader \"res/shaders/entity.vert.spv\"");
+    }
     VkShaderModule waterVertexShader;
     if (!createShaderModule(
         m_vulkanEngine.getDevice(), "res/shaders/water.vert.spv", waterVertexShader)
@@ -589,17 +594,28 @@ void Renderer::createWorldPipelines()
         pipelineBuilder.setMultisampling(m_numSamples);
     }
 
-    m_blockPipeline = pipelineBuilder.buildPipeline(m_vulkanEngine.getDevice());
+    m_blockPipeline = pipelineBuilder.buildPipeline(
+        m_vulkanEngine.getDevice(), m_vulkanEngine.getPipelineCache()
+    );
+
+    pipelineBuilder.setShaders(entityVertexShader, blockFragmentShader);
+
+    m_entityPipeline = pipelineBuilder.buildPipeline(
+        m_vulkanEngine.getDevice(), m_vulkanEngine.getPipelineCache()
+    );
 
     pipelineBuilder.setShaders(waterVertexShader, waterFragmentShader);
     pipelineBuilder.setCullMode(VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE);
     pipelineBuilder.enableAlphaBlending();
     pipelineBuilder.enableDepthTest(false, VK_COMPARE_OP_GREATER_OR_EQUAL);
 
-    m_waterPipeline = pipelineBuilder.buildPipeline(m_vulkanEngine.getDevice());
+    m_waterPipeline = pipelineBuilder.buildPipeline(
+        m_vulkanEngine.getDevice(), m_vulkanEngine.getPipelineCache()
+    );
 
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), blockVertexShader, nullptr);
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), blockFragmentShader, nullptr);
+    vkDestroyShaderModule(m_vulkanEngine.getDevice(), entityVertexShader, nullptr);
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), waterVertexShader, nullptr);
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), waterFragmentShader, nullptr);
 }
@@ -607,6 +623,7 @@ void Renderer::createWorldPipelines()
 void Renderer::cleanupWorldPipelines()
 {
     vkDestroyPipeline(m_vulkanEngine.getDevice(), m_blockPipeline, nullptr);
+    vkDestroyPipeline(m_vulkanEngine.getDevice(), m_entityPipeline, nullptr);
     vkDestroyPipeline(m_vulkanEngine.getDevice(), m_waterPipeline, nullptr);
     vkDestroyPipelineLayout(m_vulkanEngine.getDevice(), m_worldPipelineLayout, nullptr);
 }
@@ -659,7 +676,9 @@ void Renderer::createBlockOutlinePipeline()
         pipelineBuilder.setMultisampling(m_numSamples);
     }
 
-    m_blockOutlinePipeline = pipelineBuilder.buildPipeline(m_vulkanEngine.getDevice());
+    m_blockOutlinePipeline = pipelineBuilder.buildPipeline(
+        m_vulkanEngine.getDevice(), m_vulkanEngine.getPipelineCache()
+    );
 
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), vertexShader, nullptr);
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), fragmentShader, nullptr);
@@ -713,7 +732,9 @@ void Renderer::createToneMapPipeline()
     pipelineBuilder.setColourAttachmentFormat(m_vulkanEngine.getSwapchainImageFormat());
     pipelineBuilder.setDepthAttachmentFormat(VK_FORMAT_UNDEFINED);
 
-    m_toneMapPipeline = pipelineBuilder.buildPipeline(m_vulkanEngine.getDevice());
+    m_toneMapPipeline = pipelineBuilder.buildPipeline(
+        m_vulkanEngine.getDevice(), m_vulkanEngine.getPipelineCache()
+    );
 
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), fullscreenVertexShader, nullptr);
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), toneMapFragmentShader, nullptr);
@@ -803,7 +824,9 @@ void Renderer::createCrosshairPipeline()
     pipelineBuilder.setColourAttachmentFormat(m_vulkanEngine.getSwapchainImageFormat());
     pipelineBuilder.setDepthAttachmentFormat(VK_FORMAT_UNDEFINED);
 
-    m_crosshairPipeline = pipelineBuilder.buildPipeline(m_vulkanEngine.getDevice());
+    m_crosshairPipeline = pipelineBuilder.buildPipeline(
+        m_vulkanEngine.getDevice(), m_vulkanEngine.getPipelineCache()
+    );
 
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), crosshairVertexShader, nullptr);
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), crosshairFragmentShader, nullptr);
@@ -860,7 +883,9 @@ void Renderer::createFullscreenBlitPipeline()
     pipelineBuilder.setColourAttachmentFormat(m_vulkanEngine.getSwapchainImageFormat());
     pipelineBuilder.setDepthAttachmentFormat(VK_FORMAT_UNDEFINED);
 
-    m_fullscreenBlitPipeline = pipelineBuilder.buildPipeline(m_vulkanEngine.getDevice());
+    m_fullscreenBlitPipeline = pipelineBuilder.buildPipeline(
+        m_vulkanEngine.getDevice(), m_vulkanEngine.getPipelineCache()
+    );
 
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), fullscreenVertexShader, nullptr);
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), blitFragmentShader, nullptr);
@@ -911,13 +936,8 @@ bool Renderer::beginRenderingFrame()
     beginInfo.pInheritanceInfo = nullptr;
 
     VK_CHECK(vkBeginCommandBuffer(command, &beginInfo));
-    #ifdef TIMESTAMPS
-    vkCmdResetQueryPool(
-        command, m_vulkanEngine.getCurrentTimestampQueryPool(), 0,
-        static_cast<uint32_t>(m_vulkanEngine.getTimestamps().size())
-    );
-    LOG(std::to_string(m_vulkanEngine.getDeltaTimestamp(0, 1)));
-    #endif
+    m_gpuProfiler.beginFrame();
+    m_gpuProfiler.beginPass(GpuPass::Frame);
 
     return true;
 }
@@ -927,6 +947,8 @@ void Renderer::drawSky()
     FrameData& currentFrameData = m_vulkanEngine.getCurrentFrameData();
     VkCommandBuffer command = currentFrameData.commandBuffer;
 
+    m_gpuProfiler.beginPass(GpuPass::Sky);
+
     transitionImage(
         command, m_skyImage.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
         VK_PIPELINE_STAGE_NONE, VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
@@ -966,16 +988,18 @@ void Renderer::drawSky()
         VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_MEMORY_WRITE_BIT,
         VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_MEMORY_READ_BIT
     );
+
+    m_gpuProfiler.endPass(GpuPass::Sky);
 }
 
-void Renderer::updateEntityMesh(
-    const EntityMeshManager& entityMeshManager, GPUDynamicMeshBuffers& mesh
+void Renderer::updateEntityInstances(
+    const EntityMeshManager& entityMeshManager, GPUDynamicBuffer& instances
 ) {
     FrameData& currentFrameData = m_vulkanEngine.getCurrentFrameData();
     VkCommandBuffer command = currentFrameData.commandBuffer;
 
-    m_vulkanEngine.updateDynamicMesh(
-        command, mesh, entityMeshManager.sizeOfVertices, entityMeshManager.numIndices
+    m_vulkanEngine.updateDynamicBuffer(
+        command, instances, entityMeshManager.numInstances * sizeof(EntityInstance)
     );
 }
 
@@ -1100,20 +1124,38 @@ void Renderer::drawBlocks(const GPUMeshBuffers& mesh)
     vkCmdDrawIndexed(command, mesh.indexCount, 1, 0, 0, 0);
 }
 
-void Renderer::drawEntities(GPUDynamicMeshBuffers& mesh)
-{
+void Renderer::drawEntities(
+    const EntityMeshManager& entityMeshManager, const GPUMeshBuffers& modelMesh,
+    const GPUDynamicBuffer& instances
+) {
+    if (entityMeshManager.numInstances == 0)
+        return;
+
     FrameData& currentFrameData = getVulkanEngine().getCurrentFrameData();
     VkCommandBuffer command = currentFrameData.commandBuffer;
 
-    blockRenderInfo.vertexBuffer = mesh.vertexBufferAddress;
+    vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_GRAPHICS, m_entityPipeline);
+
+    EntityPushConstants pushConstants;
+    pushConstants.mvp = blockRenderInfo.mvp;
+    pushConstants.playerSubBlockPos = blockRenderInfo.playerSubBlockPos;
+    pushConstants.renderDistance = blockRenderInfo.renderDistance;
+    pushConstants.skyLightIntensity = blockRenderInfo.skyLightIntensity;
+    pushConstants.vertexBuffer = modelMesh.vertexBufferAddress;
+    pushConstants.instanceBuffer = instances.bufferAddress;
     vkCmdPushConstants(
-        command, m_worldPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(BlockPushConstants),
-        &blockRenderInfo
-    );
-    vkCmdBindIndexBuffer(
-        command, mesh.indexBuffer.deviceLocalBuffer.buffer, 0, VK_INDEX_TYPE_UINT32
+        command, m_worldPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0,
+        sizeof(EntityPushConstants), &pushConstants
     );
-    vkCmdDrawIndexed(command, mesh.indexCount, 1, 0, 0, 0);
+    vkCmdBindIndexBuffer(command, modelMesh.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+    for (const EntityDraw& draw : entityMeshManager.draws)
+    {
+        const EntityModelMesh& mesh = entityMeshManager.getModelMesh(draw.blockType);
+        vkCmdDrawIndexed(
+            command, mesh.indexCount, draw.instanceCount, mesh.firstIndex, mesh.vertexOffset,
+            draw.firstInstance
+        );
+    }
 }
 
 void Renderer::drawBlockOutline(glm::mat4& viewProjection, glm::vec3& offset, float* outlineModel)
@@ -1177,7 +1219,9 @@ void Renderer::calculateAutoExposure(double DT)
         static_cast<float>(m_drawImageExtent.width) / m_drawImageExtent.width,
          static_cast<float>(m_drawImageExtent.height) / m_drawImageExtent.height
     );
+    m_gpuProfiler.beginPass(GpuPass::AutoExposure);
     m_autoExposure.calculate(renderAreaFraction, DT);
+    m_gpuProfiler.endPass(GpuPass::AutoExposure);
 }
 
 void Renderer::beginRenderingToSwapchainImage()
@@ -1213,6 +1257,8 @@ void Renderer::applyToneMap()
     FrameData& currentFrameData = m_vulkanEngine.getCurrentFrameData();
     VkCommandBuffer command = currentFrameData.commandBuffer;
 
+    m_gpuProfiler.beginPass(GpuPass::ToneMap);
+
     vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_GRAPHICS, m_toneMapPipeline);
 
     VkViewport viewport{};
@@ -1239,6 +1285,8 @@ void Renderer::applyToneMap()
         sizeof(ToneMapPushConstants), &m_toneMapPushConstants
     );
     vkCmdDraw(command, 3, 1, 0, 0);
+
+    m_gpuProfiler.endPass(GpuPass::ToneMap);
 }
 
 void Renderer::drawCrosshair()
@@ -1330,6 +1378,8 @@ void Renderer::beginDrawingUi()
     FrameData& currentFrameData = m_vulkanEngine.getCurrentFrameData();
     VkCommandBuffer command = currentFrameData.commandBuffer;
 
+    m_gpuProfiler.beginPass(GpuPass::Ui);
+
     vkCmdBindDescriptorSets(
         command, VK_PIPELINE_BIND_POINT_GRAPHICS, m_uiPipelineLayout, 0, 1, &m_uiSamplerDescriptors,
         0, nullptr
@@ -1341,15 +1391,20 @@ void Renderer::submitFrame()
     FrameData& currentFrameData = m_vulkanEngine.getCurrentFrameData();
     VkCommandBuffer command = currentFrameData.commandBuffer;
 
+    m_gpuProfiler.endPass(GpuPass::Ui);
     vkCmdEndRendering(command);
 
+    // Offscreen images are never presented, so leave them ready to be copied from instead
+    VkImageLayout finalLayout = m_vulkanEngine.isHeadless() ?
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
     transitionImage(
         command, m_vulkanEngine.getCurrentSwapchainImage(), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-        VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+        finalLayout, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
         VK_ACCESS_2_MEMORY_WRITE_BIT, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
         VK_ACCESS_2_MEMORY_READ_BIT
     );
 
+    m_gpuProfiler.endPass(GpuPass::Frame);
     VK_CHECK(vkEndCommandBuffer(command));
     m_vulkanEngine.submitFrame();
 }
@@ -24,6 +24,7 @@
 #include "client/graphics/entityMeshManager.h"
 #include "client/graphics/autoExposure.h"
 #include "client/graphics/bloom.h"
+#include "client/graphics/gpuProfiler.h"
 #include "client/graphics/vulkan/vulkanEngine.h"
 #include "client/graphics/vulkan/descriptors.h"
 #include "client/gui/font.h"
@@ -51,6 +52,16 @@ struct BlockPushConstants
     VkDeviceAddress vertexBuffer;
 };
 
+struct EntityPushConstants
+{
+    glm::mat4 mvp;
+    glm::vec3 playerSubBlockPos;
+    float renderDistance;
+    float skyLightIntensity;
+    VkDeviceAddress vertexBuffer;
+    VkDeviceAddress instanceBuffer;
+};
+
 struct ToneMapPushConstants
 {
     glm::vec2 drawImageTexelSize;
@@ -72,16 +83,21 @@ public:
     Font font;
     MenuRenderer menuRenderer;
 
-    Renderer(VkSampleCountFlagBits numSamples, float renderScale);
+    Renderer(VkSampleCountFlagBits numSamples, float renderScale, bool headless = false);
     ~Renderer();
     bool beginRenderingFrame();
     void drawSky();
-    void updateEntityMesh(const EntityMeshManager& entityMeshManager, GPUDynamicMeshBuffers& mesh);
+    void updateEntityInstances(
+        const EntityMeshManager& entityMeshManager, GPUDynamicBuffer& instances
+    );
     void beginDrawingGeometry();
     void blitSky();
     void beginDrawingBlocks();
     void drawBlocks(const GPUMeshBuffers& mesh);
-    void drawEntities(GPUDynamicMeshBuffers& mesh);
+    void drawEntities(
+        const EntityMeshManager& entityMeshManager, const GPUMeshBuffers& modelMesh,
+        const GPUDynamicBuffer& instances
+    );
     void beginDrawingWater();
     void drawBlockOutline(glm::mat4& viewProjection, glm::vec3& offset, float* outlineModel);
     void finishDrawingGeometry();
@@ -100,6 +116,10 @@ public:
     {
         return m_vulkanEngine;
     }
+    inline GpuProfiler& getGpuProfiler()
+    {
+        return m_gpuProfiler;
+    }
     inline bool isMinimised()
     {
         return m_minimised;
@@ -147,11 +167,13 @@ private:
     VkDescriptorSet m_worldTexturesDescriptors;
     VkPipelineLayout m_worldPipelineLayout;
     VkPipeline m_blockPipeline;
+    VkPipeline m_entityPipeline;
     VkPipeline m_waterPipeline;
 
     VkPipelineLayout m_blockOutlinePipelineLayout;
     VkPipeline m_blockOutlinePipeline;
 
+    GpuProfiler m_gpuProfiler;
     AutoExposure m_autoExposure;
     Bloom m_bloom;
 
@@ -0,0 +1,179 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "client/graphics/textureCache.h"
+
+#include "core/pch.h"
+
+#include "stb_image.h"
+#include "stb_image_resize2.h"
+
+#include "core/log.h"
+#include "core/resourceCache.h"
+
+namespace lonelycube::client {
+
+static constexpr uint32_t CACHE_MAGIC = 0x58544c43;  // "CLTX"
+static constexpr uint32_t CACHE_VERSION = 1;
+static const std::filesystem::path s_cacheDirectory = "res/cache/textures";
+
+static std::filesystem::path getCachePath(const std::filesystem::path& imagePath)
+{
+    // Include the image's folders in the name so that images with the same name don't share a
+    // cache
+    std::string name = imagePath.lexically_normal().generic_string();
+    std::replace(name.begin(), name.end(), '/', '_');
+    return s_cacheDirectory/(name + ".bin");
+}
+
+static VkExtent3D getMipSize(VkExtent3D size)
+{
+    return { std::max(size.width / 2, 1u), std::max(size.height / 2, 1u), 1 };
+}
+
+static size_t getMipDataSize(VkExtent3D size, int channels)
+{
+    return static_cast<size_t>(size.width) * size.height * channels;
+}
+
+// Returns a pointer to each mip of a mip chain stored one mip after another
+static std::vector<const void*> getMipData(
+    const uint8_t* mipChain, VkExtent3D size, int channels, uint32_t mipLevels
+) {
+    std::vector<const void*> mipData;
+    for (uint32_t mipLevel = 0; mipLevel < mipLevels; mipLevel++)
+    {
+        mipData.push_back(mipChain);
+        mipChain += getMipDataSize(size, channels);
+        size = getMipSize(size);
+    }
+    return mipData;
+}
+
+static size_t getMipChainSize(VkExtent3D size, int channels, uint32_t mipLevels)
+{
+    size_t mipChainSize = 0;
+    for (uint32_t mipLevel = 0; mipLevel < mipLevels; mipLevel++)
+    {
+        mipChainSize += getMipDataSize(size, channels);
+        size = getMipSize(size);
+    }
+    return mipChainSize;
+}
+
+static bool decodeTexture(
+    const std::filesystem::path& imagePath, int channels, VkExtent3D& size, uint32_t& mipLevels,
+    std::vector<uint8_t>& mipChain
+) {
+    int width, height, fileChannels;
+    uint8_t* pixels = stbi_load(
+        imagePath.string().c_str(), &width, &height, &fileChannels, channels
+    );
+    if (pixels == nullptr)
+    {
+        LOG("Failed to load " + imagePath.string());
+        return false;
+    }
+
+    size = { static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1 };
+    if (mipLevels == 0)
+    {
+        mipLevels = static_cast<uint32_t>(
+            std::floor(std::log2(std::max(width, height)))
+        ) + 1;
+    }
+
+    mipChain.resize(getMipChainSize(size, channels, mipLevels));
+    std::memcpy(mipChain.data(), pixels, getMipDataSize(size, channels));
+    stbi_image_free(pixels);
+
+    // Each mip is resized from the one before it
+    stbir_pixel_layout pixelLayout = channels == 4 ? STBIR_RGBA : STBIR_1CHANNEL;
+    uint8_t* mip = mipChain.data();
+    VkExtent3D mipSize = size;
+    for (uint32_t mipLevel = 1; mipLevel < mipLevels; mipLevel++)
+    {
+        uint8_t* nextMip = mip + getMipDataSize(mipSize, channels);
+        VkExtent3D nextMipSize = getMipSize(mipSize);
+        stbir_resize_uint8_srgb(
+            mip, mipSize.width, mipSize.height, 0, nextMip, nextMipSize.width,
+            nextMipSize.height, 0, pixelLayout
+        );
+        mip = nextMip;
+        mipSize = nextMipSize;
+    }
+    return true;
+}
+
+AllocatedImage loadCachedTexture(
+    VulkanEngine& vulkanEngine, const std::filesystem::path& imagePath, int channels,
+    VkFormat format, uint32_t mipLevels
+) {
+    std::filesystem::path cachePath = getCachePath(imagePath);
+    VkExtent3D size;
+    {
+        ResourceCacheReader reader;
+        if (reader.open(cachePath, CACHE_MAGIC, CACHE_VERSION, { imagePath }))
+        {
+            size = { reader.read<uint32_t>(), reader.read<uint32_t>(), 1 };
+            uint32_t cachedChannels = reader.read<uint32_t>();
+            uint32_t cachedMipLevels = reader.read<uint32_t>();
+            if (cachedChannels == static_cast<uint32_t>(channels) && cachedMipLevels > 0
+                && cachedMipLevels <= 32 && (mipLevels == 0 || cachedMipLevels == mipLevels))
+            {
+                const uint8_t* mipChain = reader.readBytes(
+                    getMipChainSize(size, channels, cachedMipLevels)
+                );
+                if (mipChain != nullptr)
+                {
+                    return vulkanEngine.createImage(
+                        getMipData(mipChain, size, channels, cachedMipLevels), size, channels,
+                        format, VK_IMAGE_USAGE_SAMPLED_BIT
+                    );
+                }
+            }
+        }
+    }
+
+    std::vector<uint8_t> mipChain;
+    if (!decodeTexture(imagePath, channels, size, mipLevels, mipChain))
+    {
+        // Use a single black pixel so that a missing texture doesn't stop the game starting
+        uint32_t blankPixel = 0;
+        return vulkanEngine.createImage(
+            &blankPixel, { 1, 1, 1 }, channels, format, VK_IMAGE_USAGE_SAMPLED_BIT
+        );
+    }
+
+    ResourceCacheWriter writer(CACHE_MAGIC, CACHE_VERSION, { imagePath });
+    writer.write(size.width);
+    writer.write(size.height);
+    writer.write(static_cast<uint32_t>(channels));
+    writer.write(mipLevels);
+    writer.writeBytes(mipChain.data(), mipChain.size());
+    if (writer.save(cachePath))
+        LOG("Built texture cache " + cachePath.string());
+
+    return vulkanEngine.createImage(
+        getMipData(mipChain.data(), size, channels, mipLevels), size, channels, format,
+        VK_IMAGE_USAGE_SAMPLED_BIT
+    );
+}
+
+}  // namespace lonelycube::client
@@ -0,0 +1,36 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "core/pch.h"
+
+#include "client/graphics/vulkan/vulkanEngine.h"
+
+namespace lonelycube::client {
+
+// Loads a PNG into an image with mipLevels mips, or a full mip chain if mipLevels is 0. The
+// decoded pixels of every mip are kept in a binary cache, which is mapped and uploaded directly
+// until the PNG changes.
+AllocatedImage loadCachedTexture(
+    VulkanEngine& vulkanEngine, const std::filesystem::path& imagePath, int channels,
+    VkFormat format, uint32_t mipLevels = 1
+);
+
+}  // namespace lonelycube::client
@@ -174,7 +174,7 @@ void PipelineBuilder::enableDepthTest(bool depthWriteEnable, VkCompareOp compare
     depthStencil.maxDepthBounds = 1.0f;
 }
 
-VkPipeline PipelineBuilder::buildPipeline(VkDevice device)
+VkPipeline PipelineBuilder::buildPipeline(VkDevice device, VkPipelineCache pipelineCache)
 {
     VkPipelineViewportStateCreateInfo viewportState{};
     viewportState.sType= VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
@@ -216,7 +216,7 @@ VkPipeline PipelineBuilder::buildPipeline(VkDevice device)
 
     VkPipeline newPipeline;
     VK_CHECK(
-        vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &newPipeline)
+        vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineInfo, nullptr, &newPipeline)
     );
 
     return newPipeline;
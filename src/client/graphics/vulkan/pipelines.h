@@ -38,7 +38,7 @@ public:
     VkFormat colourAttachmentFormat;
 
     PipelineBuilder() { clear(); }
-    VkPipeline buildPipeline(VkDevice device);
+    VkPipeline buildPipeline(VkDevice device, VkPipelineCache pipelineCache);
 
     void clear();
     void setShaders(VkShaderModule vertexShader, VkShaderModule fragmentShader);
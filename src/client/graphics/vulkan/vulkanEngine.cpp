@@ -34,6 +34,50 @@
 
 namespace lonelycube::client {
 
+// Written before the data from vkGetPipelineCacheData in the pipeline cache file
+struct PipelineCacheFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint8_t deviceUUID[VK_UUID_SIZE];
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+    uint64_t dataSize;
+    uint64_t dataHash;
+};
+
+static constexpr uint32_t PIPELINE_CACHE_MAGIC = 0x4350434c;  // "LCPC"
+static constexpr uint32_t PIPELINE_CACHE_VERSION = 1;
+
+static PipelineCacheFileHeader getPipelineCacheFileHeader(
+    const VkPhysicalDeviceProperties& properties,
+    const VkPhysicalDeviceVulkan11Properties& vulkan11Properties
+) {
+    PipelineCacheFileHeader header{};
+    header.magic = PIPELINE_CACHE_MAGIC;
+    header.version = PIPELINE_CACHE_VERSION;
+    header.vendorID = properties.vendorID;
+    header.deviceID = properties.deviceID;
+    header.driverVersion = properties.driverVersion;
+    std::memcpy(header.deviceUUID, vulkan11Properties.deviceUUID, VK_UUID_SIZE);
+    std::memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    return header;
+}
+
+// FNV-1a
+static uint64_t hashPipelineCacheData(const std::vector<uint8_t>& data)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (uint8_t byte : data)
+    {
+        hash ^= byte;
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
 static void framebufferResizeCallback(GLFWwindow* window, int width, int height)
 {
     auto app = reinterpret_cast<VulkanEngine*>(glfwGetWindowUserPointer(window));
@@ -42,32 +86,47 @@ static void framebufferResizeCallback(GLFWwindow* window, int width, int height)
 
 VulkanEngine::VulkanEngine() :
 #ifdef RELEASE
-    m_enableValidationLayers(false)
+    m_enableValidationLayers(false),
 #else
-    m_enableValidationLayers(true)
+    m_enableValidationLayers(true),
 #endif
+    m_headless(false), m_window(nullptr), m_surface(VK_NULL_HANDLE),
+    m_pipelineCache(VK_NULL_HANDLE), m_pipelineCacheLoaded(false)
 {}
 
-void VulkanEngine::init()
+void VulkanEngine::init(bool headless)
 {
-    int glfwInitialized = glfwInit();
-    assert(glfwInitialized == GLFW_TRUE && "Could not initialise GLFW");
-    assert(glfwVulkanSupported() == GLFW_TRUE && "GLFW: Vulkan not supported");
+    m_headless = headless;
+    if (!m_headless)
+    {
+        int glfwInitialized = glfwInit();
+        assert(glfwInitialized == GLFW_TRUE && "Could not initialise GLFW");
+        assert(glfwVulkanSupported() == GLFW_TRUE && "GLFW: Vulkan not supported");
+    }
     VkResult volkInitialized = volkInitialize();
     assert(volkInitialized == VK_SUCCESS && "Vulkan loader not installed");
 
-    createWindow();
+    if (!m_headless)
+        createWindow();
     bool instanceCreated = createInstance();
     assert(instanceCreated);
-    glfwCreateWindowSurface(m_instance, m_window, nullptr, &m_surface);
+    if (!m_headless)
+        glfwCreateWindowSurface(m_instance, m_window, nullptr, &m_surface);
     pickPhysicalDevice();
     createLogicalDevice();
+    createPipelineCache();
     createAllocator();
-    createSwapchain();
-    createSwapchainData();
+    if (m_headless)
+    {
+        createOffscreenImages();
+    }
+    else
+    {
+        createSwapchain();
+        createSwapchainData();
+    }
     createFrameData();
     initImmediateSubmit();
-    createTimestampQueryPools();
 }
 
 void VulkanEngine::createWindow()
@@ -98,6 +157,14 @@ void VulkanEngine::createWindow()
 
 void VulkanEngine::cleanupSwapchain()
 {
+    if (m_headless)
+    {
+        for (const AllocatedImage& image : m_offscreenImages)
+            destroyImage(image);
+        m_offscreenImages.clear();
+        return;
+    }
+
     for (auto& swapchainData : m_swapchainImageData)
     {
         vkDestroyImageView(m_device, swapchainData.imageView, nullptr);
@@ -112,20 +179,24 @@ void VulkanEngine::cleanup()
     vkDeviceWaitIdle(m_device);
 
     cleanupSwapchain();
-    cleanupTimestampQueryPool();
     cleanupImmediateSubmit();
     cleanupFrameData();
+    savePipelineCache();
+    cleanupPipelineCache();
 
     vmaDestroyAllocator(m_allocator);
 
     vkDestroyDevice(m_device, nullptr);
 
-    vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+    if (!m_headless)
+        vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
     vkDestroyInstance(m_instance, nullptr);
 
-    glfwDestroyWindow(m_window);
-
-    glfwTerminate();
+    if (!m_headless)
+    {
+        glfwDestroyWindow(m_window);
+        glfwTerminate();
+    }
 }
 
 bool VulkanEngine::createInstance()
@@ -149,9 +220,10 @@ bool VulkanEngine::createInstance()
     createInfo.pApplicationInfo = &appInfo;
 
     uint32_t glfwExtensionCount = 0;
-    const char** glfwExtensions;
+    const char** glfwExtensions = nullptr;
 
-    glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+    if (!m_headless)
+        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
 
     createInfo.enabledExtensionCount = glfwExtensionCount;
     createInfo.ppEnabledExtensionNames = glfwExtensions;
@@ -291,15 +363,18 @@ int VulkanEngine::ratePhysicalDeviceSuitability(VkPhysicalDevice device)
     if (!(indices.graphicsAndComputeFamily.has_value() && indices.presentFamily.has_value()))
         return 0;
 
-    if (!checkDeviceExtensionSupport(device))
+    if (!m_headless && !checkDeviceExtensionSupport(device))
         return 0;
 
     if (!checkDeviceFeaturesSupport(device))
         return 0;
 
-    SwapchainSupportDetails swapchainSupport = querySwapchainSupport(device);
-    if (swapchainSupport.formats.empty() || swapchainSupport.presentModes.empty())
-        return 0;
+    if (!m_headless)
+    {
+        SwapchainSupportDetails swapchainSupport = querySwapchainSupport(device);
+        if (swapchainSupport.formats.empty() || swapchainSupport.presentModes.empty())
+            return 0;
+    }
 
     int score = 1;
     score += 300 * (deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU);
@@ -407,7 +482,8 @@ QueueFamilyIndices VulkanEngine::findQueueFamilies(VkPhysicalDevice device)
 
         // Try to make the present family the same as the graphicsAndComputeFamily
         VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
+        if (!m_headless)
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
         if (presentSupport
             && (!indices.presentFamily.has_value()
                 || indices.graphicsAndComputeFamily.value_or(i + 1) == i))
@@ -433,6 +509,10 @@ QueueFamilyIndices VulkanEngine::findQueueFamilies(VkPhysicalDevice device)
         // );
     }
 
+    // Nothing is presented without a window, so let the graphics queue stand in
+    if (m_headless)
+        indices.presentFamily = indices.graphicsAndComputeFamily;
+
     return indices;
 }
 
@@ -481,8 +561,11 @@ void VulkanEngine::createLogicalDevice()
     createInfo.pNext = &deviceFeatures;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(m_deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = m_deviceExtensions.data();
+    if (!m_headless)
+    {
+        createInfo.enabledExtensionCount = static_cast<uint32_t>(m_deviceExtensions.size());
+        createInfo.ppEnabledExtensionNames = m_deviceExtensions.data();
+    }
 
     if (m_enableValidationLayers)
     {
@@ -654,6 +737,30 @@ void VulkanEngine::createSwapchainData()
     }
 }
 
+void VulkanEngine::createOffscreenImages()
+{
+    m_swapchainImageFormat = VK_FORMAT_B8G8R8A8_SRGB;
+    m_swapchainExtent = HEADLESS_EXTENT;
+
+    // Each frame in flight gets its own image, which its fence guards in the same way as the
+    // image acquired from a swapchain
+    m_offscreenImages.resize(MAX_FRAMES_IN_FLIGHT);
+    m_swapchainImages.resize(MAX_FRAMES_IN_FLIGHT);
+    m_swapchainImageData.resize(MAX_FRAMES_IN_FLIGHT);
+    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        m_offscreenImages[i] = createImage(
+            { m_swapchainExtent.width, m_swapchainExtent.height, 1 }, m_swapchainImageFormat,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT
+                | VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+        );
+        m_swapchainImages[i] = m_offscreenImages[i].image;
+        m_swapchainImageData[i].image = m_offscreenImages[i].image;
+        m_swapchainImageData[i].imageView = m_offscreenImages[i].imageView;
+        m_swapchainImageData[i].renderFinishedSemaphore = VK_NULL_HANDLE;
+    }
+}
+
 void VulkanEngine::createCommandBuffer(VkCommandPool commandPool, VkCommandBuffer& commandBuffer)
 {
     VkCommandBufferAllocateInfo allocInfo{};
@@ -752,34 +859,112 @@ void VulkanEngine::immediateSubmit(std::function<void(VkCommandBuffer command)>&
     VK_CHECK(vkWaitForFences(m_device, 1, &m_immediateSubmitFence, true, UINT64_MAX));
 }
 
-void VulkanEngine::createTimestampQueryPools()
+std::vector<uint8_t> VulkanEngine::loadPipelineCacheData()
 {
-    #ifdef TIMESTAMPS
-    VkQueryPoolCreateInfo queryPoolInfo{};
-    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
-    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
-    queryPoolInfo.queryCount = static_cast<uint32_t>(m_timestamps.size());
-    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
-        VK_CHECK(vkCreateQueryPool(m_device, &queryPoolInfo, nullptr, &m_timestampQueryPools[i]));
-    #endif
+    std::ifstream file(PIPELINE_CACHE_PATH, std::ios::binary);
+    if (!file)
+        return {};
+
+    PipelineCacheFileHeader header;
+    PipelineCacheFileHeader expectedHeader = getPipelineCacheFileHeader(
+        m_physicalDeviceProperties.properties, m_physicalDeviceVulkan11Properties
+    );
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    // A cache from another GPU or driver version is no use, and could even crash the driver
+    if (!file || header.magic != expectedHeader.magic
+        || header.version != expectedHeader.version
+        || header.vendorID != expectedHeader.vendorID
+        || header.deviceID != expectedHeader.deviceID
+        || header.driverVersion != expectedHeader.driverVersion
+        || std::memcmp(header.deviceUUID, expectedHeader.deviceUUID, VK_UUID_SIZE) != 0
+        || std::memcmp(header.pipelineCacheUUID, expectedHeader.pipelineCacheUUID, VK_UUID_SIZE)
+            != 0)
+    {
+        LOG("Ignoring pipeline cache from a different device or driver");
+        return {};
+    }
+
+    std::error_code error;
+    uintmax_t fileSize = std::filesystem::file_size(PIPELINE_CACHE_PATH, error);
+    if (error || header.dataSize != fileSize - sizeof(header))
+    {
+        LOG("Ignoring truncated pipeline cache");
+        return {};
+    }
+
+    std::vector<uint8_t> data(header.dataSize);
+    file.read(reinterpret_cast<char*>(data.data()), data.size());
+    if (!file || hashPipelineCacheData(data) != header.dataHash)
+    {
+        LOG("Ignoring corrupted pipeline cache");
+        return {};
+    }
+    return data;
 }
 
-void VulkanEngine::cleanupTimestampQueryPool()
+void VulkanEngine::createPipelineCache()
 {
-    #ifdef TIMESTAMPS
-    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
-        vkDestroyQueryPool(m_device, m_timestampQueryPools[i], nullptr);
-    #endif
+    std::vector<uint8_t> data = loadPipelineCacheData();
+
+    VkPipelineCacheCreateInfo pipelineCacheInfo{};
+    pipelineCacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    pipelineCacheInfo.initialDataSize = data.size();
+    pipelineCacheInfo.pInitialData = data.data();
+    if (vkCreatePipelineCache(m_device, &pipelineCacheInfo, nullptr, &m_pipelineCache)
+        == VK_SUCCESS)
+    {
+        m_pipelineCacheLoaded = !data.empty();
+        return;
+    }
+
+    // The driver can still reject data that passed the checks, so start again with an empty cache
+    LOG("Failed to create the pipeline cache from " + std::string(PIPELINE_CACHE_PATH));
+    pipelineCacheInfo.initialDataSize = 0;
+    pipelineCacheInfo.pInitialData = nullptr;
+    m_pipelineCacheLoaded = false;
+    VK_CHECK(vkCreatePipelineCache(m_device, &pipelineCacheInfo, nullptr, &m_pipelineCache));
 }
 
-#ifdef TIMESTAMPS
-float VulkanEngine::getDeltaTimestamp(int firstTimeStampIndex, int secondTimeStampIndex)
+void VulkanEngine::savePipelineCache()
 {
-    VkPhysicalDeviceLimits device_limits = m_physicalDeviceProperties.properties.limits;
-    return float(m_timestamps[secondTimeStampIndex] - m_timestamps[firstTimeStampIndex]) *
-        device_limits.timestampPeriod / 1000000.0f;
+    size_t dataSize;
+    if (vkGetPipelineCacheData(m_device, m_pipelineCache, &dataSize, nullptr) != VK_SUCCESS)
+        return;
+    std::vector<uint8_t> data(dataSize);
+    if (vkGetPipelineCacheData(m_device, m_pipelineCache, &dataSize, data.data()) != VK_SUCCESS)
+        return;
+    data.resize(dataSize);
+
+    PipelineCacheFileHeader header = getPipelineCacheFileHeader(
+        m_physicalDeviceProperties.properties, m_physicalDeviceVulkan11Properties
+    );
+    header.dataSize = data.size();
+    header.dataHash = hashPipelineCacheData(data);
+
+    // Write to a temporary file first so that a crash part way through can't leave a truncated
+    // cache behind
+    std::string tempPath = std::string(PIPELINE_CACHE_PATH) + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        if (!file)
+        {
+            LOG("Failed to write " + tempPath);
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tempPath, PIPELINE_CACHE_PATH, error);
+    if (error)
+        LOG("Failed to save the pipeline cache: " + error.message());
+}
+
+void VulkanEngine::cleanupPipelineCache()
+{
+    vkDestroyPipelineCache(m_device, m_pipelineCache, nullptr);
+    m_pipelineCache = VK_NULL_HANDLE;
 }
-#endif
 
 void VulkanEngine::createFrameDataSyncObjects(int frameDataNum)
 {
@@ -803,38 +988,37 @@ bool VulkanEngine::startRenderingFrame()
 
     VK_CHECK(vkWaitForFences(m_device, 1, &currentFrameData.inFlightFence, VK_TRUE, UINT64_MAX));
 
-    VkResult result = vkAcquireNextImageKHR(
-        m_device, m_swapchain, UINT64_MAX, currentFrameData.imageAvailableSemaphore, VK_NULL_HANDLE,
-        &m_currentSwapchainIndex
-    );
-
-    // Check for resizing
-    if (result == VK_ERROR_OUT_OF_DATE_KHR)
-    {
-        m_windowResized = true;
-        return false;
-    }
-    else if (result != VK_SUBOPTIMAL_KHR)
+    if (m_headless)
     {
-        assert(result == VK_SUCCESS && "Failed to acquire swapchain image!");
+        m_currentSwapchainIndex = m_frameDataIndex;
     }
-    else if (m_swapchainExtent.width + m_swapchainExtent.height == 0)
+    else
     {
-        return false;
+        VkResult result = vkAcquireNextImageKHR(
+            m_device, m_swapchain, UINT64_MAX, currentFrameData.imageAvailableSemaphore,
+            VK_NULL_HANDLE, &m_currentSwapchainIndex
+        );
+
+        // Check for resizing
+        if (result == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            m_windowResized = true;
+            return false;
+        }
+        else if (result != VK_SUBOPTIMAL_KHR)
+        {
+            assert(result == VK_SUCCESS && "Failed to acquire swapchain image!");
+        }
+        else if (m_swapchainExtent.width + m_swapchainExtent.height == 0)
+        {
+            return false;
+        }
     }
 
     VK_CHECK(vkResetFences(m_device, 1, &currentFrameData.inFlightFence));
 
     VkCommandBuffer commandBuffer = currentFrameData.commandBuffer;
 
-    #ifdef TIMESTAMPS
-    vkGetQueryPoolResults(
-        m_device, m_timestampQueryPools[m_frameDataIndex], 0, 32,
-        m_timestamps.size() * sizeof(uint64_t), m_timestamps.data(), sizeof(uint64_t),
-        VK_QUERY_RESULT_64_BIT
-    );
-    #endif
-
     VK_CHECK(vkResetCommandBuffer(commandBuffer, 0));
 
     return true;
@@ -869,11 +1053,24 @@ void VulkanEngine::submitFrame()
     submitInfo.pSignalSemaphoreInfos = &signalInfo;
     submitInfo.commandBufferInfoCount = 1;
     submitInfo.pCommandBufferInfos = &commandSubmitInfo;
+    if (m_headless)
+    {
+        // There is no swapchain image to wait for or to present
+        submitInfo.waitSemaphoreInfoCount = 0;
+        submitInfo.signalSemaphoreInfoCount = 0;
+    }
 
     VK_CHECK(
         vkQueueSubmit2(m_graphicsAndComputeQueue, 1, &submitInfo, currentFrameData.inFlightFence)
     );
 
+    if (m_headless)
+    {
+        m_currentFrame++;
+        m_frameDataIndex = m_currentFrame % MAX_FRAMES_IN_FLIGHT;
+        return;
+    }
+
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.waitSemaphoreCount = 1;
@@ -1307,6 +1504,71 @@ AllocatedImage VulkanEngine::createImage(
     return newImage;
 }
 
+AllocatedImage VulkanEngine::createImage(
+    const std::vector<const void*>& mipData, VkExtent3D size, int bytesPerPixel,
+    VkFormat format, VkImageUsageFlags usage
+) {
+    uint32_t mipLevels = mipData.size();
+    AllocatedImage newImage = createImage(
+        size, format, usage | VK_IMAGE_USAGE_TRANSFER_DST_BIT, mipLevels
+    );
+
+    // Every mip is copied from the same staging buffer
+    std::vector<VkBufferImageCopy> copyRegions(mipLevels);
+    size_t dataSize = 0;
+    VkExtent3D mipSize = size;
+    for (uint32_t mipLevel = 0; mipLevel < mipLevels; mipLevel++)
+    {
+        VkBufferImageCopy& copyRegion = copyRegions[mipLevel];
+        copyRegion.bufferOffset = dataSize;
+        copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copyRegion.imageSubresource.mipLevel = mipLevel;
+        copyRegion.imageSubresource.baseArrayLayer = 0;
+        copyRegion.imageSubresource.layerCount = 1;
+        copyRegion.imageExtent = mipSize;
+
+        dataSize += static_cast<size_t>(mipSize.width) * mipSize.height * bytesPerPixel;
+        mipSize = VkExtent3D(
+            std::max(mipSize.width / 2, 1u), std::max(mipSize.height / 2, 1u), 1
+        );
+    }
+
+    AllocatedBuffer stagingBuffer = createBuffer(
+        dataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT
+    );
+    uint8_t* stagingData = static_cast<uint8_t*>(stagingBuffer.info.pMappedData);
+    for (uint32_t mipLevel = 0; mipLevel < mipLevels; mipLevel++)
+    {
+        size_t mipOffset = copyRegions[mipLevel].bufferOffset;
+        size_t mipDataSize = (mipLevel + 1 < mipLevels ? copyRegions[mipLevel + 1].bufferOffset
+            : dataSize) - mipOffset;
+        memcpy(stagingData + mipOffset, mipData[mipLevel], mipDataSize);
+    }
+
+    immediateSubmit([&](VkCommandBuffer command) {
+        transitionImage(
+            command, newImage.image, VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE,
+            VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_MEMORY_WRITE_BIT
+        );
+        vkCmdCopyBufferToImage(
+            command, stagingBuffer.buffer, newImage.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            mipLevels, copyRegions.data()
+        );
+        transitionImage(
+            command, newImage.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_COPY_BIT,
+            VK_ACCESS_2_MEMORY_WRITE_BIT, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            VK_ACCESS_2_MEMORY_READ_BIT
+        );
+    });
+
+    destroyBuffer(stagingBuffer);
+
+    return newImage;
+}
+
 void VulkanEngine::destroyImage(const AllocatedImage& image)
 {
     vkDestroyImageView(m_device, image.imageView, nullptr);
@@ -18,8 +18,6 @@
 
 #pragma once
 
-// #define TIMESTAMPS
-
 #include <volk.h>
 #include <vulkan/vulkan_core.h>
 #include "GLFW/glfw3.h"
@@ -110,9 +108,12 @@ class VulkanEngine
 {
 public:
     static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+    static constexpr VkExtent2D HEADLESS_EXTENT = { 1280, 720 };
 
     VulkanEngine();
-    void init();
+    // A headless engine has no window, and renders to offscreen images of HEADLESS_EXTENT in
+    // place of the swapchain, so it can run without a display
+    void init(bool headless = false);
     void cleanup();
 
     // Resizing
@@ -169,14 +170,16 @@ public:
         void* data, VkExtent3D size, int bytesPerPixel, VkFormat format, VkImageUsageFlags usage,
         uint32_t mipLevels = 1, VkSampleCountFlagBits numMSAAsamples = VK_SAMPLE_COUNT_1_BIT
     );
+    // Uploads mips that have already been generated, with one mip level per element of mipData
+    AllocatedImage createImage(
+        const std::vector<const void*>& mipData, VkExtent3D size, int bytesPerPixel,
+        VkFormat format, VkImageUsageFlags usage
+    );
     void destroyImage(const AllocatedImage& image);
 
     // Rendering
     bool startRenderingFrame();
     void submitFrame();
-    #ifdef TIMESTAMPS
-    float getDeltaTimestamp(int firstTimeStampIndex, int secondTimeStampIndex);
-    #endif
 
 private:
     const std::vector<const char*> m_validationLayers = {
@@ -186,6 +189,8 @@ private:
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
     };
     bool m_enableValidationLayers;
+    bool m_headless;
+    static constexpr const char* PIPELINE_CACHE_PATH = "res/pipelineCache.bin";
 
     // Vulkan core objects
     GLFWwindow* m_window;
@@ -205,6 +210,7 @@ private:
     VkExtent2D m_swapchainExtent;
     std::vector<SwapchainImageData> m_swapchainImageData;
     uint32_t m_currentSwapchainIndex;
+    std::vector<AllocatedImage> m_offscreenImages;
 
     // Rendering
     uint64_t m_currentFrame = 0;
@@ -212,6 +218,10 @@ private:
     std::vector<FrameData> m_frameData;
     bool m_windowResized = false;
 
+    // Shared by every pipeline, and kept between runs in PIPELINE_CACHE_PATH
+    VkPipelineCache m_pipelineCache;
+    bool m_pipelineCacheLoaded;
+
     // Immediate Submit
     VkFence m_immediateSubmitFence;
     VkCommandBuffer m_immediateSubmitCommandBuffer;
@@ -229,12 +239,6 @@ private:
     VkPhysicalDeviceVulkan13Features m_physicalDeviceVulkan13Features;
     VkSampleCountFlagBits m_maxSamples;
 
-    // Timing
-    #ifdef TIMESTAMPS
-    std::array<VkQueryPool, MAX_FRAMES_IN_FLIGHT> m_timestampQueryPools;
-    std::array<uint64_t, 32> m_timestamps;
-    #endif
-
     // Initialisation
     bool createInstance();
     void createWindow();
@@ -255,18 +259,23 @@ private:
     VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities);
     void createSwapchain();
     void createSwapchainData();
+    void createOffscreenImages();
     void createFrameData();
     void createFrameDataSyncObjects(int frameDataNum);
     void createCommandBuffer(VkCommandPool commandPool, VkCommandBuffer& commandBuffer);
     void createAllocator();
     void initImmediateSubmit();
-    void createTimestampQueryPools();
+    // Returns the contents of the cache file, or nothing if it wasn't written by this device and
+    // driver
+    std::vector<uint8_t> loadPipelineCacheData();
+    void createPipelineCache();
 
     // Cleanup
     void cleanupSwapchain();
     void cleanupFrameData();
     void cleanupImmediateSubmit();
-    void cleanupTimestampQueryPool();
+    void savePipelineCache();
+    void cleanupPipelineCache();
 
 public:
     inline VkDevice getDevice()
@@ -289,10 +298,23 @@ public:
     {
         return m_allocator;
     }
+    inline VkPipelineCache getPipelineCache()
+    {
+        return m_pipelineCache;
+    }
+    // Whether the pipeline cache was loaded from a previous run
+    inline bool isPipelineCacheWarm() const
+    {
+        return m_pipelineCacheLoaded;
+    }
     inline GLFWwindow* getWindow()
     {
         return m_window;
     }
+    inline bool isHeadless() const
+    {
+        return m_headless;
+    }
     inline void singalWindowResize()
     {
         m_windowResized = true;
@@ -333,16 +355,6 @@ public:
     {
         return m_maxSamples;
     }
-    #ifdef TIMESTAMPS
-    inline VkQueryPool getCurrentTimestampQueryPool()
-    {
-        return m_timestampQueryPools[m_frameDataIndex];
-    }
-    inline std::array<uint64_t, 32>& getTimestamps()
-    {
-        return m_timestamps;
-    }
-    #endif
 };
 
 }  // namespace lonelycube::client
@@ -40,7 +40,7 @@ void Font::init(
 
     m_vertexBuffers.reserve(VulkanEngine::MAX_FRAMES_IN_FLIGHT);
     for (int i = 0; i < VulkanEngine::MAX_FRAMES_IN_FLIGHT; i++)
-        m_vertexBuffers.push_back(m_vulkanEngine.allocateDynamicBuffer(65536));
+        m_vertexBuffers.push_back(m_vulkanEngine.allocateDynamicBuffer(262144));
     m_vertexBufferSize = 0;
 
     int size[2];
@@ -161,7 +161,9 @@ void Font::createPipeline()
     pipelineBuilder.setColourAttachmentFormat(m_vulkanEngine.getSwapchainImageFormat());
     pipelineBuilder.setDepthAttachmentFormat(VK_FORMAT_UNDEFINED);
 
-    m_pipeline = pipelineBuilder.buildPipeline(m_vulkanEngine.getDevice());
+    m_pipeline = pipelineBuilder.buildPipeline(
+        m_vulkanEngine.getDevice(), m_vulkanEngine.getPipelineCache()
+    );
 
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), vertexShader, nullptr);
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), fragmentShader, nullptr);
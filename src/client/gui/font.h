@@ -45,6 +45,10 @@ public:
     void draw();
     void resize(const glm::ivec2 windowDimensions);
     int getStringWidth(const std::string& text);
+    inline int getCharHeight() const
+    {
+        return m_maxCharSize[1];
+    }
 
 private:
     static const std::string s_textureFilePath;
@@ -119,7 +119,9 @@ void MenuRenderer::createPipeline()
     pipelineBuilder.setColourAttachmentFormat(m_vulkanEngine.getSwapchainImageFormat());
     pipelineBuilder.setDepthAttachmentFormat(VK_FORMAT_UNDEFINED);
 
-    m_pipeline = pipelineBuilder.buildPipeline(m_vulkanEngine.getDevice());
+    m_pipeline = pipelineBuilder.buildPipeline(
+        m_vulkanEngine.getDevice(), m_vulkanEngine.getPipelineCache()
+    );
 
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), vertexShader, nullptr);
     vkDestroyShaderModule(m_vulkanEngine.getDevice(), fragmentShader, nullptr);
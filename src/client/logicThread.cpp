@@ -26,6 +26,7 @@
 #include "client/clientPlayer.h"
 #include "core/constants.h"
 #include "core/packet.h"
+#include "core/profiler.h"
 #include "core/threadManager.h"
 
 namespace lonelycube::client {
@@ -33,6 +34,7 @@ namespace lonelycube::client {
 static void chunkLoaderThreadSingleplayer(
     ClientWorld& mainWorld, bool& running, int8_t threadNum, int& numThreadsBeingUsed
 ) {
+    Profiler::setThreadName("Chunk loader " + std::to_string(threadNum));
     while (running)
     {
         while (threadNum >= numThreadsBeingUsed && running)
@@ -49,6 +51,7 @@ static void chunkLoaderThreadMultiplayer(
     ClientWorld& mainWorld, ClientNetworking& networking, bool& running, int8_t threadNum,
     int& numThreadsBeingUsed
 ) {
+    Profiler::setThreadName("Chunk loader " + std::to_string(threadNum));
     std::chrono::time_point<std::chrono::steady_clock> timeStartedWaiting = 
         std::chrono::steady_clock::now();
     while (running)
@@ -70,6 +73,7 @@ static void chunkLoaderThreadMultiplayer(
 
 void LogicThread::go(bool& running)
 {
+    Profiler::setThreadName("Logic");
     ThreadManager threadManager(m_mainWorld.getNumChunkLoaderThreads());
     for (int8_t threadNum = 1; threadNum < threadManager.getNumThreads(); threadNum++)
     {
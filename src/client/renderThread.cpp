@@ -24,6 +24,7 @@
 #include "core/pch.h"
 
 #include "client/applicationState.h"
+#include "client/cameraPath.h"
 #include "client/game.h"
 #include "client/graphics/renderer.h"
 #include "client/gui/menuUpdateInfo.h"
@@ -32,11 +33,15 @@
 #include "client/input.h"
 #include "core/config.h"
 #include "core/log.h"
+#include "core/profiler.h"
 
 namespace lonelycube::client {
 
+static constexpr double CAMERA_PATH_KEYFRAME_INTERVAL = 0.5;  // seconds
+
 void renderThread()
 {
+    Profiler::setThreadName("Render");
     Renderer renderer(VK_SAMPLE_COUNT_4_BIT, 1.0f);
     ApplicationState applicationState;
 
@@ -53,6 +58,10 @@ void renderThread()
 
     bool running = true;
 
+    // Camera path being recorded for the flythrough benchmark, toggled with F7
+    std::optional<CameraPath> recordingCameraPath;
+    double cameraPathStartTime = 0.0;
+
     bool windowFullScreen = false;
     int windowDimensions[2];
     int smallScreenWindowDimensions[2];
@@ -177,6 +186,49 @@ void renderThread()
                     {
                         applicationState.toggleDebugInfo();
                     }
+                    if (input::buttonPressed(glfwGetKeyScancode(GLFW_KEY_F6)))
+                    {
+                        std::string tracePath = "trace_" + std::to_string(std::time(nullptr))
+                            + ".json";
+                        if (Profiler::writeChromeTrace(tracePath))
+                            std::cout << "Wrote profiler trace to " << tracePath << "\n";
+                        else
+                            std::cout << "Failed to write profiler trace to " << tracePath << "\n";
+                    }
+                    if (input::buttonPressed(glfwGetKeyScancode(GLFW_KEY_F8)))
+                    {
+                        GpuProfiler& gpuProfiler = renderer.getGpuProfiler();
+                        if (gpuProfiler.isEnabled())
+                        {
+                            gpuProfiler.setEnabled(false);
+                            gpuProfiler.stopCsvLog();
+                        }
+                        else if (gpuProfiler.isSupported())
+                        {
+                            std::string gpuLogPath = "gpu_timings_"
+                                + std::to_string(std::time(nullptr)) + ".csv";
+                            if (gpuProfiler.startCsvLog(gpuLogPath))
+                                LOG("Logging GPU pass times to " + gpuLogPath);
+                            gpuProfiler.setEnabled(true);
+                        }
+                    }
+                    if (input::buttonPressed(glfwGetKeyScancode(GLFW_KEY_F7)))
+                    {
+                        if (recordingCameraPath)
+                        {
+                            std::string cameraPathFile = "flythrough_"
+                                + std::to_string(std::time(nullptr)) + ".txt";
+                            if (recordingCameraPath->save(cameraPathFile))
+                                LOG("Wrote camera path to " + cameraPathFile);
+                            recordingCameraPath.reset();
+                        }
+                        else
+                        {
+                            LOG("Recording camera path");
+                            recordingCameraPath.emplace(worldSeed, settings.getRenderDistance());
+                            cameraPathStartTime = currentTime;
+                        }
+                    }
                     break;
 
                 case ApplicationState::StartMenu:
@@ -217,6 +269,25 @@ void renderThread()
                         applicationState.getState().end(), ApplicationState::Gameplay
                 )) {
                     game->processInput(actualDT);
+                    if (recordingCameraPath)
+                    {
+                        double time = currentTime - cameraPathStartTime;
+                        if (recordingCameraPath->getNumKeyframes()
+                            <= time / CAMERA_PATH_KEYFRAME_INTERVAL)
+                        {
+                            ClientPlayer& player = game->getPlayer();
+                            CameraKeyframe keyframe;
+                            keyframe.time = time;
+                            for (int i = 0; i < 3; i++)
+                            {
+                                keyframe.position[i] = player.cameraBlockPosition[i]
+                                    + static_cast<double>(player.viewCamera.position[i]);
+                            }
+                            keyframe.yaw = player.getYaw();
+                            keyframe.pitch = player.getPitch();
+                            recordingCameraPath->addKeyframe(keyframe);
+                        }
+                    }
                     game->renderFrame(actualDT);
                     bool gameplayFocused = applicationState.getState().back() == ApplicationState::Gameplay;
                     if (applicationState.isDebugInfoEnabled())
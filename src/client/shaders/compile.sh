@@ -2,6 +2,7 @@ glslangValidator -V src/client/shaders/sky.comp.glsl -o res/shaders/sky.comp.spv
 glslangValidator -V src/client/shaders/copy.frag.glsl -o res/shaders/copy.frag.spv
 glslangValidator -V src/client/shaders/block.vert.glsl -o res/shaders/block.vert.spv
 glslangValidator -V src/client/shaders/block.frag.glsl -o res/shaders/block.frag.spv
+glslangValidator -V src/client/shaders/entity.vert.glsl -o res/shaders/entity.vert.spv
 glslangValidator -V src/client/shaders/water.vert.glsl -o res/shaders/water.vert.spv
 glslangValidator -V src/client/shaders/water.frag.glsl -o res/shaders/water.frag.spv
 glslangValidator -V src/client/shaders/blockOutline.vert.glsl -o res/shaders/blockOutline.vert.spv
@@ -0,0 +1,102 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#version 460
+#extension GL_EXT_buffer_reference : require
+
+layout (location = 0) out vec2 outTexCoord;
+layout (location = 1) out float outSkyBrightness;
+layout (location = 2) out float outBlockBrightness;
+layout (location = 3) out float outVisibility;
+
+layout (buffer_reference, std430) readonly buffer VertexBuffer
+{
+    float vertices[];
+};
+
+struct Instance
+{
+    vec4 transform[3];
+    float skyLight;
+    float blockLight;
+    vec2 padding;
+};
+
+layout (buffer_reference, std430) readonly buffer InstanceBuffer
+{
+    Instance instances[];
+};
+
+layout (push_constant, std430) uniform constants
+{
+    mat4 mvp;
+    vec3 playerSubBlockPos;
+    float renderDistance;
+    float skyLightIntensity;
+    VertexBuffer vertexBuffer;
+    InstanceBuffer instanceBuffer;
+};
+
+const float fogStart = 0.4;
+const float fogDensity = 1.85;
+const float ambientLight = 0.000015;
+const float blockLightIntensity = 0.04;
+
+void main() {
+    Instance instance = instanceBuffer.instances[gl_InstanceIndex];
+    vec4 modelPosition = vec4(
+        vertexBuffer.vertices[gl_VertexIndex * 5],
+        vertexBuffer.vertices[gl_VertexIndex * 5 + 1],
+        vertexBuffer.vertices[gl_VertexIndex * 5 + 2],
+        1.0
+    );
+    vec4 position = vec4(
+        dot(instance.transform[0], modelPosition),
+        dot(instance.transform[1], modelPosition),
+        dot(instance.transform[2], modelPosition),
+        1.0
+    );
+    vec2 texCoord = vec2(
+        vertexBuffer.vertices[gl_VertexIndex * 5 + 3],
+        vertexBuffer.vertices[gl_VertexIndex * 5 + 4]
+    );
+    float skyLightLevel = instance.skyLight;
+    float blockLightLevel = instance.blockLight;
+
+    gl_Position = mvp * position;
+    outTexCoord = texCoord;
+    outSkyBrightness = mix(
+        ambientLight,
+        skyLightIntensity / (1.0 + (1.0 - skyLightLevel) * (1.0 - skyLightLevel) * 45.0),
+        skyLightLevel * skyLightLevel * skyLightLevel
+    );
+
+    outBlockBrightness = mix(
+        0.0,
+        blockLightIntensity / (1.0 + (1.0 - blockLightLevel) * (1.0 - blockLightLevel) * 45.0),
+        blockLightLevel * blockLightLevel
+    );
+
+    vec3 toCameraVector = position.xyz - playerSubBlockPos;
+    float distance = length(toCameraVector);
+    float normalisedDistance = clamp(distance - renderDistance * fogStart, 0.0f, renderDistance
+      * (1.0f - fogStart)) / (renderDistance * (1.0f - fogStart));
+    outVisibility = normalisedDistance * fogDensity;
+    outVisibility = exp(-outVisibility * outVisibility);
+    outVisibility *= clamp((renderDistance - distance) / renderDistance, 0.0f, 0.04f) * 25.0f;
+}
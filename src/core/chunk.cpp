@@ -34,7 +34,8 @@ Chunk::Chunk(IVec3 position) : m_position(position) {
     m_blockLightUpToDate = true;
     m_skyLightBeingRelit = true;
     m_blockLightBeingRelit = true;
-    m_playerCount = 0;
+    m_subscribers = 0;
+    m_loadedTime = -1;
 
     for (uint32_t layerNum = 0; layerNum < constants::CHUNK_SIZE; layerNum++)
     {
@@ -50,7 +51,8 @@ Chunk::Chunk() {
     m_blockLightUpToDate = true;
     m_skyLightBeingRelit = true;
     m_blockLightBeingRelit = true;
-    m_playerCount = 0;
+    m_subscribers = 0;
+    m_loadedTime = -1;
 }
 
 void Chunk::getPosition(int* coordinates) const {
@@ -36,10 +36,12 @@ private:
     std::array<uint32_t, constants::CHUNK_SIZE> m_layerBlockLightValues;
     bool m_skyLightUpToDate;
     bool m_blockLightUpToDate;
-    uint16_t m_playerCount;  // The number of players that are rendering this chunk
+    uint32_t m_subscribers;  // A bitmask of the IDs of the players that have this chunk loaded
     IVec3 m_position;  // The position in chunk coordinates (multiply by chunk size to get world coordinates)
     bool m_skyLightBeingRelit;
     bool m_blockLightBeingRelit;
+    // When the chunk finished being generated or received, or -1 once its first mesh is built
+    int64_t m_loadedTime;
 
     inline void findBlockCoordsInWorld(int* blockPos, uint32_t block) {
         int chunkCoords[3];
@@ -201,20 +203,32 @@ public:
 
     void uncompressBlocksAndLight();
 
-    inline void incrementPlayerCount() {
-        m_playerCount++;
+    inline void addSubscriber(uint32_t playerID) {
+        m_subscribers |= 1u << playerID;
     }
 
-    inline void decrementPlayerCount() {
-        m_playerCount--;
+    inline void removeSubscriber(uint32_t playerID) {
+        m_subscribers &= ~(1u << playerID);
+    }
+
+    inline void setSubscribers(uint32_t subscribers) {
+        m_subscribers = subscribers;
+    }
+
+    inline uint32_t getSubscribers() const {
+        return m_subscribers;
     }
 
     inline bool hasNoPlayers() {
-        return m_playerCount == 0;
+        return m_subscribers == 0;
+    }
+
+    inline void setLoadedTime(int64_t time) {
+        m_loadedTime = time;
     }
 
-    inline uint16_t getPlayerCount() const {
-        return m_playerCount;
+    inline int64_t getLoadedTime() const {
+        return m_loadedTime;
     }
 
     inline uint16_t getLayerBlockType(uint32_t layerNum) {
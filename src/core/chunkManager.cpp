@@ -20,7 +20,7 @@
 
 namespace lonelycube {
 
-ChunkManager::ChunkManager()
+ChunkManager::ChunkManager() : m_changedBlocksOverflowed(false)
 {
     // TODO:
     // set this reserved number for m_chunks to be dependant on render distance for singleplayer
@@ -62,6 +62,24 @@ void ChunkManager::setBlock(const IVec3& position, uint8_t blockType) {
 
     chunkIterator->second.setBlock(chunkBlockNum, blockType);
     chunkIterator->second.compressBlocks();
+
+    // Record the change so that sleeping entities near it can be woken. Nothing drains the
+    // list on a multiplayer client, so it is capped
+    std::lock_guard<std::mutex> lock(m_changedBlocksMtx);
+    if (m_changedBlocks.size() < MAX_TRACKED_CHANGED_BLOCKS)
+        m_changedBlocks.push_back(position);
+    else
+        m_changedBlocksOverflowed = true;
+}
+
+bool ChunkManager::takeChangedBlocks(std::vector<IVec3>& changedBlocks)
+{
+    std::lock_guard<std::mutex> lock(m_changedBlocksMtx);
+    changedBlocks.clear();
+    std::swap(changedBlocks, m_changedBlocks);
+    bool overflowed = m_changedBlocksOverflowed;
+    m_changedBlocksOverflowed = false;
+    return !overflowed;
 }
 
 uint8_t ChunkManager::getSkyLight(const IVec3& position) const {
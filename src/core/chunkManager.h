@@ -20,22 +20,33 @@
 
 #include "core/chunk.h"
 #include "core/utils/iVec3.h"
+#include <shared_mutex>
 
 namespace lonelycube {
 
 class ChunkManager
 {
 private:
+    static constexpr size_t MAX_TRACKED_CHANGED_BLOCKS = 4096;
+
     std::unordered_map<IVec3, Chunk> m_chunks;
+    std::mutex m_changedBlocksMtx;
+    std::vector<IVec3> m_changedBlocks;
+    bool m_changedBlocksOverflowed;
 
 public:
-    std::mutex mutex;
+    // Held exclusively to add or remove chunks, and shared by readers such as physics
+    std::shared_mutex mutex;
 
     ChunkManager();
     uint8_t getBlock(const IVec3& position) const;
     void setBlock(const IVec3& position, uint8_t blockType);
     uint8_t getSkyLight(const IVec3& position) const;
     uint8_t getBlockLight(const IVec3& position) const;
+    // Moves the positions of the blocks changed by setBlock since the last call into
+    // changedBlocks. Returns false if too many blocks changed for them all to be kept, in which
+    // case any block may have changed.
+    bool takeChangedBlocks(std::vector<IVec3>& changedBlocks);
     inline Chunk& getChunk(const IVec3& chunkPosition) {
         return m_chunks.at(chunkPosition);
     }
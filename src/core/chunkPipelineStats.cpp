@@ -0,0 +1,76 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/chunkPipelineStats.h"
+
+#include "core/pch.h"
+
+#include <iomanip>
+
+namespace lonelycube {
+
+static constexpr int NUM_STAGES = static_cast<int>(ChunkStage::Count);
+
+static std::array<LatencyHistogram, NUM_STAGES> s_histograms;
+
+static constexpr std::array<const char*, NUM_STAGES> s_stageNames = {
+    "Queue", "Generate", "Send queue", "Compress", "Send", "Decompress", "Neighbour wait",
+    "Lighting", "Mesh", "Upload wait", "Upload", "Loaded to drawn"
+};
+
+void ChunkPipelineStats::record(ChunkStage stage, int64_t start, int64_t end)
+{
+    s_histograms[static_cast<int>(stage)].record(end - start);
+}
+
+const LatencyHistogram& ChunkPipelineStats::getHistogram(ChunkStage stage)
+{
+    return s_histograms[static_cast<int>(stage)];
+}
+
+const char* ChunkPipelineStats::getStageName(ChunkStage stage)
+{
+    return s_stageNames[static_cast<int>(stage)];
+}
+
+std::vector<std::string> ChunkPipelineStats::getSummary()
+{
+    std::vector<std::string> lines;
+    for (int stageNum = 0; stageNum < NUM_STAGES; stageNum++)
+    {
+        const LatencyHistogram& histogram = s_histograms[stageNum];
+        if (histogram.getCount() == 0)
+            continue;
+
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(2) << s_stageNames[stageNum] << ": "
+            << histogram.getCount() << " chunks, p50 " << histogram.getPercentile(50.0) / 1e6
+            << "ms, p99 " << histogram.getPercentile(99.0) / 1e6 << "ms, max "
+            << histogram.getMax() / 1e6 << "ms";
+        lines.push_back(line.str());
+    }
+    return lines;
+}
+
+void ChunkPipelineStats::reset()
+{
+    for (LatencyHistogram& histogram : s_histograms)
+        histogram.reset();
+}
+
+}  // namespace lonelycube
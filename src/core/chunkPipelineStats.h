@@ -0,0 +1,57 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+#include "core/latencyHistogram.h"
+
+namespace lonelycube {
+
+// The stages that a chunk goes through between being requested and being drawn
+enum class ChunkStage
+{
+    Queue,  // Waiting for a chunk loader thread to start generating it
+    Generate,
+    SendQueue,  // Waiting for the server to send it to a player
+    Compress,
+    Send,
+    Decompress,
+    NeighbourWait,  // Waiting for its neighbours to load so that it can be meshed
+    Lighting,
+    Mesh,
+    UploadWait,  // Waiting for the render thread to upload the mesh
+    Upload,
+    LoadedToDrawn,  // From finishing loading to the mesh being uploaded
+    Count
+};
+
+// How long chunks spend in each stage of the pipeline, shared by the client and server
+class ChunkPipelineStats
+{
+public:
+    static void record(ChunkStage stage, int64_t start, int64_t end);
+    static const LatencyHistogram& getHistogram(ChunkStage stage);
+    static const char* getStageName(ChunkStage stage);
+    // Returns a line with the count, p50, p99 and max of every stage that has been recorded
+    static std::vector<std::string> getSummary();
+    static void reset();
+};
+
+}  // namespace lonelycube
@@ -0,0 +1,89 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/chunkSendScheduler.h"
+
+#include "core/pch.h"
+
+namespace lonelycube {
+
+ChunkSendScheduler::ChunkSendScheduler() :
+    m_bytesInFlight(std::make_shared<std::atomic<int64_t>>(0)),
+    m_windowSize(INITIAL_WINDOW_SIZE), m_minRoundTripTime(std::numeric_limits<uint32_t>::max()),
+    m_roundTripTime(0), m_slowStart(true) {}
+
+void ChunkSendScheduler::packetFreed(ENetPacket* packet)
+{
+    // ENet destroys reliable packets once they have been acknowledged (or the peer has been
+    // reset), so this is where they stop counting towards the bytes in flight
+    auto* bytesInFlight = static_cast<std::shared_ptr<std::atomic<int64_t>>*>(packet->userData);
+    **bytesInFlight -= packet->dataLength;
+    delete bytesInFlight;
+}
+
+void ChunkSendScheduler::trackPacket(ENetPacket* packet)
+{
+    *m_bytesInFlight += packet->dataLength;
+    // The counter is shared with the packet so that it outlives the player if they disconnect
+    // before ENet has freed all of their packets
+    packet->userData = new std::shared_ptr<std::atomic<int64_t>>(m_bytesInFlight);
+    packet->freeCallback = packetFreed;
+}
+
+void ChunkSendScheduler::update(const ENetPeer* peer)
+{
+    auto currentTime = std::chrono::steady_clock::now();
+    if (currentTime - m_lastUpdate < UPDATE_INTERVAL)
+        return;
+    m_lastUpdate = currentTime;
+
+    int64_t bytesInFlight = *m_bytesInFlight;
+    m_roundTripTime = peer->roundTripTime;
+    // The minimum round trip time is only allowed to increase when the link has drained, as
+    // otherwise the queueing delay would be mistaken for the base latency of the link
+    if (m_roundTripTime < m_minRoundTripTime || (bytesInFlight < MIN_WINDOW_SIZE
+        && currentTime - m_minRoundTripTimeSetTime > MIN_RTT_LIFETIME))
+    {
+        m_minRoundTripTime = m_roundTripTime;
+        m_minRoundTripTimeSetTime = currentTime;
+    }
+
+    uint32_t queueDelay = m_roundTripTime - m_minRoundTripTime;
+    if (queueDelay > std::max(MIN_QUEUE_DELAY, m_minRoundTripTime / 2))
+    {
+        // Only shrink the window once per round trip so that the round trip time has a chance
+        // to reflect the previous decrease
+        if (currentTime - m_lastWindowDecrease > std::chrono::milliseconds(m_roundTripTime))
+        {
+            m_windowSize = std::max(MIN_WINDOW_SIZE, m_windowSize * 3 / 4);
+            m_slowStart = false;
+            m_lastWindowDecrease = currentTime;
+        }
+    }
+    else if (bytesInFlight * 2 >= m_windowSize)
+    {
+        // Only grow the window when it is what is limiting the rate chunks are sent at
+        if (m_slowStart)
+            m_windowSize *= 2;
+        else
+            m_windowSize += m_windowSize / 8;
+        m_windowSize = std::min(m_windowSize, MAX_WINDOW_SIZE);
+    }
+}
+
+}  // namespace lonelycube
@@ -0,0 +1,77 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "enet/enet.h"
+
+#include "core/pch.h"
+
+#include <atomic>
+
+namespace lonelycube {
+
+// Paces the chunks sent to a single peer. The number of reliable bytes that have been handed
+// to ENet but not yet acknowledged is tracked through the packets' free callbacks, and the
+// send window grows while the round trip time stays close to its minimum and shrinks when a
+// queue starts to build up on the link.
+class ChunkSendScheduler
+{
+private:
+    static constexpr int64_t MIN_WINDOW_SIZE = 64 * 1024;
+    static constexpr int64_t MAX_WINDOW_SIZE = 64 * 1024 * 1024;
+    static constexpr int64_t INITIAL_WINDOW_SIZE = 256 * 1024;
+    static constexpr uint32_t MIN_QUEUE_DELAY = 40;  // ms
+    static constexpr std::chrono::milliseconds UPDATE_INTERVAL{ 50 };
+    static constexpr std::chrono::seconds MIN_RTT_LIFETIME{ 10 };
+
+    std::shared_ptr<std::atomic<int64_t>> m_bytesInFlight;
+    int64_t m_windowSize;
+    uint32_t m_minRoundTripTime;
+    uint32_t m_roundTripTime;
+    bool m_slowStart;
+    std::chrono::steady_clock::time_point m_lastUpdate;
+    std::chrono::steady_clock::time_point m_lastWindowDecrease;
+    std::chrono::steady_clock::time_point m_minRoundTripTimeSetTime;
+
+    static void packetFreed(ENetPacket* packet);
+
+public:
+    ChunkSendScheduler();
+    void update(const ENetPeer* peer);
+    void trackPacket(ENetPacket* packet);
+
+    inline bool canSend() const
+    {
+        return *m_bytesInFlight < m_windowSize;
+    }
+    inline int64_t getBytesInFlight() const
+    {
+        return *m_bytesInFlight;
+    }
+    inline int64_t getWindowSize() const
+    {
+        return m_windowSize;
+    }
+    inline uint32_t getRoundTripTime() const
+    {
+        return m_roundTripTime;
+    }
+};
+
+}  // namespace lonelycube
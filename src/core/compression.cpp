@@ -23,12 +23,14 @@
 #include "core/chunk.h"
 #include "core/log.h"
 #include "core/packet.h"
+#include "core/profiler.h"
 
 namespace lonelycube {
 
 void Compression::compressChunk(Packet<uint8_t,
     9 * constants::CHUNK_SIZE * constants::CHUNK_SIZE * constants::CHUNK_SIZE>& compressedChunk,
     Chunk& chunk) {
+    PROFILE_ZONE("Compress chunk");
     int chunkPosition[3];
     chunk.getPosition(chunkPosition);
     uint32_t packetIndex = 0;
@@ -114,6 +116,7 @@ void Compression::compressChunk(Packet<uint8_t,
 void Compression::decompressChunk(Packet<uint8_t,
     9 * constants::CHUNK_SIZE * constants::CHUNK_SIZE * constants::CHUNK_SIZE>& compressedChunk,
     Chunk& chunk) {
+    PROFILE_ZONE("Decompress chunk");
     // Add blocks
     uint32_t packetIndex = 12;
     uint32_t blockNum = 0;
@@ -32,6 +32,9 @@ Config::Config(std::filesystem::path settingsPath) {
     std::string line, field, value;
     std::ifstream stream(settingsPath);
     while (std::getline(stream, line)) {
+        size_t separator = line.find(':');
+        std::string untrimmedValue = separator == std::string::npos ? ""
+            : line.substr(separator + 1);
         line.erase(std::remove_if(line.begin(), line.end(), isspace), line.end());
         std::stringstream lineStream(line);
         std::getline(lineStream, field, ':');
@@ -44,6 +47,13 @@ Config::Config(std::filesystem::path settingsPath) {
         if (field == "serveripaddress") {
             m_serverIP = value;
         }
+        if (field == "flythrough") {
+            // Paths can contain spaces, and colons on Windows, so only the ends are trimmed
+            size_t begin = untrimmedValue.find_first_not_of(" \t\r");
+            size_t end = untrimmedValue.find_last_not_of(" \t\r");
+            m_flythroughPath = begin == std::string::npos ? ""
+                : untrimmedValue.substr(begin, end - begin + 1);
+        }
         if (field == "multiplayer") {
             value.erase(std::remove_if(value.begin(), value.end(), isspace), value.end());
             std::transform(value.begin(), value.end(), value.begin(),
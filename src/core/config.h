@@ -27,6 +27,7 @@ private:
     uint16_t m_renderDistance;
     std::string m_serverIP;
     bool m_multiplayer;
+    std::string m_flythroughPath;
 public:
     Config(std::filesystem::path settingsPath);
     uint16_t getRenderDistance() const {
@@ -38,6 +39,10 @@ public:
     bool getMultiplayer() const {
         return m_multiplayer;
     }
+    // Empty unless the client should run the flythrough benchmark instead of the game
+    const std::string& getFlythroughPath() const {
+        return m_flythroughPath;
+    }
 };
 
 }  // namespace lonelycube
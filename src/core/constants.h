@@ -43,6 +43,9 @@ constexpr uint32_t DAY_LENGTH{ 24000 };
 
 constexpr int TICKS_PER_SECOND{ 20 };
 
+// Chunks keep a 32 bit mask of the IDs of the players that have them loaded
+constexpr uint32_t MAX_PLAYERS{ 32 };
+
 constexpr uint32_t NUM_GROUND_LUMINANCE_POINTS{ 13 };
 constexpr float GROUND_LUMINANCE[NUM_GROUND_LUMINANCE_POINTS * 2] = {
     // Time | Luminance
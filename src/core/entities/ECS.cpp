@@ -20,12 +20,11 @@
 
 namespace lonelycube {
 
-ECS::ECS(int maxEntities) : m_maxEntities(maxEntities) {}
-
-ECS::~ECS() {
-    for (ComponentPool* pool : m_componentPools) {
-        delete pool;
-    }
+ECS::ECS(int maxEntities)
+{
+    // Component storage grows as components are assigned, so only the entity descriptions are
+    // allocated up front
+    m_entities.reserve(maxEntities);
 }
 
 EntityId ECS::newEntity()
@@ -45,6 +44,14 @@ EntityId ECS::newEntity()
 
 void ECS::destroyEntity(const EntityId id)
 {
+    EntityIndex index = getEntityIndex(id);
+    ComponentMask mask = m_entities[index].mask;
+    for (size_t componentId = 0; componentId < m_componentPools.size(); componentId++)
+    {
+        if (mask[componentId])
+            m_componentPools[componentId]->remove(index);
+    }
+
     EntityId newId = createEntityId(EntityIndex(-1), getEntityVersion(id) + 1);
     m_entities[getEntityIndex(id)].id = newId;
     m_entities[getEntityIndex(id)].mask.reset();
@@ -36,17 +36,123 @@ struct EntityDesc
 };
 
 
-struct ComponentPool
+// Stores the components of a single type. The components are packed densely, with a sparse
+// array mapping each entity index to the component's position in the dense array, so only
+// four bytes are needed for each entity that doesn't have the component and iterating over
+// the components only touches live ones.
+class ComponentPool
 {
-    size_t elementSize;
-    std::unique_ptr<char[]> pData;
+protected:
+    static constexpr uint32_t NOT_IN_POOL = std::numeric_limits<uint32_t>::max();
 
-    ComponentPool(size_t elementsize, int maxEntities) : elementSize(elementsize),
-        pData(std::make_unique<char[]>(elementSize * maxEntities)) {}
+    std::vector<uint32_t> m_sparse;
+    std::vector<EntityIndex> m_entities;
 
-    inline void* get(size_t index)
+    inline uint32_t& getDenseIndex(EntityIndex index)
     {
-        return pData.get() + index * elementSize;
+        if (index >= m_sparse.size())
+            m_sparse.resize(index + 1, NOT_IN_POOL);
+        return m_sparse[index];
+    }
+
+public:
+    virtual ~ComponentPool() {}
+
+    virtual void remove(EntityIndex index) = 0;
+
+    inline bool contains(EntityIndex index) const
+    {
+        return index < m_sparse.size() && m_sparse[index] != NOT_IN_POOL;
+    }
+
+    inline size_t size() const
+    {
+        return m_entities.size();
+    }
+
+    // Returns the index of the entity that owns the component at the given dense position
+    inline EntityIndex getEntity(size_t denseIndex) const
+    {
+        return m_entities[denseIndex];
+    }
+};
+
+
+// The dense array is split into fixed size pages so that adding a component never moves the
+// existing ones. Removing a component moves the last one into its place, so a reference to a
+// component is only invalidated when a component of the same type is removed.
+template<typename T>
+class TypedComponentPool : public ComponentPool
+{
+private:
+    static constexpr uint32_t PAGE_SIZE = 256;
+
+    struct alignas(T) Storage
+    {
+        std::byte data[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Storage[]>> m_pages;
+
+    inline T* at(size_t denseIndex)
+    {
+        return reinterpret_cast<T*>(m_pages[denseIndex / PAGE_SIZE][denseIndex % PAGE_SIZE].data);
+    }
+
+public:
+    ~TypedComponentPool()
+    {
+        for (size_t denseIndex = 0; denseIndex < m_entities.size(); denseIndex++)
+            std::destroy_at(at(denseIndex));
+    }
+
+    template<typename... Types>
+    T& emplace(EntityIndex index, Types... constructorArgs)
+    {
+        uint32_t& denseIndex = getDenseIndex(index);
+        if (denseIndex != NOT_IN_POOL)
+        {
+            // Replace the entity's existing component
+            std::destroy_at(at(denseIndex));
+            return *new (at(denseIndex)) T(constructorArgs...);
+        }
+
+        denseIndex = m_entities.size();
+        if (denseIndex / PAGE_SIZE >= m_pages.size())
+            m_pages.push_back(std::make_unique<Storage[]>(PAGE_SIZE));
+        m_entities.push_back(index);
+        return *new (at(denseIndex)) T(constructorArgs...);
+    }
+
+    // The entity must have the component
+    inline T& get(EntityIndex index)
+    {
+        return *at(m_sparse[index]);
+    }
+
+    void remove(EntityIndex index) override
+    {
+        if (!contains(index))
+            return;
+
+        uint32_t& denseIndex = getDenseIndex(index);
+        size_t lastIndex = m_entities.size() - 1;
+        std::destroy_at(at(denseIndex));
+        if (denseIndex != lastIndex)
+        {
+            // Fill the gap with the last component to keep the array packed
+            new (at(denseIndex)) T(std::move(*at(lastIndex)));
+            std::destroy_at(at(lastIndex));
+            m_entities[denseIndex] = m_entities[lastIndex];
+            getDenseIndex(m_entities[denseIndex]) = denseIndex;
+        }
+        denseIndex = NOT_IN_POOL;
+        m_entities.pop_back();
+
+        // Keep one empty page spare so that an entity being added and removed repeatedly at a
+        // page boundary doesn't allocate every time
+        if (m_entities.size() + PAGE_SIZE <= (m_pages.size() - 1) * PAGE_SIZE)
+            m_pages.pop_back();
     }
 };
 
@@ -57,16 +163,14 @@ private:
     template<typename T>
     inline static int s_componentID = m_componentCounter++;
 
-    int m_maxEntities;
     std::vector<EntityDesc> m_entities;
     std::vector<EntityIndex> m_freeEntities;
-    std::vector<ComponentPool*> m_componentPools;
+    std::vector<std::unique_ptr<ComponentPool>> m_componentPools;
 
 public:
     std::mutex mutex;
 
     ECS(int maxEntities);
-    ~ECS();
 
     template<typename T>
     static int getComponentId();
@@ -101,6 +205,14 @@ public:
         return m_entities.size();
     }
 
+    // Returns nullptr if no entity has ever had a component with the given ID
+    inline ComponentPool* getComponentPool(int componentId)
+    {
+        return componentId < static_cast<int>(m_componentPools.size())
+            ? m_componentPools[componentId].get()
+            : nullptr;
+    }
+
     inline bool isEntityAlive(const EntityId id)
     {
         return m_entities[getEntityIndex(id)].id == id;
@@ -149,27 +261,30 @@ T& ECS::assign(const EntityId id, Types... constructorArgs)
 
     if (m_componentPools.size() <= componentId)  // Not enough component pools
     {
-        m_componentPools.resize(componentId + 1, nullptr);
+        m_componentPools.resize(componentId + 1);
     }
     if (m_componentPools[componentId] == nullptr)  // New component, make a new pool
     {
-        m_componentPools[componentId] = new ComponentPool(sizeof(T), m_maxEntities);
+        m_componentPools[componentId] = std::make_unique<TypedComponentPool<T>>();
     }
 
-    // Looks up the component in the pool, and initializes it with placement new
-    T* component = new
-        (m_componentPools[componentId]->get(getEntityIndex(id))) T(constructorArgs...);
+    // Construct the component in the pool
+    T& component = static_cast<TypedComponentPool<T>*>(m_componentPools[componentId].get())
+        ->emplace(getEntityIndex(id), constructorArgs...);
 
     // Set the bit for this component to true and return the created component
     m_entities[getEntityIndex(id)].mask.set(componentId);
 
-    return *component;
+    return component;
 }
 
 template<typename T>
 void ECS::remove(const EntityId id)
 {
     int componentId = getComponentId<T>();
+    if (!m_entities[getEntityIndex(id)].mask[componentId])
+        return;
+    m_componentPools[componentId]->remove(getEntityIndex(id));
     m_entities[getEntityIndex(id)].mask.reset(componentId);
 }
 
@@ -177,14 +292,14 @@ template<typename T>
 T& ECS::get(const EntityId id)
 {
     int componentId = getComponentId<T>();
-    return *static_cast<T*>(m_componentPools[componentId]->get(getEntityIndex(id)));
+    return static_cast<TypedComponentPool<T>*>(m_componentPools[componentId].get())
+        ->get(getEntityIndex(id));
 }
 
 template<typename T>
 void ECS::set(const EntityId id, const T& value)
 {
-    int componentId = getComponentId<T>();
-    *static_cast<T*>(m_componentPools[componentId]->get(getEntityIndex(id))) = value;
+    get<T>(id) = value;
 }
 
 }  // namespace lonelycube
@@ -22,28 +22,37 @@
 
 namespace lonelycube {
 
+// Iterates over the entities that have all of the given components. The entities in the
+// smallest of the components' pools are visited in the order they are packed in the pool, so
+// only entities that have at least one of the components are touched. An ECSView with no
+// components iterates over every living entity in order of index.
+// The entity being visited may be destroyed, or have components removed, during iteration.
 template<typename... ComponentTypes>
 class ECSView
 {
 private:
     ECS& ecs;
     ComponentMask componentMask;
-    bool all{ false };
+    ComponentPool* pool{ nullptr };
+    static constexpr bool all = sizeof...(ComponentTypes) == 0;
 
     class Iterator
     {
     private:
-        bool validIndex() const;
+        static constexpr size_t END = std::numeric_limits<size_t>::max();
 
-    public:
-        EntityIndex index;
         ECS& ecs;
+        ComponentPool* pool;
         ComponentMask mask;
-        bool all{ false };
+        size_t position;
+        EntityIndex entity;
 
-        Iterator(ECS& ecs, EntityIndex index, ComponentMask mask, bool all);
+        EntityIndex getEntityAt(size_t position) const;
+        bool validPosition() const;
+        void findValidPosition();
 
-        const Iterator end() const;
+    public:
+        Iterator(ECS& ecs, ComponentPool* pool, ComponentMask mask, size_t position);
 
         EntityId operator*() const;
 
@@ -52,6 +61,8 @@ private:
         bool operator!=(const Iterator& other) const;
 
         Iterator& operator++();
+
+        friend class ECSView;
     };
 
 public:
@@ -66,75 +77,105 @@ public:
 template<typename... ComponentTypes>
 ECSView<ComponentTypes...>::ECSView(ECS& ecs) : ecs(ecs)
 {
-    if (sizeof...(ComponentTypes) == 0)
-    {
-        all = true;
-    }
-    else
+    if constexpr (!all)
     {
         // Unpack the template parameters into an initializer list
         int componentIds[] = { 0, ecs.getComponentId<ComponentTypes>() ... };
         for (int i = 1; i < (sizeof...(ComponentTypes) + 1); i++)
+        {
             componentMask.set(componentIds[i]);
+            // Iterate over the smallest pool, as every entity in the view must be in it. If a
+            // component has no pool, no entity can have it so the view is empty
+            ComponentPool* componentPool = ecs.getComponentPool(componentIds[i]);
+            if (componentPool == nullptr)
+            {
+                pool = nullptr;
+                break;
+            }
+            if (i == 1 || componentPool->size() < pool->size())
+                pool = componentPool;
+        }
     }
 }
 
 template<typename... ComponentTypes>
-ECSView<ComponentTypes...>::Iterator::Iterator(ECS& ecs, EntityIndex index, ComponentMask mask,
-    bool all) : ecs(ecs), index(index), mask(mask), all(all) {}
+ECSView<ComponentTypes...>::Iterator::Iterator(ECS& ecs, ComponentPool* pool,
+    ComponentMask mask, size_t position) : ecs(ecs), pool(pool), mask(mask),
+    position(position)
+{
+    if (position != END)
+        findValidPosition();
+}
 
 template<typename... ComponentTypes>
-EntityId ECSView<ComponentTypes...>::Iterator::operator*() const
+EntityIndex ECSView<ComponentTypes...>::Iterator::getEntityAt(size_t position) const
 {
-    return ecs.getEntityId(index);
+    return all ? EntityIndex(position) : pool->getEntity(position);
 }
 
 template<typename... ComponentTypes>
-bool ECSView<ComponentTypes...>::Iterator::operator==(const Iterator& other) const
+bool ECSView<ComponentTypes...>::Iterator::validPosition() const
 {
-    return index == other.index;
+    if (all)
+        return ecs.isEntityValid(ecs.getEntityId(position));
+    // Entities in a pool are always alive
+    return mask == (mask & ecs.getEntityComponentMask(getEntityAt(position)));
 }
 
 template<typename... ComponentTypes>
-bool ECSView<ComponentTypes...>::Iterator::operator!=(const Iterator& other) const
+void ECSView<ComponentTypes...>::Iterator::findValidPosition()
+{
+    size_t size = all ? ecs.getSize() : pool->size();
+    while (position < size && !validPosition())
+        position++;
+    if (position < size)
+        entity = getEntityAt(position);
+    else
+        position = END;
+}
+
+template<typename... ComponentTypes>
+EntityId ECSView<ComponentTypes...>::Iterator::operator*() const
 {
-    return index != other.index;
+    return ecs.getEntityId(entity);
 }
 
 template<typename... ComponentTypes>
-bool ECSView<ComponentTypes...>::Iterator::validIndex() const
+bool ECSView<ComponentTypes...>::Iterator::operator==(const Iterator& other) const
 {
-    return ecs.isEntityValid(ecs.getEntityId(index)) && (all || mask ==
-        (mask & ecs.getEntityComponentMask(index)));
+    return position == other.position;
 }
 
 template<typename... ComponentTypes>
-ECSView<ComponentTypes...>::Iterator& ECSView<ComponentTypes...>::Iterator::operator++() 
+bool ECSView<ComponentTypes...>::Iterator::operator!=(const Iterator& other) const
 {
-    do
-    {
-        index++;
-    } while (index < ecs.getSize() && !validIndex());
+    return position != other.position;
+}
+
+template<typename... ComponentTypes>
+ECSView<ComponentTypes...>::Iterator& ECSView<ComponentTypes...>::Iterator::operator++()
+{
+    // If the current entity was removed from the pool, the last entity in the pool has been
+    // moved into its position, so that position has to be visited again
+    size_t size = all ? ecs.getSize() : pool->size();
+    if (all || (position < size && getEntityAt(position) == entity))
+        position++;
+    findValidPosition();
     return *this;
 }
 
 template<typename... ComponentTypes>
 const ECSView<ComponentTypes...>::Iterator ECSView<ComponentTypes...>::begin() const
 {
-    int firstIndex = 0;
-    while (firstIndex < ecs.getSize()
-        && (componentMask != (componentMask & ecs.getEntityComponentMask(firstIndex))
-        || !ecs.isEntityValid(ecs.getEntityId(firstIndex))))
-    {
-        firstIndex++;
-    }
-    return Iterator(ecs, firstIndex, componentMask, all);
+    if (!all && pool == nullptr)
+        return end();
+    return Iterator(ecs, pool, componentMask, 0);
 }
 
 template<typename... ComponentTypes>
 const ECSView<ComponentTypes...>::Iterator ECSView<ComponentTypes...>::end() const
 {
-    return Iterator(ecs, EntityIndex(ecs.getSize()), componentMask, all);
+    return Iterator(ecs, pool, componentMask, Iterator::END);
 }
 
 }  // namespace lonelycube
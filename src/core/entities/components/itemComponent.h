@@ -18,13 +18,17 @@
 
 #pragma once
 
+#include "core/pch.h"
+
 namespace lonelycube {
 
 struct ItemComponent
 {
+    uint8_t blockType;
+    int count;  // Number of items in the stack
     int timer;
 
-    ItemComponent(int timer) : timer(timer) {}
+    ItemComponent(uint8_t blockType, int timer) : blockType(blockType), count(1), timer(timer) {}
 };
 
 }  // namespace lonelycube
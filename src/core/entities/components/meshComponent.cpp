@@ -22,7 +22,8 @@
 
 namespace lonelycube {
 
-MeshComponent::MeshComponent(const Model* model, const uint16_t* faceTextureIndices)
-    : model(model), faceTextureIndices(faceTextureIndices) {}
+MeshComponent::MeshComponent(
+    uint8_t blockType, const Model* model, const uint16_t* faceTextureIndices
+) : blockType(blockType), model(model), faceTextureIndices(faceTextureIndices) {}
 
 }  // namespace lonelycube
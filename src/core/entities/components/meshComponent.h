@@ -26,10 +26,11 @@ namespace lonelycube {
 // Struct that stores a reference to a mesh in an instance of a mesh manager class, as well as a
 // copy of the untranslated vertices
 struct MeshComponent {
+    uint8_t blockType;  // The block whose model and textures the mesh uses
     const Model* model;
     const uint16_t* faceTextureIndices;
 
-    MeshComponent(const Model* model, const uint16_t* faceTextureIndices);
+    MeshComponent(uint8_t blockType, const Model* model, const uint16_t* faceTextureIndices);
 };
 
 }  // namespace lonelycube
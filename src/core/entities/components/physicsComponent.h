@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include "core/pch.h"
+
 #include "core/utils/vec3.h"
 
 namespace lonelycube {
@@ -26,9 +28,11 @@ struct PhysicsComponent
 {
     Vec3 velocity;
     Vec3 angularVelocity;
+    int ticksAtRest;  // The number of consecutive ticks the entity has barely moved for
+    uint64_t sleepTick;  // The physics tick the entity fell asleep on
 
     PhysicsComponent(Vec3 velocity, Vec3 angularVelocity)
-        : velocity(velocity), angularVelocity(angularVelocity) {}
+        : velocity(velocity), angularVelocity(angularVelocity), ticksAtRest(0), sleepTick(0) {}
 };
 
 }  // namespace lonelycube
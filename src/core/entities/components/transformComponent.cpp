@@ -27,17 +27,38 @@ TransformComponent::TransformComponent(IVec3 blockCoords, Vec3 subBlockCoords, f
     rotation) : scale(scale), blockCoords(blockCoords), subBlockCoords(subBlockCoords),
     rotation(rotation)
 {
-    updateTransformMatrix();
+    storePreviousTransform();
 }
 
-void TransformComponent::updateTransformMatrix()
+void TransformComponent::storePreviousTransform()
 {
-    glm::vec3 glmSubBlockCoords(subBlockCoords.x, subBlockCoords.y, subBlockCoords.z);
-    subBlockTransform = glm::translate(glm::mat4(1.0f), glmSubBlockCoords);
-    subBlockTransform = glm::rotate(subBlockTransform, rotation.x, glm::vec3(1.0f, 0.0f, 0.0f));
-    subBlockTransform = glm::rotate(subBlockTransform, rotation.y, glm::vec3(0.0f, 1.0f, 0.0f));
-    subBlockTransform = glm::rotate(subBlockTransform, rotation.z, glm::vec3(0.0f, 0.0f, 1.0f));
-    subBlockTransform *= glm::scale(glm::mat4(1.0f), glm::vec3(scale, scale, scale));
+    previousBlockCoords = blockCoords;
+    previousSubBlockCoords = subBlockCoords;
+    previousRotation = rotation;
+}
+
+glm::mat4 TransformComponent::getInterpolatedTransformMatrix(float alpha) const
+{
+    return getInterpolatedTransformMatrix(
+        alpha, previousRotation + (rotation - previousRotation) * alpha
+    );
+}
+
+glm::mat4 TransformComponent::getInterpolatedTransformMatrix(
+    float alpha, const Vec3& interpolatedRotation
+) const {
+    Vec3 previousPosition = previousSubBlockCoords;
+    for (int axis = 0; axis < 3; axis++)
+        previousPosition[axis] += previousBlockCoords[axis] - blockCoords[axis];
+    Vec3 position = previousPosition + (subBlockCoords - previousPosition) * alpha;
+
+    glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(position.x, position.y,
+        position.z));
+    transform = glm::rotate(transform, interpolatedRotation.x, glm::vec3(1.0f, 0.0f, 0.0f));
+    transform = glm::rotate(transform, interpolatedRotation.y, glm::vec3(0.0f, 1.0f, 0.0f));
+    transform = glm::rotate(transform, interpolatedRotation.z, glm::vec3(0.0f, 0.0f, 1.0f));
+    transform *= glm::scale(glm::mat4(1.0f), glm::vec3(scale, scale, scale));
+    return transform;
 }
 
 }  // namespace lonelycube
@@ -30,10 +30,18 @@ struct TransformComponent
     IVec3 blockCoords;
     Vec3 subBlockCoords;
     Vec3 rotation;
-    glm::mat4 subBlockTransform;
+    // The transform at the end of the previous tick, which is interpolated from when rendering
+    IVec3 previousBlockCoords;
+    Vec3 previousSubBlockCoords;
+    Vec3 previousRotation;
 
     TransformComponent(IVec3 blockCoords, Vec3 subBlockCoords, float scale, Vec3 rotation);
-    void updateTransformMatrix();
+    void storePreviousTransform();
+    // Returns the transform a fraction alpha of the way from the previous tick's transform to
+    // the current one, relative to blockCoords
+    glm::mat4 getInterpolatedTransformMatrix(float alpha) const;
+    // As above, but with the given rotation rather than an interpolated one
+    glm::mat4 getInterpolatedTransformMatrix(float alpha, const Vec3& rotation) const;
 };
 
 }  // namespace lonelycube
@@ -22,14 +22,20 @@
 #include "core/constants.h"
 #include "core/entities/ECS.h"
 #include "core/entities/ECSView.h"
+#include "core/entities/components/awakeComponent.h"
 #include "core/entities/components/itemComponent.h"
 #include "core/entities/components/meshComponent.h"
 #include "core/entities/components/physicsComponent.h"
 #include "core/entities/components/transformComponent.h"
+#include "core/profiler.h"
 #include "core/random.h"
 
 namespace lonelycube {
 
+static constexpr int MAX_STACK_SIZE = 64;
+// Items of the same type closer than this along every axis merge into one stack
+static constexpr float MERGE_DISTANCE = 0.5f;
+
 EntityManager::EntityManager(int maxNumEntities, ChunkManager& chunkManager, const ResourcePack&
     resourcePack)
     : m_ecs(maxNumEntities), m_chunkManager(chunkManager), m_resourcePack(resourcePack),
@@ -50,8 +56,9 @@ void EntityManager::addItem(uint8_t blockType, IVec3 blockCoords, Vec3 subBlockC
     const Model* blockModel = m_resourcePack.getBlockData(blockType).model;
     const uint16_t* textureIndices =
         &m_resourcePack.getBlockData(blockType).faceTextureIndices[0];
-    m_ecs.assign<MeshComponent>(entity, blockModel, textureIndices);
-    m_ecs.assign<ItemComponent>(entity, 3600 * constants::TICKS_PER_SECOND);
+    m_ecs.assign<MeshComponent>(entity, blockType, blockModel, textureIndices);
+    m_ecs.assign<ItemComponent>(entity, blockType, 3600 * constants::TICKS_PER_SECOND);
+    m_physicsEngine.addEntity(entity);
 }
 
 void EntityManager::tickItems()
@@ -60,15 +67,78 @@ void EntityManager::tickItems()
     {
         ItemComponent& itemComponent = m_ecs.get<ItemComponent>(entity);
         if (--itemComponent.timer == 0)
+        {
+            m_physicsEngine.removeEntity(entity);
+            m_ecs.destroyEntity(entity);
+        }
+    }
+}
+
+void EntityManager::mergeItemStacks()
+{
+    m_itemPositions.clear();
+    for (EntityId entity : ECSView<ItemComponent, TransformComponent>(m_ecs))
+    {
+        const TransformComponent transform = m_physicsEngine.getTransform(entity);
+        m_itemPositions.insert(entity, transform.blockCoords, transform.subBlockCoords);
+    }
+
+    // Items that haven't moved can't have come into range of each other, so only awake items
+    // need to look for stacks to join
+    m_itemsToMerge.clear();
+    for (EntityId entity : ECSView<ItemComponent, TransformComponent, AwakeComponent>(m_ecs))
+        m_itemsToMerge.push_back(entity);
+
+    for (EntityId entity : m_itemsToMerge)
+    {
+        if (!m_ecs.isEntityAlive(entity))
+            continue;
+
+        const ItemComponent& item = m_ecs.get<ItemComponent>(entity);
+        const TransformComponent transform = m_physicsEngine.getTransform(entity);
+        bool foundStack = false;
+        EntityId stack;
+        m_itemPositions.forEachNear(transform.blockCoords, transform.subBlockCoords,
+            MERGE_DISTANCE, [&](EntityId other) {
+                if (foundStack || other == entity || !m_ecs.isEntityAlive(other))
+                    return;
+                const ItemComponent& otherItem = m_ecs.get<ItemComponent>(other);
+                if (otherItem.blockType != item.blockType
+                    || otherItem.count + item.count > MAX_STACK_SIZE)
+                    return;
+                const TransformComponent otherTransform = m_physicsEngine.getTransform(other);
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    float distance = otherTransform.blockCoords[axis] - transform.blockCoords[axis]
+                        + otherTransform.subBlockCoords[axis] - transform.subBlockCoords[axis];
+                    if (std::abs(distance) > MERGE_DISTANCE)
+                        return;
+                }
+                foundStack = true;
+                stack = other;
+            }
+        );
+
+        if (foundStack)
+        {
+            // The item joins the other stack, which may already be at rest, rather than the
+            // other way round
+            ItemComponent& stackItem = m_ecs.get<ItemComponent>(stack);
+            stackItem.count += item.count;
+            stackItem.timer = std::max(stackItem.timer, item.timer);
+            m_physicsEngine.removeEntity(entity);
             m_ecs.destroyEntity(entity);
+        }
     }
 }
 
 void EntityManager::tick()
 {
+    PROFILE_ZONE("Entity tick");
     std::lock_guard<std::mutex> lock1(m_ecs.mutex);
     tickItems();
     m_physicsEngine.stepPhysics();
+    mergeItemStacks();
 }
 
 }  // namespace lonelycube
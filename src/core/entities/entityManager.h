@@ -21,6 +21,7 @@
 #include "core/chunkManager.h"
 #include "core/entities/ECS.h"
 #include "core/entities/physicsEngine.h"
+#include "core/entities/spatialHash.h"
 #include "core/resourcePack.h"
 #include "core/utils/iVec3.h"
 #include "core/utils/vec3.h"
@@ -34,8 +35,11 @@ private:
     const ResourcePack& m_resourcePack;
 
     PhysicsEngine m_physicsEngine;
+    SpatialHash m_itemPositions;
+    std::vector<EntityId> m_itemsToMerge;
 
     void tickItems();
+    void mergeItemStacks();
 
 public:
     EntityManager(int maxNumEntities, ChunkManager& chunkManager, const ResourcePack& resourcePack);
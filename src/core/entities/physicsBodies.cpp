@@ -0,0 +1,126 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "core/entities/physicsBodies.h"
+
+#include "core/pch.h"
+
+namespace lonelycube {
+
+static constexpr float GRAVITY = 20.0f;
+static constexpr float DRAG = 0.98f;
+
+void PhysicsBodies::add(
+    const EntityId entity, const PhysicsComponent& physics, const TransformComponent& transform
+) {
+    EntityIndex index = ECS::getEntityIndex(entity);
+    if (index >= m_sparse.size())
+        m_sparse.resize(index + 1, NOT_A_BODY);
+    m_sparse[index] = entities.size();
+    entities.push_back(entity);
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        blockCoords[axis].push_back(transform.blockCoords[axis]);
+        subBlockCoords[axis].push_back(transform.subBlockCoords[axis]);
+        rotation[axis].push_back(transform.rotation[axis]);
+        previousBlockCoords[axis].push_back(transform.previousBlockCoords[axis]);
+        previousSubBlockCoords[axis].push_back(transform.previousSubBlockCoords[axis]);
+        previousRotation[axis].push_back(transform.previousRotation[axis]);
+        velocity[axis].push_back(physics.velocity[axis]);
+        angularVelocity[axis].push_back(physics.angularVelocity[axis]);
+    }
+}
+
+template<typename T>
+static void removeSwapped(std::vector<T>& values, const size_t index)
+{
+    values[index] = values.back();
+    values.pop_back();
+}
+
+void PhysicsBodies::remove(
+    const EntityId entity, PhysicsComponent& physics, TransformComponent& transform
+) {
+    const size_t body = getBody(entity);
+    getTransform(body, transform);
+    for (int axis = 0; axis < 3; axis++)
+    {
+        physics.velocity[axis] = velocity[axis][body];
+        physics.angularVelocity[axis] = angularVelocity[axis][body];
+    }
+
+    m_sparse[ECS::getEntityIndex(entity)] = NOT_A_BODY;
+    removeSwapped(entities, body);
+    if (body < entities.size())
+        m_sparse[ECS::getEntityIndex(entities[body])] = body;
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        removeSwapped(blockCoords[axis], body);
+        removeSwapped(subBlockCoords[axis], body);
+        removeSwapped(rotation[axis], body);
+        removeSwapped(previousBlockCoords[axis], body);
+        removeSwapped(previousSubBlockCoords[axis], body);
+        removeSwapped(previousRotation[axis], body);
+        removeSwapped(velocity[axis], body);
+        removeSwapped(angularVelocity[axis], body);
+    }
+}
+
+void PhysicsBodies::storePreviousTransforms()
+{
+    for (int axis = 0; axis < 3; axis++)
+    {
+        previousBlockCoords[axis] = blockCoords[axis];
+        previousSubBlockCoords[axis] = subBlockCoords[axis];
+        previousRotation[axis] = rotation[axis];
+    }
+}
+
+void PhysicsBodies::integrate(const float DT)
+{
+    const float gravity[3] = { 0.0f, GRAVITY * DT, 0.0f };
+    for (int axis = 0; axis < 3; axis++)
+    {
+        float* __restrict bodyVelocity = velocity[axis].data();
+        float* __restrict bodyRotation = rotation[axis].data();
+        const float* __restrict bodyAngularVelocity = angularVelocity[axis].data();
+        for (size_t i = 0; i < entities.size(); i++)
+        {
+            bodyVelocity[i] = (bodyVelocity[i] - gravity[axis]) * DRAG;
+            bodyRotation[i] += bodyAngularVelocity[i] * DT;
+        }
+    }
+}
+
+void PhysicsBodies::getTransform(const size_t body, TransformComponent& transform) const
+{
+    for (int axis = 0; axis < 3; axis++)
+    {
+        transform.blockCoords[axis] = blockCoords[axis][body];
+        transform.subBlockCoords[axis] = subBlockCoords[axis][body];
+        transform.rotation[axis] = rotation[axis][body];
+        transform.previousBlockCoords[axis] = previousBlockCoords[axis][body];
+        transform.previousSubBlockCoords[axis] = previousSubBlockCoords[axis][body];
+        transform.previousRotation[axis] = previousRotation[axis][body];
+    }
+}
+
+}  // namespace lonelycube
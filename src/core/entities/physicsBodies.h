@@ -0,0 +1,86 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "core/pch.h"
+
+#include "core/entities/ECS.h"
+#include "core/entities/components/physicsComponent.h"
+#include "core/entities/components/transformComponent.h"
+
+namespace lonelycube {
+
+// The state of every entity that the physics engine is simulating, with each coordinate in its
+// own array so that integrating them is a few simple loops over contiguous floats that the
+// compiler turns into SIMD instructions. Entities are added when they wake up and removed when
+// they fall asleep or are destroyed, and while an entity is here its position, rotation and
+// velocity here are the current ones rather than those in its components.
+class PhysicsBodies
+{
+private:
+    static constexpr uint32_t NOT_A_BODY = std::numeric_limits<uint32_t>::max();
+
+    // The body of each entity, indexed by entity index
+    std::vector<uint32_t> m_sparse;
+
+public:
+    std::vector<EntityId> entities;
+    std::array<std::vector<int>, 3> blockCoords;
+    std::array<std::vector<float>, 3> subBlockCoords;
+    std::array<std::vector<float>, 3> rotation;
+    // The transform at the end of the previous tick, which is interpolated from when rendering
+    std::array<std::vector<int>, 3> previousBlockCoords;
+    std::array<std::vector<float>, 3> previousSubBlockCoords;
+    std::array<std::vector<float>, 3> previousRotation;
+    std::array<std::vector<float>, 3> velocity;
+    std::array<std::vector<float>, 3> angularVelocity;
+
+    void add(
+        const EntityId entity, const PhysicsComponent& physics, const TransformComponent& transform
+    );
+    // Writes the body's state to the entity's components and removes it. The last body is moved
+    // into its place.
+    void remove(const EntityId entity, PhysicsComponent& physics, TransformComponent& transform);
+    void storePreviousTransforms();
+    // Applies gravity and drag to every body and spins it
+    void integrate(const float DT);
+    // Copies the body's current and previous transforms into the given component
+    void getTransform(const size_t body, TransformComponent& transform) const;
+
+    inline bool contains(const EntityId entity) const
+    {
+        EntityIndex index = ECS::getEntityIndex(entity);
+        return index < m_sparse.size() && m_sparse[index] != NOT_A_BODY
+            && entities[m_sparse[index]] == entity;
+    }
+
+    // The entity must have a body
+    inline size_t getBody(const EntityId entity) const
+    {
+        return m_sparse[ECS::getEntityIndex(entity)];
+    }
+
+    inline size_t size() const
+    {
+        return entities.size();
+    }
+};
+
+}  // namespace lonelycube
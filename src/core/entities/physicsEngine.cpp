@@ -21,25 +21,56 @@
 #include "core/constants.h"
 #include "core/entities/ECS.h"
 #include "core/entities/ECSView.h"
+#include "core/entities/components/awakeComponent.h"
 #include "core/entities/components/meshComponent.h"
 #include "core/entities/components/physicsComponent.h"
 #include "core/entities/components/transformComponent.h"
 #include "core/log.h"
+#include "core/profiler.h"
 #include "core/random.h"
 #include "core/resourcePack.h"
 
 namespace lonelycube {
 
+static constexpr size_t MIN_ENTITIES_PER_RANGE = 64;
+// Entities are put to sleep once their speed has stayed below SLEEP_SPEED for SLEEP_TICKS
+static constexpr float SLEEP_SPEED = 0.05f;
+static constexpr int SLEEP_TICKS = constants::TICKS_PER_SECOND;
+
 PhysicsEngine::PhysicsEngine(
     ChunkManager& chunkManager, ECS& ecs, const ResourcePack& resourcePack
-) : m_chunkManager(chunkManager), m_ecs(ecs), m_resourcePack(resourcePack) {}
+) : m_chunkManager(chunkManager), m_ecs(ecs), m_resourcePack(resourcePack),
+    m_workerPool(std::max(1u, std::thread::hardware_concurrency())), m_tickNum(0) {}
 
-void PhysicsEngine::stepPhysics(const EntityId entity, const float DT
-) {
-    TransformComponent& transform = m_ecs.get<TransformComponent>(entity);
-    PhysicsComponent& physics = m_ecs.get<PhysicsComponent>(entity);
-    transform.rotation += physics.angularVelocity * DT;
-    if (entityCollidingWithWorld(entity))
+template<typename Function>
+static void forEachBlockInBox(const IVec3& minBlock, const IVec3& maxBlock, Function function)
+{
+    IVec3 block;
+    for (block.x = minBlock.x; block.x <= maxBlock.x; block.x++)
+    {
+        for (block.y = minBlock.y; block.y <= maxBlock.y; block.y++)
+        {
+            for (block.z = minBlock.z; block.z <= maxBlock.z; block.z++)
+                function(block);
+        }
+    }
+}
+
+void PhysicsEngine::stepPhysics(const size_t body, const float DT, WorldCursor& cursor)
+{
+    const EntityId entity = m_bodies.entities[body];
+    IVec3 blockCoords(
+        m_bodies.blockCoords[0][body], m_bodies.blockCoords[1][body],
+        m_bodies.blockCoords[2][body]
+    );
+    Vec3 subBlockCoords(
+        m_bodies.subBlockCoords[0][body], m_bodies.subBlockCoords[1][body],
+        m_bodies.subBlockCoords[2][body]
+    );
+    Vec3 velocity(
+        m_bodies.velocity[0][body], m_bodies.velocity[1][body], m_bodies.velocity[2][body]
+    );
+    if (entityCollidingWithWorld(entity, blockCoords, subBlockCoords, cursor))
     {
         float minPenetrationDepth = 100000.0f;
         int axisOfLeastPenetration = 1;
@@ -48,13 +79,12 @@ void PhysicsEngine::stepPhysics(const EntityId entity, const float DT
         {
             for (int direction = -1; direction <= 1; direction += 2)
             {
-                IVec3 neighbouringBlock = transform.blockCoords;
-                neighbouringBlock[axis] -= direction;
-                if (!m_resourcePack.getBlockData(m_chunkManager.getBlock(
-                        neighbouringBlock)).collidable
-                ) {
+                cursor.moveTo(blockCoords);
+                cursor.move(axis, -direction);
+                if (!m_resourcePack.isCollidable(cursor.getBlock()))
+                {
                     float penetrationDepth = findPenetrationDepthIntoWorld(
-                        entity, axis, direction * 0.001f
+                        entity, blockCoords, subBlockCoords, axis, direction * 0.001f, cursor
                     );
                     if (penetrationDepth < minPenetrationDepth && penetrationDepth != 0.0f)
                     {
@@ -65,64 +95,237 @@ void PhysicsEngine::stepPhysics(const EntityId entity, const float DT
                 }
             }
         }
-        physics.velocity = Vec3(0.0f, 0.0f, 0.0f);
-        physics.velocity[axisOfLeastPenetration] += directionToResolve * 50.0f /
+        velocity = Vec3(0.0f, 0.0f, 0.0f);
+        velocity[axisOfLeastPenetration] += directionToResolve * 50.0f /
             constants::TICKS_PER_SECOND;
-        transform.subBlockCoords[axisOfLeastPenetration] +=
-            physics.velocity[axisOfLeastPenetration] * DT;
-
-        return;
+        subBlockCoords[axisOfLeastPenetration] += velocity[axisOfLeastPenetration] * DT;
     }
-
-    physics.velocity.y -= 20.0f * DT;
-    physics.velocity *= 0.98f;
-    for (int axis = 0; axis < 3; axis++)
+    else
     {
-        transform.subBlockCoords[axis] += physics.velocity[axis] * DT;
-        if (entityCollidingWithWorld(entity))
+        for (int axis = 0; axis < 3; axis++)
         {
-            transform.subBlockCoords[axis] += (findPenetrationDepthIntoWorld(
-                entity, axis, physics.velocity[axis] * DT
-            ) + 0.0001f) * (physics.velocity[axis] > 0 ? -1 : 1);
+            subBlockCoords[axis] += velocity[axis] * DT;
+            if (entityCollidingWithWorld(entity, blockCoords, subBlockCoords, cursor))
+            {
+                subBlockCoords[axis] += (findPenetrationDepthIntoWorld(
+                    entity, blockCoords, subBlockCoords, axis, velocity[axis] * DT, cursor
+                ) + 0.0001f) * (velocity[axis] > 0 ? -1 : 1);
 
-            physics.velocity[axis] = 0.0f;  // -0.2f * physics.velocity[axis];
-            if (axis == 1)
+                velocity[axis] = 0.0f;  // -0.2f * velocity[axis];
+                if (axis == 1)
+                {
+                    velocity[0] *= 0.6f;
+                    velocity[2] *= 0.6f;
+                }
+            }
+            else
             {
-                physics.velocity[0] *= 0.6f;
-                physics.velocity[2] *= 0.6f;
+                int carry = static_cast<int>(std::floor(subBlockCoords[axis]));
+                subBlockCoords[axis] -= carry;
+                blockCoords[axis] += carry;
             }
         }
-        else
-        {
-            int carry = static_cast<int>(std::floor(transform.subBlockCoords[axis]));
-            transform.subBlockCoords[axis] -= carry;
-            transform.blockCoords[axis] += carry;
-        }
+    }
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        m_bodies.blockCoords[axis][body] = blockCoords[axis];
+        m_bodies.subBlockCoords[axis][body] = subBlockCoords[axis];
+        m_bodies.velocity[axis][body] = velocity[axis];
     }
 }
 
 void PhysicsEngine::stepPhysics()
 {
-    std::lock_guard<std::mutex> lock2(m_chunkManager.mutex);
+    PROFILE_ZONE("Step physics");
+    // Physics only reads blocks, so chunk loaders that just need to look up chunks aren't held
+    // up while it runs
+    std::shared_lock<std::shared_mutex> lock2(m_chunkManager.mutex);
     const float DT = 1.0f / constants::TICKS_PER_SECOND;
-    for (EntityId entity : ECSView<TransformComponent, PhysicsComponent>(m_ecs))
+    wakeEntitiesNearChangedBlocks();
+    m_tickNum++;
+
+    // Keep the last tick's transforms so that the renderer can interpolate between the two.
+    // Entities that fell asleep last tick need them too, so that they are drawn at rest from
+    // now on
+    for (EntityId entity : m_entitiesFallenAsleep)
+    {
+        if (m_ecs.isEntityAlive(entity))
+            m_ecs.get<TransformComponent>(entity).storePreviousTransform();
+    }
+    m_entitiesFallenAsleep.clear();
+    m_bodies.storePreviousTransforms();
+
+    // Gravity, drag and spinning are applied to every awake entity at once before each one is
+    // moved and collided with the world on its own. Entities stuck in the world have their
+    // velocity replaced, so they can be integrated along with the rest
+    m_bodies.integrate(DT);
+
+    const size_t numAwake = m_bodies.size();
+    m_entitiesAtRest.resize(numAwake);
+
+    // Stepping a body only writes to that body and its entity's PhysicsComponent, so bodies can
+    // be stepped in parallel
+    m_workerPool.parallelFor(numAwake, MIN_ENTITIES_PER_RANGE,
+        [&](size_t begin, size_t end) {
+            // Entities that woke up together are often near each other in the world, so share
+            // a cursor between them so that they can reuse the chunks it has found
+            WorldCursor cursor(m_chunkManager);
+            for (size_t i = begin; i < end; i++)
+            {
+                stepPhysics(i, DT, cursor);
+
+                float speedSquared = 0.0f;
+                for (int axis = 0; axis < 3; axis++)
+                    speedSquared += m_bodies.velocity[axis][i] * m_bodies.velocity[axis][i];
+                PhysicsComponent& physics = m_ecs.get<PhysicsComponent>(m_bodies.entities[i]);
+                if (speedSquared < SLEEP_SPEED * SLEEP_SPEED)
+                    physics.ticksAtRest++;
+                else
+                    physics.ticksAtRest = 0;
+                m_entitiesAtRest[i] = physics.ticksAtRest >= SLEEP_TICKS;
+            }
+        }
+    );
+
+    // Components can't be removed while other threads are reading the ECS, and putting an
+    // entity to sleep moves another body into its place
+    m_entitiesFallingAsleep.clear();
+    for (size_t i = 0; i < numAwake; i++)
     {
-        stepPhysics(entity, DT);
-        TransformComponent& transform = m_ecs.get<TransformComponent>(entity);
-        transform.updateTransformMatrix();
+        if (m_entitiesAtRest[i])
+            m_entitiesFallingAsleep.push_back(m_bodies.entities[i]);
     }
+    for (EntityId entity : m_entitiesFallingAsleep)
+        putToSleep(entity);
+}
+
+void PhysicsEngine::putToSleep(const EntityId entity)
+{
+    PhysicsComponent& physics = m_ecs.get<PhysicsComponent>(entity);
+    TransformComponent& transform = m_ecs.get<TransformComponent>(entity);
+    m_bodies.remove(entity, physics, transform);
+    physics.velocity = Vec3(0.0f, 0.0f, 0.0f);
+    physics.sleepTick = m_tickNum;
+    m_ecs.remove<AwakeComponent>(entity);
+    m_entitiesFallenAsleep.push_back(entity);
+
+    IVec3 minBlock, maxBlock;
+    getBlocksOverlapped(
+        entity, transform.blockCoords, transform.subBlockCoords, &minBlock, &maxBlock
+    );
+    forEachBlockInBox(minBlock, maxBlock, [&](const IVec3& block) {
+        m_sleepingEntities.insert(entity, block);
+    });
+}
+
+void PhysicsEngine::addEntity(const EntityId entity)
+{
+    m_ecs.assign<AwakeComponent>(entity);
+    m_bodies.add(
+        entity, m_ecs.get<PhysicsComponent>(entity), m_ecs.get<TransformComponent>(entity)
+    );
+}
+
+void PhysicsEngine::wakeEntity(const EntityId entity)
+{
+    m_ecs.get<PhysicsComponent>(entity).ticksAtRest = 0;
+    if (m_ecs.entityHasComponent<AwakeComponent>(entity))
+        return;
+
+    removeEntity(entity);
+    // Catch up on the spinning that wasn't simulated while the entity was asleep
+    Vec3 previousRotation = getSleepingRotation(entity, 0.0f);
+    Vec3 rotation = getSleepingRotation(entity, 1.0f);
+    TransformComponent& transform = m_ecs.get<TransformComponent>(entity);
+    transform.previousRotation = previousRotation;
+    transform.rotation = rotation;
+    addEntity(entity);
 }
 
-bool PhysicsEngine::entityCollidingWithWorld(const EntityId entity)
+void PhysicsEngine::removeEntity(const EntityId entity)
 {
+    if (m_ecs.entityHasComponent<AwakeComponent>(entity))
+    {
+        m_bodies.remove(
+            entity, m_ecs.get<PhysicsComponent>(entity), m_ecs.get<TransformComponent>(entity)
+        );
+        return;
+    }
+
     const TransformComponent& transform = m_ecs.get<TransformComponent>(entity);
+    IVec3 minBlock, maxBlock;
+    getBlocksOverlapped(
+        entity, transform.blockCoords, transform.subBlockCoords, &minBlock, &maxBlock
+    );
+    forEachBlockInBox(minBlock, maxBlock, [&](const IVec3& block) {
+        m_sleepingEntities.remove(entity, block);
+    });
+}
+
+Vec3 PhysicsEngine::getSleepingRotation(const EntityId entity, const float alpha)
+{
+    const PhysicsComponent& physics = m_ecs.get<PhysicsComponent>(entity);
+    float ticksAsleep = static_cast<float>(m_tickNum - physics.sleepTick) - 1.0f + alpha;
+    return m_ecs.get<TransformComponent>(entity).rotation
+        + physics.angularVelocity * (ticksAsleep / constants::TICKS_PER_SECOND);
+}
+
+TransformComponent PhysicsEngine::getTransform(const EntityId entity)
+{
+    TransformComponent transform = m_ecs.get<TransformComponent>(entity);
+    if (m_bodies.contains(entity))
+        m_bodies.getTransform(m_bodies.getBody(entity), transform);
+    return transform;
+}
+
+void PhysicsEngine::wakeEntitiesNearChangedBlocks()
+{
+    bool allChangesTracked = m_chunkManager.takeChangedBlocks(m_changedBlocks);
+    if (!allChangesTracked)
+    {
+        // Too many blocks changed to keep track of them all, so wake every sleeping entity
+        for (EntityId entity : ECSView<TransformComponent, PhysicsComponent>(m_ecs))
+        {
+            if (!m_ecs.entityHasComponent<AwakeComponent>(entity))
+                wakeEntity(entity);
+        }
+        return;
+    }
+
+    // Sleeping entities are in the cell of every block they overlap, so those resting on or
+    // next to a changed block are in the cells around it
+    m_entitiesToWake.clear();
+    for (const IVec3& block : m_changedBlocks)
+    {
+        m_sleepingEntities.forEachNear(block, Vec3(0.5f), 1.0f, [&](EntityId entity) {
+            m_entitiesToWake.push_back(entity);
+        });
+    }
+    for (EntityId entity : m_entitiesToWake)
+        wakeEntity(entity);
+}
+
+void PhysicsEngine::getBlocksOverlapped(
+    const EntityId entity, const IVec3& blockCoords, const Vec3& subBlockCoords,
+    IVec3* minBlock, IVec3* maxBlock
+) {
+    const float scale = m_ecs.get<TransformComponent>(entity).scale;
     const Model* entityModel = m_ecs.get<MeshComponent>(entity).model;
     Vec3 minVertex(entityModel->boundingBoxVertices);
     Vec3 maxVertex(entityModel->boundingBoxVertices + 15);
-    minVertex = minVertex * transform.scale + transform.subBlockCoords;
-    maxVertex = maxVertex * transform.scale + transform.subBlockCoords;
-    IVec3 minBlock = IVec3(minVertex) + transform.blockCoords;
-    IVec3 maxBlock = IVec3(maxVertex) + transform.blockCoords;
+    minVertex = minVertex * scale + subBlockCoords;
+    maxVertex = maxVertex * scale + subBlockCoords;
+    *minBlock = IVec3(minVertex) + blockCoords;
+    *maxBlock = IVec3(maxVertex) + blockCoords;
+}
+
+bool PhysicsEngine::entityCollidingWithWorld(
+    const EntityId entity, const IVec3& blockCoords, const Vec3& subBlockCoords,
+    WorldCursor& cursor
+) {
+    IVec3 minBlock, maxBlock;
+    getBlocksOverlapped(entity, blockCoords, subBlockCoords, &minBlock, &maxBlock);
 
     bool colliding = false;
     IVec3 block;
@@ -130,9 +333,11 @@ bool PhysicsEngine::entityCollidingWithWorld(const EntityId entity)
     {
         for (block.x = minBlock.x; block.x <= maxBlock.x && !colliding; block.x++)
         {
+            cursor.moveTo(IVec3(block.x, block.y, minBlock.z));
             for (block.z = minBlock.z; block.z <= maxBlock.z && !colliding; block.z++)
             {
-                colliding = m_resourcePack.getBlockData(m_chunkManager.getBlock(block)).collidable;
+                colliding = m_resourcePack.isCollidable(cursor.getBlock());
+                cursor.move(2, 1);
             }
         }
     }
@@ -141,22 +346,23 @@ bool PhysicsEngine::entityCollidingWithWorld(const EntityId entity)
 }
 
 float PhysicsEngine::findPenetrationDepthIntoWorld(
-    const EntityId entity, const int axis, const float displacementAlongAxis
+    const EntityId entity, const IVec3& blockCoords, const Vec3& subBlockCoords,
+    const int axis, const float displacementAlongAxis, WorldCursor& cursor
 ) {
-    const TransformComponent& transform = m_ecs.get<TransformComponent>(entity);
+    const float scale = m_ecs.get<TransformComponent>(entity).scale;
     const Model* entityModel = m_ecs.get<MeshComponent>(entity).model;
     const int direction = displacementAlongAxis > 0 ? 1 : -1;
     Vec3 minVertex(entityModel->boundingBoxVertices);
     Vec3 maxVertex(entityModel->boundingBoxVertices + 15);
-    minVertex = minVertex * transform.scale + transform.subBlockCoords;
-    maxVertex = maxVertex * transform.scale + transform.subBlockCoords;
-    IVec3 minBlock = IVec3(minVertex) + transform.blockCoords;
-    IVec3 maxBlock = IVec3(maxVertex) + transform.blockCoords;
+    minVertex = minVertex * scale + subBlockCoords;
+    maxVertex = maxVertex * scale + subBlockCoords;
+    IVec3 minBlock = IVec3(minVertex) + blockCoords;
+    IVec3 maxBlock = IVec3(maxVertex) + blockCoords;
 
     std::array<int, 2> p{ (axis + 1) % 3, (axis + 2) % 3 };  // perpendicular axes
     int startBlock = displacementAlongAxis > 0 ?
-        static_cast<int>(maxVertex[axis] - displacementAlongAxis) + transform.blockCoords[axis] :
-        static_cast<int>(minVertex[axis] - displacementAlongAxis) + transform.blockCoords[axis];
+        static_cast<int>(maxVertex[axis] - displacementAlongAxis) + blockCoords[axis] :
+        static_cast<int>(minVertex[axis] - displacementAlongAxis) + blockCoords[axis];
     int endBlock = displacementAlongAxis > 0 ? maxBlock[axis] : minBlock[axis];
     IVec3 block;
     float penetrationDepth = 0.0f;
@@ -167,9 +373,11 @@ float PhysicsEngine::findPenetrationDepthIntoWorld(
     ) {
         for (block[p[0]] = minBlock[p[0]]; block[p[0]] <= maxBlock[p[0]]; block[p[0]]++)
         {
-            for (block[p[1]] = minBlock[p[1]]; block[p[1]] <= maxBlock[p[1]]; block[p[1]]++)
+            block[p[1]] = minBlock[p[1]];
+            cursor.moveTo(block);
+            for (; block[p[1]] <= maxBlock[p[1]]; block[p[1]]++, cursor.move(p[1], 1))
             {
-                if (m_resourcePack.getBlockData(m_chunkManager.getBlock(block)).collidable)
+                if (m_resourcePack.isCollidable(cursor.getBlock()))
                 {
                     float depth;
                     if (displacementAlongAxis > 0)
@@ -186,30 +394,4 @@ float PhysicsEngine::findPenetrationDepthIntoWorld(
     return penetrationDepth;
 }
 
-void PhysicsEngine::extrapolateTransforms(const float DT)
-{
-    std::lock_guard<std::mutex> lock1(m_ecs.mutex);
-    // std::lock_guard<std::mutex> lock2(m_chunkManager.mutex);
-    for (EntityId entity : ECSView<TransformComponent, PhysicsComponent>(m_ecs))
-    {
-        TransformComponent& transform = m_ecs.get<TransformComponent>(entity);
-        PhysicsComponent& physics = m_ecs.get<PhysicsComponent>(entity);
-        IVec3 oldBlockCoords = transform.blockCoords;
-        Vec3 oldSubBlockCoords = transform.subBlockCoords;
-        Vec3 oldRotation = transform.rotation;
-        Vec3 oldVelocity = physics.velocity;
-
-        stepPhysics(entity, DT);
-        transform.subBlockCoords.x += transform.blockCoords.x - oldBlockCoords.x;
-        transform.subBlockCoords.y += transform.blockCoords.y - oldBlockCoords.y;
-        transform.subBlockCoords.z += transform.blockCoords.z - oldBlockCoords.z;
-        transform.updateTransformMatrix();
-
-        transform.blockCoords = oldBlockCoords;
-        transform.subBlockCoords = oldSubBlockCoords;
-        transform.rotation = oldRotation;
-        physics.velocity = oldVelocity;
-    }
-}
-
 }  // namespace lonelycube
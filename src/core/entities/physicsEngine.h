@@ -20,7 +20,12 @@
 
 #include "core/chunkManager.h"
 #include "core/entities/ECS.h"
+#include "core/entities/components/transformComponent.h"
+#include "core/entities/physicsBodies.h"
+#include "core/entities/spatialHash.h"
 #include "core/resourcePack.h"
+#include "core/workerPool.h"
+#include "core/worldCursor.h"
 
 namespace lonelycube {
 
@@ -30,17 +35,51 @@ private:
     ChunkManager& m_chunkManager;
     ECS& m_ecs;
     const ResourcePack& m_resourcePack;
+    WorkerPool m_workerPool;
+    PhysicsBodies m_bodies;
+    std::vector<uint8_t> m_entitiesAtRest;
+    std::vector<IVec3> m_changedBlocks;
+    // Every sleeping entity, in the cell of each block its bounding box overlaps
+    SpatialHash m_sleepingEntities;
+    std::vector<EntityId> m_entitiesToWake;
+    std::vector<EntityId> m_entitiesFallingAsleep;
+    std::vector<EntityId> m_entitiesFallenAsleep;
+    uint64_t m_tickNum;
 
-    void stepPhysics(const EntityId entity, const float DT);
-    bool entityCollidingWithWorld(const EntityId entity);
+    void stepPhysics(const size_t body, const float DT, WorldCursor& cursor);
+    // The entity's scale and model are read from its components, but its position is given so
+    // that it can be read from the entity's body while it's awake
+    void getBlocksOverlapped(
+        const EntityId entity, const IVec3& blockCoords, const Vec3& subBlockCoords,
+        IVec3* minBlock, IVec3* maxBlock
+    );
+    void putToSleep(const EntityId entity);
+    void wakeEntitiesNearChangedBlocks();
+    bool entityCollidingWithWorld(
+        const EntityId entity, const IVec3& blockCoords, const Vec3& subBlockCoords,
+        WorldCursor& cursor
+    );
     float findPenetrationDepthIntoWorld(
-        const EntityId entity, const int axis, const float displacementAlongAxis
+        const EntityId entity, const IVec3& blockCoords, const Vec3& subBlockCoords,
+        const int axis, const float displacementAlongAxis, WorldCursor& cursor
     );
 
 public:
     PhysicsEngine(ChunkManager& chunkManager, ECS& ecs, const ResourcePack& resourcePack);
     void stepPhysics();
-    void extrapolateTransforms(const float DT);
+    // Starts simulating an entity that has just been given a TransformComponent,
+    // PhysicsComponent and MeshComponent
+    void addEntity(const EntityId entity);
+    void wakeEntity(const EntityId entity);
+    // Must be called before an entity with a PhysicsComponent is destroyed
+    void removeEntity(const EntityId entity);
+    // Sleeping entities keep spinning, but their rotation is only worked out when it's needed.
+    // Returns the rotation of a sleeping entity a fraction alpha of the way from the previous
+    // tick to the current one.
+    Vec3 getSleepingRotation(const EntityId entity, const float alpha);
+    // The TransformComponent of an awake entity is out of date, so its transform must be read
+    // through here. Works for any entity with a TransformComponent.
+    TransformComponent getTransform(const EntityId entity);
 };
 
 }  // namespace lonelycube
@@ -0,0 +1,74 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/entities/spatialHash.h"
+
+#include "core/pch.h"
+
+namespace lonelycube {
+
+SpatialHash::SpatialHash() : m_buckets(1 << NUM_BUCKETS_LOG2, END_OF_BUCKET) {}
+
+void SpatialHash::clear()
+{
+    std::fill(m_buckets.begin(), m_buckets.end(), END_OF_BUCKET);
+    m_entries.clear();
+    m_freeEntries.clear();
+}
+
+void SpatialHash::insert(
+    const EntityId entity, const IVec3& blockCoords, const Vec3& subBlockCoords
+) {
+    insert(entity, IVec3(subBlockCoords) + blockCoords);
+}
+
+void SpatialHash::insert(const EntityId entity, const IVec3& cell)
+{
+    uint32_t bucket = getBucket(cell);
+    uint32_t entryIndex;
+    if (m_freeEntries.empty())
+    {
+        entryIndex = m_entries.size();
+        m_entries.push_back({ entity, cell, m_buckets[bucket] });
+    }
+    else
+    {
+        entryIndex = m_freeEntries.back();
+        m_freeEntries.pop_back();
+        m_entries[entryIndex] = { entity, cell, m_buckets[bucket] };
+    }
+    m_buckets[bucket] = entryIndex;
+}
+
+void SpatialHash::remove(const EntityId entity, const IVec3& cell)
+{
+    uint32_t* link = &m_buckets[getBucket(cell)];
+    while (*link != END_OF_BUCKET)
+    {
+        Entry& entry = m_entries[*link];
+        if (entry.entity == entity && entry.cell == cell)
+        {
+            m_freeEntries.push_back(*link);
+            *link = entry.next;
+            return;
+        }
+        link = &entry.next;
+    }
+}
+
+}  // namespace lonelycube
@@ -0,0 +1,102 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+#include "core/entities/ECS.h"
+#include "core/utils/iVec3.h"
+#include "core/utils/vec3.h"
+
+namespace lonelycube {
+
+// A uniform grid of block sized cells over entity positions. The cells are stored in a hash
+// table with a fixed number of buckets, each holding a linked list of the entities in the cells
+// that hash to it, so clearing and refilling the grid every tick doesn't allocate. Removed
+// entries are reused by later insertions.
+class SpatialHash
+{
+private:
+    static constexpr int NUM_BUCKETS_LOG2 = 12;
+    static constexpr uint32_t END_OF_BUCKET = UINT32_MAX;
+
+    struct Entry
+    {
+        EntityId entity;
+        IVec3 cell;
+        uint32_t next;
+    };
+
+    std::vector<uint32_t> m_buckets;
+    std::vector<Entry> m_entries;
+    std::vector<uint32_t> m_freeEntries;
+
+    inline static uint32_t getBucket(const IVec3& cell)
+    {
+        return (std::hash<IVec3>{}(cell) * 0x9e3779b97f4a7c15ull) >> (64 - NUM_BUCKETS_LOG2);
+    }
+
+public:
+    SpatialHash();
+    void clear();
+    void insert(const EntityId entity, const IVec3& blockCoords, const Vec3& subBlockCoords);
+    void insert(const EntityId entity, const IVec3& cell);
+    // Removes one entry for the entity from the cell, if it has one
+    void remove(const EntityId entity, const IVec3& cell);
+
+    // Calls function(entity) for every entity in a cell that overlaps the cube with the given
+    // half-width around the position. Entities further than radius away may be included.
+    template<typename Function>
+    void forEachNear(
+        const IVec3& blockCoords, const Vec3& subBlockCoords, float radius, Function function
+    ) const;
+
+    inline size_t size() const
+    {
+        return m_entries.size() - m_freeEntries.size();
+    }
+};
+
+template<typename Function>
+void SpatialHash::forEachNear(
+    const IVec3& blockCoords, const Vec3& subBlockCoords, float radius, Function function
+) const {
+    IVec3 minCell = IVec3(subBlockCoords - Vec3(radius)) + blockCoords;
+    IVec3 maxCell = IVec3(subBlockCoords + Vec3(radius)) + blockCoords;
+    IVec3 cell;
+    for (cell.x = minCell.x; cell.x <= maxCell.x; cell.x++)
+    {
+        for (cell.y = minCell.y; cell.y <= maxCell.y; cell.y++)
+        {
+            for (cell.z = minCell.z; cell.z <= maxCell.z; cell.z++)
+            {
+                uint32_t entryIndex = m_buckets[getBucket(cell)];
+                while (entryIndex != END_OF_BUCKET)
+                {
+                    const Entry& entry = m_entries[entryIndex];
+                    if (entry.cell == cell)
+                        function(entry.entity);
+                    entryIndex = entry.next;
+                }
+            }
+        }
+    }
+}
+
+}  // namespace lonelycube
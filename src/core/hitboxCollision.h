@@ -0,0 +1,137 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+#include "core/utils/iVec3.h"
+#include "core/utils/vec3.h"
+
+namespace lonelycube {
+
+struct HitboxContacts
+{
+    bool touchingGround;
+    bool touchingWater;
+};
+
+// Moves an axis-aligned box, whose minimum corner is at minBlock + minOffset, by velocity * DT,
+// one axis at a time (y, then x, then z). Along each axis only the layers of blocks that the
+// leading face of the box is in or crosses are checked, so the box can't pass through blocks
+// however fast it moves. It stops flush against the first layer with a collidable block in it,
+// and its velocity along that axis is set to zero. If the box already overlaps a collidable
+// block at its leading face (e.g. one was placed inside it), it doesn't move along that axis.
+//
+// getBlock(const IVec3&) returns the block type at a position and isCollidable(blockType) says
+// whether the box collides with it. Water only counts as touched once it reaches
+// waterEntryHeight above the bottom of the box, unless the box was already touching water.
+template<typename GetBlock, typename IsCollidable>
+HitboxContacts moveHitbox(
+    IVec3& minBlock, Vec3& minOffset, const Vec3& size, Vec3& velocity, float DT,
+    bool wasTouchingWater, float waterEntryHeight, GetBlock getBlock, IsCollidable isCollidable
+) {
+    // Stops faces that are exactly flush with a block from counting as inside it
+    constexpr float EPSILON = 0.0001f;
+    constexpr uint8_t WATER = 4;
+
+    HitboxContacts contacts{ false, false };
+    constexpr std::array<int, 3> AXIS_ORDER{ 1, 0, 2 };
+    for (int axis : AXIS_ORDER)
+    {
+        float displacement = velocity[axis] * DT;
+        if (displacement == 0.0f)
+            continue;
+
+        // The blocks the box covers on the other two axes
+        std::array<int, 2> p{ (axis + 1) % 3, (axis + 2) % 3 };
+        IVec3 minCovered, maxCovered;
+        for (int otherAxis : p)
+        {
+            minCovered[otherAxis] = static_cast<int>(std::floor(minOffset[otherAxis] + EPSILON));
+            maxCovered[otherAxis] = static_cast<int>(
+                std::floor(minOffset[otherAxis] + size[otherAxis] - EPSILON)
+            );
+        }
+
+        const int direction = displacement > 0.0f ? 1 : -1;
+        float face = displacement > 0.0f ? minOffset[axis] + size[axis] : minOffset[axis];
+        // Starting from the layer the leading face is already in catches blocks the box overlaps
+        int firstLayer = displacement > 0.0f ? static_cast<int>(std::floor(face - EPSILON))
+            : static_cast<int>(std::floor(face + EPSILON));
+        int lastLayer = displacement > 0.0f
+            ? static_cast<int>(std::floor(face + displacement - EPSILON))
+            : static_cast<int>(std::floor(face + displacement + EPSILON));
+
+        bool collided = false;
+        IVec3 block;
+        for (int layer = firstLayer; layer != lastLayer + direction && !collided;
+            layer += direction)
+        {
+            block[axis] = minBlock[axis] + layer;
+            for (int i = minCovered[p[0]]; i <= maxCovered[p[0]] && !collided; i++)
+            {
+                block[p[0]] = minBlock[p[0]] + i;
+                for (int j = minCovered[p[1]]; j <= maxCovered[p[1]] && !collided; j++)
+                {
+                    block[p[1]] = minBlock[p[1]] + j;
+                    collided = isCollidable(getBlock(block));
+                }
+            }
+            if (collided)
+            {
+                // Move the face up to the layer it hit, or not at all if it is already inside it
+                displacement = displacement > 0.0f ? std::max(0.0f, layer - face)
+                    : std::min(0.0f, layer + 1 - face);
+                velocity[axis] = 0.0f;
+                contacts.touchingGround |= axis == 1 && direction < 0;
+            }
+        }
+        minOffset[axis] += displacement;
+    }
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        int carry = static_cast<int>(std::floor(minOffset[axis]));
+        minOffset[axis] -= carry;
+        minBlock[axis] += carry;
+    }
+
+    float waterCheckBottom = minOffset.y + (wasTouchingWater ? 0.0f : waterEntryHeight);
+    IVec3 block;
+    for (int y = static_cast<int>(std::floor(waterCheckBottom));
+        y <= static_cast<int>(std::floor(minOffset.y + size.y)) && !contacts.touchingWater; y++)
+    {
+        block.y = minBlock.y + y;
+        for (int x = static_cast<int>(std::floor(minOffset.x));
+            x <= static_cast<int>(std::floor(minOffset.x + size.x)); x++)
+        {
+            block.x = minBlock.x + x;
+            for (int z = static_cast<int>(std::floor(minOffset.z));
+                z <= static_cast<int>(std::floor(minOffset.z + size.z)); z++)
+            {
+                block.z = minBlock.z + z;
+                contacts.touchingWater |= getBlock(block) == WATER;
+            }
+        }
+    }
+
+    return contacts;
+}
+
+}  // namespace lonelycube
@@ -0,0 +1,92 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/latencyHistogram.h"
+
+#include "core/pch.h"
+
+#include <bit>
+
+namespace lonelycube {
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+int LatencyHistogram::getBucketIndex(int64_t value)
+{
+    uint64_t clampedValue = std::min<uint64_t>(std::max<int64_t>(value, 0),
+        (1ull << MAX_VALUE_BITS) - 1);
+    // Values below 2 * SUB_BUCKET_COUNT are counted exactly, and each power of two above that is
+    // split into SUB_BUCKET_COUNT buckets
+    int shift = std::max(0, static_cast<int>(std::bit_width(clampedValue)) - SUB_BUCKET_BITS - 1);
+    return shift * SUB_BUCKET_COUNT + static_cast<int>(clampedValue >> shift);
+}
+
+int64_t LatencyHistogram::getBucketUpperBound(int index)
+{
+    int shift = std::max(0, index / SUB_BUCKET_COUNT - 1);
+    int64_t subBucket = index - shift * SUB_BUCKET_COUNT;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(int64_t nanoseconds)
+{
+    m_counts[getBucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    m_totalCount.fetch_add(1, std::memory_order_relaxed);
+    int64_t max = m_max.load(std::memory_order_relaxed);
+    while (nanoseconds > max
+        && !m_max.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed));
+}
+
+int64_t LatencyHistogram::getPercentile(double percentile) const
+{
+    // Other threads may still be recording, so count the buckets themselves rather than
+    // trusting m_totalCount to match them
+    std::array<uint64_t, NUM_BUCKETS> counts;
+    uint64_t totalCount = 0;
+    for (int index = 0; index < NUM_BUCKETS; index++)
+    {
+        counts[index] = m_counts[index].load(std::memory_order_relaxed);
+        totalCount += counts[index];
+    }
+    if (totalCount == 0)
+        return 0;
+
+    uint64_t targetCount = std::max<uint64_t>(1, std::ceil(percentile / 100.0 * totalCount));
+    uint64_t count = 0;
+    for (int index = 0; index < NUM_BUCKETS; index++)
+    {
+        count += counts[index];
+        // The last bucket also holds everything too long to be distinguished
+        if (count >= targetCount && index < NUM_BUCKETS - 1)
+            return std::min(getBucketUpperBound(index), getMax());
+    }
+    return getMax();
+}
+
+void LatencyHistogram::reset()
+{
+    for (std::atomic<uint64_t>& count : m_counts)
+        count.store(0, std::memory_order_relaxed);
+    m_totalCount.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace lonelycube
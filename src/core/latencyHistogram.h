@@ -0,0 +1,67 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+#include <atomic>
+
+namespace lonelycube {
+
+// Counts durations in logarithmic buckets that are each split into 16 linear sub-buckets, so
+// every recorded value is kept to within about 6% however large it is, in a fixed amount of
+// memory. Recording is lock free, so any number of threads can record into the same histogram
+// while another reads percentiles from it.
+class LatencyHistogram
+{
+private:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    // Durations of up to 2^40 ns (about 18 minutes) are distinguished, with longer ones being
+    // counted in the last bucket
+    static constexpr int MAX_VALUE_BITS = 40;
+    static constexpr int NUM_BUCKETS = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> m_counts;
+    std::atomic<uint64_t> m_totalCount;
+    std::atomic<int64_t> m_max;
+
+    static int getBucketIndex(int64_t value);
+    static int64_t getBucketUpperBound(int index);
+
+public:
+    LatencyHistogram();
+    void record(int64_t nanoseconds);
+    // Returns the smallest duration that at least the given percentage of recorded durations
+    // are no longer than, or 0 if nothing has been recorded
+    int64_t getPercentile(double percentile) const;
+    void reset();
+
+    inline uint64_t getCount() const
+    {
+        return m_totalCount.load(std::memory_order_relaxed);
+    }
+
+    inline int64_t getMax() const
+    {
+        return m_max.load(std::memory_order_relaxed);
+    }
+};
+
+}  // namespace lonelycube
@@ -21,6 +21,7 @@
 #include "core/pch.h"
 
 #include "core/chunk.h"
+#include "core/profiler.h"
 #include "core/utils/iVec3.h"
 
 namespace lonelycube {
@@ -29,6 +30,7 @@ void Lighting::propagateSkyLight(IVec3 pos, std::unordered_map<IVec3, Chunk>& wo
     bool* neighbouringChunksToBeRelit, bool* chunksToRemesh, const ResourcePack& resourcePack,
     uint32_t modifiedBlock)
 {
+    PROFILE_ZONE("Propagate sky light");
     Chunk& chunk = worldChunks.at(pos);
     int chunkPosition[3] = { pos.x, pos.y, pos.z };
     const std::array<Chunk*, 6> neighbouringChunks = { &worldChunks.at(IVec3(chunkPosition[0], chunkPosition[1] - 1, chunkPosition[2])),
@@ -59,27 +61,27 @@ void Lighting::propagateSkyLight(IVec3 pos, std::unordered_map<IVec3, Chunk>& wo
     //add the the updated block to the light queue if it has been provided
     if (modifiedBlock < constants::CHUNK_SIZE * constants::CHUNK_SIZE * constants::CHUNK_SIZE) {
         if (modifiedBlock < (constants::CHUNK_SIZE * constants::CHUNK_SIZE * (constants::CHUNK_SIZE - 1))
-            && resourcePack.getBlockData(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[5])).transparent) {
+            && resourcePack.isTransparent(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[5]))) {
             lightQueue.push(modifiedBlock + chunk.neighbouringBlocks[5]);
         }
         if ((modifiedBlock % (constants::CHUNK_SIZE * constants::CHUNK_SIZE)) < (constants::CHUNK_SIZE * (constants::CHUNK_SIZE - 1))
-            && resourcePack.getBlockData(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[4])).transparent) {
+            && resourcePack.isTransparent(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[4]))) {
             lightQueue.push(modifiedBlock + chunk.neighbouringBlocks[4]);
         }
         if ((modifiedBlock % constants::CHUNK_SIZE) < (constants::CHUNK_SIZE - 1)
-            && resourcePack.getBlockData(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[3])).transparent) {
+            && resourcePack.isTransparent(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[3]))) {
             lightQueue.push(modifiedBlock + chunk.neighbouringBlocks[3]);
         }
         if ((modifiedBlock % constants::CHUNK_SIZE) >= 1
-            && resourcePack.getBlockData(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[2])).transparent) {
+            && resourcePack.isTransparent(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[2]))) {
             lightQueue.push(modifiedBlock + chunk.neighbouringBlocks[2]);
         }
         if ((modifiedBlock % (constants::CHUNK_SIZE * constants::CHUNK_SIZE)) >= constants::CHUNK_SIZE
-            && resourcePack.getBlockData(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[1])).transparent) {
+            && resourcePack.isTransparent(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[1]))) {
             lightQueue.push(modifiedBlock + chunk.neighbouringBlocks[1]);
         }
         if (modifiedBlock >= (constants::CHUNK_SIZE * constants::CHUNK_SIZE)
-            && resourcePack.getBlockData(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[0])).transparent) {
+            && resourcePack.isTransparent(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[0]))) {
             lightQueue.push(modifiedBlock + chunk.neighbouringBlocks[0]);
         }
     }
@@ -137,9 +139,9 @@ void Lighting::propagateSkyLight(IVec3 pos, std::unordered_map<IVec3, Chunk>& wo
                 blockNum - constants::CHUNK_SIZE * constants::CHUNK_SIZE * (constants::CHUNK_SIZE - 1)) - 1;
             //propogate direct skylight down without reducing its intensity
             neighbouringSkyLight += (neighbouringSkyLight == constants::skyLightMaxValue - 1)
-                * !(resourcePack.getBlockData(neighbouringChunks[5]->getBlock(
-                blockNum - constants::CHUNK_SIZE * constants::CHUNK_SIZE * (constants::CHUNK_SIZE - 1))).dimsLight);
-            bool newHighestSkyLight = (currentSkyLight < neighbouringSkyLight) * resourcePack.getBlockData(chunk.getBlock(blockNum)).transparent;
+                * !(resourcePack.dimsLight(neighbouringChunks[5]->getBlock(
+                blockNum - constants::CHUNK_SIZE * constants::CHUNK_SIZE * (constants::CHUNK_SIZE - 1))));
+            bool newHighestSkyLight = (currentSkyLight < neighbouringSkyLight) * resourcePack.isTransparent(chunk.getBlock(blockNum));
             if (newHighestSkyLight) {
                 chunk.setSkyLight(blockNum, neighbouringSkyLight);
                 lightQueue.push(blockNum);
@@ -202,20 +204,20 @@ void Lighting::propagateSkyLight(IVec3 pos, std::unordered_map<IVec3, Chunk>& wo
         }
         if (blockNum >= (constants::CHUNK_SIZE * constants::CHUNK_SIZE)) {
             uint32_t neighbouringBlockNum = blockNum + chunk.neighbouringBlocks[0];
-            skyLight += (skyLight == constants::skyLightMaxValue - 1) * !(resourcePack.getBlockData(chunk.getBlock(neighbouringBlockNum)).dimsLight);
+            skyLight += (skyLight == constants::skyLightMaxValue - 1) * !(resourcePack.dimsLight(chunk.getBlock(neighbouringBlockNum)));
             uint8_t neighbouringSkyLight = chunk.getSkyLight(neighbouringBlockNum);
-            bool newHighestSkyLight = (neighbouringSkyLight < skyLight) * resourcePack.getBlockData(chunk.getBlock(neighbouringBlockNum)).transparent;
+            bool newHighestSkyLight = (neighbouringSkyLight < skyLight) * resourcePack.isTransparent(chunk.getBlock(neighbouringBlockNum));
             if (newHighestSkyLight) {
                 chunk.setSkyLight(neighbouringBlockNum, skyLight);
                 lightQueue.push(neighbouringBlockNum);
             }
         }
         else {
-            bool dimsLight = resourcePack.getBlockData(neighbouringChunks[0]->getBlock(
-                blockNum + constants::CHUNK_SIZE * constants::CHUNK_SIZE * (constants::CHUNK_SIZE - 1))).dimsLight;
+            bool dimsLight = resourcePack.dimsLight(neighbouringChunks[0]->getBlock(
+                blockNum + constants::CHUNK_SIZE * constants::CHUNK_SIZE * (constants::CHUNK_SIZE - 1)));
             skyLight += (skyLight == constants::skyLightMaxValue - 1) * !(dimsLight);
-            bool transparent = resourcePack.getBlockData(neighbouringChunks[0]->getBlock(
-                blockNum + constants::CHUNK_SIZE * constants::CHUNK_SIZE * (constants::CHUNK_SIZE - 1))).transparent;
+            bool transparent = resourcePack.isTransparent(neighbouringChunks[0]->getBlock(
+                blockNum + constants::CHUNK_SIZE * constants::CHUNK_SIZE * (constants::CHUNK_SIZE - 1)));
             bool newHighestSkyLight = neighbouringChunks[0]->getSkyLight(
                 blockNum + constants::CHUNK_SIZE * constants::CHUNK_SIZE * (constants::CHUNK_SIZE - 1)) < skyLight;
             if (transparent && newHighestSkyLight) {
@@ -261,30 +263,30 @@ void Lighting::propagateBlockLight(IVec3 pos, std::unordered_map<IVec3, Chunk>&
     std::queue<uint32_t> lightQueue;
     //add the the updated block to the light queue if it has been provided
     if (modifiedBlock < constants::CHUNK_SIZE * constants::CHUNK_SIZE * constants::CHUNK_SIZE) {
-        chunk.setBlockLight(modifiedBlock, resourcePack.getBlockData(chunk.getBlock(modifiedBlock)).blockLight);
+        chunk.setBlockLight(modifiedBlock, resourcePack.getBlockLight(chunk.getBlock(modifiedBlock)));
         lightQueue.push(modifiedBlock);
         if (modifiedBlock < (constants::CHUNK_SIZE * constants::CHUNK_SIZE * (constants::CHUNK_SIZE - 1))
-            && resourcePack.getBlockData(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[5])).transparent) {
+            && resourcePack.isTransparent(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[5]))) {
             lightQueue.push(modifiedBlock + chunk.neighbouringBlocks[5]);
         }
         if ((modifiedBlock % (constants::CHUNK_SIZE * constants::CHUNK_SIZE)) < (constants::CHUNK_SIZE * (constants::CHUNK_SIZE - 1))
-            && resourcePack.getBlockData(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[4])).transparent) {
+            && resourcePack.isTransparent(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[4]))) {
             lightQueue.push(modifiedBlock + chunk.neighbouringBlocks[4]);
         }
         if ((modifiedBlock % constants::CHUNK_SIZE) < (constants::CHUNK_SIZE - 1)
-            && resourcePack.getBlockData(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[3])).transparent) {
+            && resourcePack.isTransparent(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[3]))) {
             lightQueue.push(modifiedBlock + chunk.neighbouringBlocks[3]);
         }
         if ((modifiedBlock % constants::CHUNK_SIZE) >= 1
-            && resourcePack.getBlockData(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[2])).transparent) {
+            && resourcePack.isTransparent(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[2]))) {
             lightQueue.push(modifiedBlock + chunk.neighbouringBlocks[2]);
         }
         if ((modifiedBlock % (constants::CHUNK_SIZE * constants::CHUNK_SIZE)) >= constants::CHUNK_SIZE
-            && resourcePack.getBlockData(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[1])).transparent) {
+            && resourcePack.isTransparent(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[1]))) {
             lightQueue.push(modifiedBlock + chunk.neighbouringBlocks[1]);
         }
         if (modifiedBlock >= (constants::CHUNK_SIZE * constants::CHUNK_SIZE)
-            && resourcePack.getBlockData(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[0])).transparent) {
+            && resourcePack.isTransparent(chunk.getBlock(modifiedBlock + chunk.neighbouringBlocks[0]))) {
             lightQueue.push(modifiedBlock + chunk.neighbouringBlocks[0]);
         }
     }
@@ -570,9 +572,9 @@ void Lighting::propagateSkyDarkness(IVec3 pos, std::unordered_map<IVec3, Chunk>&
             chunksToRemesh[0] = true;
         }
         highestNeighbourSkyLight = std::max(highestNeighbourSkyLight, neighbouringSkyLights[0]);
-        bool skyAccess = neighbouringSkyLights[5] == constants::skyLightMaxValue && !resourcePack.getBlockData(chunk.getBlock(blockNum)).dimsLight;
+        bool skyAccess = neighbouringSkyLights[5] == constants::skyLightMaxValue && !resourcePack.dimsLight(chunk.getBlock(blockNum));
         highestNeighbourSkyLight -= !skyAccess && highestNeighbourSkyLight > 0;
-        highestNeighbourSkyLight *= resourcePack.getBlockData(chunk.getBlock(blockNum)).transparent;
+        highestNeighbourSkyLight *= resourcePack.isTransparent(chunk.getBlock(blockNum));
         if (highestNeighbourSkyLight < skyLight) {
             chunk.setSkyLight(blockNum, highestNeighbourSkyLight);
             // Add the neighbouring blocks to the queue if they have a low enough sky light
@@ -802,7 +804,7 @@ void Lighting::propagateBlockDarkness(IVec3 pos, std::unordered_map<IVec3, Chunk
         }
         highestNeighbourBlockLight = std::max(highestNeighbourBlockLight, neighbouringBlockLights[0]);
         highestNeighbourBlockLight -= highestNeighbourBlockLight > 0;
-        highestNeighbourBlockLight *= resourcePack.getBlockData(chunk.getBlock(blockNum)).transparent;
+        highestNeighbourBlockLight *= resourcePack.isTransparent(chunk.getBlock(blockNum));
         if (highestNeighbourBlockLight < blockLight) {
             chunk.setBlockLight(blockNum, highestNeighbourBlockLight);
             // Add the neighbouring blocks to the queue if they have a low enough block light
@@ -810,7 +812,7 @@ void Lighting::propagateBlockDarkness(IVec3 pos, std::unordered_map<IVec3, Chunk
             if (neighbouringBlockLights[5] < blockLight && neighbouringBlockLights[5] >= highestNeighbourBlockLight) {
                 uint32_t neighbouringBlockNum = blockNum + chunk.neighbouringBlocks[5];
                 if (blockNum < (constants::CHUNK_SIZE * constants::CHUNK_SIZE * (constants::CHUNK_SIZE - 1))
-                    && neighbouringBlockLights[5] > resourcePack.getBlockData(chunk.getBlock(neighbouringBlockNum)).blockLight)
+                    && neighbouringBlockLights[5] > resourcePack.getBlockLight(chunk.getBlock(neighbouringBlockNum)))
                 {
                     lightQueue.push(neighbouringBlockNum);
                 }
@@ -822,7 +824,7 @@ void Lighting::propagateBlockDarkness(IVec3 pos, std::unordered_map<IVec3, Chunk
             if (neighbouringBlockLights[4] < blockLight && neighbouringBlockLights[4] >= highestNeighbourBlockLight) {
                 uint32_t neighbouringBlockNum = blockNum + chunk.neighbouringBlocks[4];
                 if ((blockNum % (constants::CHUNK_SIZE * constants::CHUNK_SIZE)) < (constants::CHUNK_SIZE * (constants::CHUNK_SIZE - 1))
-                    && neighbouringBlockLights[4] > resourcePack.getBlockData(chunk.getBlock(neighbouringBlockNum)).blockLight)
+                    && neighbouringBlockLights[4] > resourcePack.getBlockLight(chunk.getBlock(neighbouringBlockNum)))
                 {
                     lightQueue.push(neighbouringBlockNum);
                 }
@@ -834,7 +836,7 @@ void Lighting::propagateBlockDarkness(IVec3 pos, std::unordered_map<IVec3, Chunk
             if (neighbouringBlockLights[3] < blockLight && neighbouringBlockLights[3] >= highestNeighbourBlockLight) {
                 uint32_t neighbouringBlockNum = blockNum + chunk.neighbouringBlocks[3];
                 if ((blockNum % constants::CHUNK_SIZE) < (constants::CHUNK_SIZE - 1)
-                    && neighbouringBlockLights[3] > resourcePack.getBlockData(chunk.getBlock(neighbouringBlockNum)).blockLight)
+                    && neighbouringBlockLights[3] > resourcePack.getBlockLight(chunk.getBlock(neighbouringBlockNum)))
                 {
                     lightQueue.push(neighbouringBlockNum);
                 }
@@ -846,7 +848,7 @@ void Lighting::propagateBlockDarkness(IVec3 pos, std::unordered_map<IVec3, Chunk
             if (neighbouringBlockLights[2] < blockLight && neighbouringBlockLights[2] >= highestNeighbourBlockLight) {
                 uint32_t neighbouringBlockNum = blockNum + chunk.neighbouringBlocks[2];
                 if ((blockNum % constants::CHUNK_SIZE) >= 1
-                    && neighbouringBlockLights[2] > resourcePack.getBlockData(chunk.getBlock(neighbouringBlockNum)).blockLight)
+                    && neighbouringBlockLights[2] > resourcePack.getBlockLight(chunk.getBlock(neighbouringBlockNum)))
                 {
                     lightQueue.push(neighbouringBlockNum);
                 }
@@ -858,7 +860,7 @@ void Lighting::propagateBlockDarkness(IVec3 pos, std::unordered_map<IVec3, Chunk
             if (neighbouringBlockLights[1] < blockLight && neighbouringBlockLights[1] >= highestNeighbourBlockLight) {
                 uint32_t neighbouringBlockNum = blockNum + chunk.neighbouringBlocks[1];
                 if ((blockNum % (constants::CHUNK_SIZE * constants::CHUNK_SIZE)) >= constants::CHUNK_SIZE
-                    && neighbouringBlockLights[1] > resourcePack.getBlockData(chunk.getBlock(neighbouringBlockNum)).blockLight)
+                    && neighbouringBlockLights[1] > resourcePack.getBlockLight(chunk.getBlock(neighbouringBlockNum)))
                 {
                     lightQueue.push(neighbouringBlockNum);
                 }
@@ -870,7 +872,7 @@ void Lighting::propagateBlockDarkness(IVec3 pos, std::unordered_map<IVec3, Chunk
             if (neighbouringBlockLights[0] < blockLight && neighbouringBlockLights[0] >= highestNeighbourBlockLight) {
                 uint32_t neighbouringBlockNum = blockNum + chunk.neighbouringBlocks[0];
                 if (blockNum >= (constants::CHUNK_SIZE * constants::CHUNK_SIZE)
-                    && neighbouringBlockLights[0] > resourcePack.getBlockData(chunk.getBlock(neighbouringBlockNum)).blockLight)
+                    && neighbouringBlockLights[0] > resourcePack.getBlockLight(chunk.getBlock(neighbouringBlockNum)))
                 {
                     lightQueue.push(neighbouringBlockNum);
                 }
@@ -889,12 +891,17 @@ void Lighting::relightChunksAroundBlock(const IVec3& blockCoords, const IVec3& c
     uint8_t originalBlock, uint8_t newBlock, std::vector<IVec3>& chunksToRemesh,
     std::unordered_map<IVec3, Chunk>& worldChunks, const ResourcePack& resourcePack)
 {
+    PROFILE_ZONE("Relight chunks around block");
     uint32_t modifiedBlockNum = blockCoords.x - chunkPosition.x * constants::CHUNK_SIZE
         + (blockCoords.y - chunkPosition.y * constants::CHUNK_SIZE) * constants::CHUNK_SIZE
         * constants::CHUNK_SIZE + (blockCoords.z - chunkPosition.z * constants::CHUNK_SIZE)
         * constants::CHUNK_SIZE;
-    BlockData oldBlockData = resourcePack.getBlockData(originalBlock);
-    BlockData newBlockData = resourcePack.getBlockData(newBlock);
+    bool oldTransparent = resourcePack.isTransparent(originalBlock);
+    bool newTransparent = resourcePack.isTransparent(newBlock);
+    bool oldDimsLight = resourcePack.dimsLight(originalBlock);
+    bool newDimsLight = resourcePack.dimsLight(newBlock);
+    uint8_t oldBlockLight = resourcePack.getBlockLight(originalBlock);
+    uint8_t newBlockLight = resourcePack.getBlockLight(newBlock);
 
     // j = 0 represents sky lighting and j = 1 represents block lighting
     for (int j = 0; j < 2; j++) {
@@ -902,18 +909,15 @@ void Lighting::relightChunksAroundBlock(const IVec3& blockCoords, const IVec3& c
         if (j == 0)
         {
             // Determine whether light or darkness needs to be propagated for sky light (or both)
-            darken = (oldBlockData.transparent && !newBlockData.transparent) ||
-                ((!oldBlockData.dimsLight && oldBlockData.transparent) && newBlockData.dimsLight);
-            lighten = (!oldBlockData.transparent && newBlockData.transparent) ||
-                (oldBlockData.dimsLight && !newBlockData.dimsLight);
+            darken = (oldTransparent && !newTransparent) ||
+                ((!oldDimsLight && oldTransparent) && newDimsLight);
+            lighten = (!oldTransparent && newTransparent) || (oldDimsLight && !newDimsLight);
         }
         else
         {
             // Determine whether light or darkness needs to be propagated for block light (or both)
-            darken = (oldBlockData.transparent && !newBlockData.transparent)
-                || newBlockData.blockLight < oldBlockData.blockLight;
-            lighten = (!oldBlockData.transparent && newBlockData.transparent)
-                || newBlockData.blockLight > oldBlockData.blockLight;
+            darken = (oldTransparent && !newTransparent) || newBlockLight < oldBlockLight;
+            lighten = (!oldTransparent && newTransparent) || newBlockLight > oldBlockLight;
         }
 
         std::vector<IVec3> relitChunks;
@@ -71,7 +71,7 @@ private:
         int8_t currentSkyLight = chunk.getSkyLight(blockNum);
         int8_t neighbouringSkyLight = neighbouringChunk->getSkyLight(neighbouringBlockNum) - 1;
         bool newHighestSkyLight = (currentSkyLight < neighbouringSkyLight) *
-            resourcePack.getBlockData(chunk.getBlock(blockNum)).transparent;
+            resourcePack.isTransparent(chunk.getBlock(blockNum));
         if (newHighestSkyLight) {
             chunk.setSkyLight(blockNum, neighbouringSkyLight);
             lightQueue.push(blockNum);
@@ -85,7 +85,7 @@ private:
         int8_t currentBlockLight = chunk.getBlockLight(blockNum);
         int8_t neighbouringBlockLight = neighbouringChunk->getBlockLight(neighbouringBlockNum) - 1;
         bool newHighestBlockLight = (currentBlockLight < neighbouringBlockLight) *
-            resourcePack.getBlockData(chunk.getBlock(blockNum)).transparent;
+            resourcePack.isTransparent(chunk.getBlock(blockNum));
         if (newHighestBlockLight) {
             chunk.setBlockLight(blockNum, neighbouringBlockLight);
             lightQueue.push(blockNum);
@@ -107,7 +107,7 @@ private:
         resourcePack, std::queue<uint32_t>& lightQueue)
     {
         int8_t currentBlockLight = chunk.getBlockLight(blockNum);
-        if (currentBlockLight > resourcePack.getBlockData(chunk.getBlock(blockNum)).blockLight) {
+        if (currentBlockLight > resourcePack.getBlockLight(chunk.getBlock(blockNum))) {
             int8_t neighbouringBlockLight = neighbouringChunk->getBlockLight(neighbouringBlockNum);
             if (currentBlockLight >= neighbouringBlockLight) {
                 lightQueue.push(blockNum);
@@ -122,7 +122,7 @@ private:
         uint32_t neighbouringBlockNum = blockNum + chunk.neighbouringBlocks[direction];
         uint8_t neighbouringSkyLight = chunk.getSkyLight(neighbouringBlockNum);
         bool newHighestSkyLight = (neighbouringSkyLight < skyLight) *
-            resourcePack.getBlockData(chunk.getBlock(neighbouringBlockNum)).transparent;
+            resourcePack.isTransparent(chunk.getBlock(neighbouringBlockNum));
         if (newHighestSkyLight) {
             chunk.setSkyLight(neighbouringBlockNum, skyLight);
             lightQueue.push(neighbouringBlockNum);
@@ -136,7 +136,7 @@ private:
         uint32_t neighbouringBlockNum = blockNum + chunk.neighbouringBlocks[direction];
         uint8_t neighbouringBlockLight = chunk.getBlockLight(neighbouringBlockNum);
         bool newHighestBlockLight = (neighbouringBlockLight < blockLight) *
-            resourcePack.getBlockData(chunk.getBlock(neighbouringBlockNum)).transparent;
+            resourcePack.isTransparent(chunk.getBlock(neighbouringBlockNum));
         if (newHighestBlockLight) {
             chunk.setBlockLight(neighbouringBlockNum, blockLight);
             lightQueue.push(neighbouringBlockNum);
@@ -147,8 +147,8 @@ private:
         neighbouringBlockNum, const uint8_t skyLight, const ResourcePack& resourcePack, bool&
         shouldRelightChunk)
     {
-        bool transparent = resourcePack.getBlockData(neighbouringChunk->getBlock(
-            neighbouringBlockNum)).transparent;
+        bool transparent = resourcePack.isTransparent(neighbouringChunk->getBlock(
+            neighbouringBlockNum));
         bool newHighestSkyLight = neighbouringChunk->getSkyLight(neighbouringBlockNum) < skyLight;
         if (transparent && newHighestSkyLight) {
             shouldRelightChunk = true;
@@ -159,8 +159,8 @@ private:
         neighbouringBlockNum, const uint8_t blockLight, const ResourcePack& resourcePack, bool&
         shouldRelightChunk)
     {
-        bool transparent = resourcePack.getBlockData(neighbouringChunk->getBlock(
-            neighbouringBlockNum)).transparent;
+        bool transparent = resourcePack.isTransparent(neighbouringChunk->getBlock(
+            neighbouringBlockNum));
         bool newHighestBlockLight = neighbouringChunk->getBlockLight(neighbouringBlockNum) < blockLight;
         if (transparent && newHighestBlockLight) {
             shouldRelightChunk = true;
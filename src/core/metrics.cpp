@@ -0,0 +1,195 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/metrics.h"
+
+#include "core/pch.h"
+
+#include <fstream>
+#include <iomanip>
+
+namespace lonelycube {
+
+using MetricKey = std::pair<std::string, std::string>;  // The name and labels
+
+static std::mutex s_metricsMtx;
+// std::map never moves its values, so references to them stay valid
+static std::map<MetricKey, Counter> s_counters;
+static std::map<MetricKey, Gauge> s_gauges;
+static std::map<MetricKey, LatencyHistogram> s_histograms;
+
+struct Sample
+{
+    std::string name;  // Including the labels
+    double value;
+};
+
+static std::string getSampleName(
+    const std::string& name, const std::string& labels, const std::string& extraLabel = ""
+) {
+    if (labels.empty() && extraLabel.empty())
+        return name;
+    return name + "{" + labels + (labels.empty() || extraLabel.empty() ? "" : ",") + extraLabel
+        + "}";
+}
+
+// The samples of a histogram are in seconds, as OpenMetrics expects
+static void getHistogramSamples(
+    const MetricKey& key, const LatencyHistogram& histogram, std::vector<Sample>& samples
+) {
+    const auto& [name, labels] = key;
+    samples.push_back({
+        getSampleName(name, labels, "quantile=\"0.5\""), histogram.getPercentile(50.0) / 1e9
+    });
+    samples.push_back({
+        getSampleName(name, labels, "quantile=\"0.99\""), histogram.getPercentile(99.0) / 1e9
+    });
+    samples.push_back({
+        getSampleName(name + "_count", labels), static_cast<double>(histogram.getCount())
+    });
+}
+
+Counter& MetricsRegistry::getCounter(const std::string& name, const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(s_metricsMtx);
+    return s_counters.try_emplace({ name, labels }).first->second;
+}
+
+Gauge& MetricsRegistry::getGauge(const std::string& name, const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(s_metricsMtx);
+    return s_gauges.try_emplace({ name, labels }).first->second;
+}
+
+LatencyHistogram& MetricsRegistry::getHistogram(const std::string& name, const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(s_metricsMtx);
+    return s_histograms.try_emplace({ name, labels }).first->second;
+}
+
+std::vector<std::string> MetricsRegistry::getSummary()
+{
+    std::vector<std::string> lines;
+    std::lock_guard<std::mutex> lock(s_metricsMtx);
+    for (const auto& [key, counter] : s_counters)
+    {
+        lines.push_back(
+            getSampleName(key.first, key.second) + ": " + std::to_string(counter.get())
+        );
+    }
+    for (const auto& [key, gauge] : s_gauges)
+    {
+        std::ostringstream line;
+        line << getSampleName(key.first, key.second) << ": " << gauge.get();
+        lines.push_back(line.str());
+    }
+    for (const auto& [key, histogram] : s_histograms)
+    {
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(2) << getSampleName(key.first, key.second) << ": "
+            << histogram.getCount() << " samples, p50 " << histogram.getPercentile(50.0) / 1e6
+            << "ms, p99 " << histogram.getPercentile(99.0) / 1e6 << "ms, max "
+            << histogram.getMax() / 1e6 << "ms";
+        lines.push_back(line.str());
+    }
+    return lines;
+}
+
+bool MetricsRegistry::appendCsv(const std::string& path)
+{
+    std::vector<Sample> samples;
+    {
+        std::lock_guard<std::mutex> lock(s_metricsMtx);
+        for (const auto& [key, counter] : s_counters)
+        {
+            samples.push_back({
+                getSampleName(key.first, key.second), static_cast<double>(counter.get())
+            });
+        }
+        for (const auto& [key, gauge] : s_gauges)
+            samples.push_back({ getSampleName(key.first, key.second), gauge.get() });
+        for (const auto& [key, histogram] : s_histograms)
+            getHistogramSamples(key, histogram, samples);
+    }
+
+    bool newFile = !std::filesystem::exists(path);
+    std::ofstream file(path, std::ios::app);
+    if (!file)
+        return false;
+    if (newFile)
+        file << "timestamp,metric,value\n";
+    int64_t timestamp = std::time(nullptr);
+    for (const Sample& sample : samples)
+    {
+        // The labels contain quotes and commas, so the name has to be quoted
+        file << timestamp << ",\"";
+        for (char character : sample.name)
+            file << (character == '"' ? "\"\"" : std::string(1, character));
+        file << "\"," << sample.value << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+bool MetricsRegistry::writeOpenMetrics(const std::string& path)
+{
+    // Write to a temporary file first so that anything reading the file never sees it half
+    // written
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath);
+        if (!file)
+            return false;
+
+        std::lock_guard<std::mutex> lock(s_metricsMtx);
+        const std::string* lastName = nullptr;
+        auto writeType = [&](const std::string& name, const char* type) {
+            if (lastName == nullptr || *lastName != name)
+                file << "# TYPE " << name << " " << type << "\n";
+            lastName = &name;
+        };
+        for (const auto& [key, counter] : s_counters)
+        {
+            writeType(key.first, "counter");
+            file << getSampleName(key.first + "_total", key.second) << " " << counter.get()
+                << "\n";
+        }
+        for (const auto& [key, gauge] : s_gauges)
+        {
+            writeType(key.first, "gauge");
+            file << getSampleName(key.first, key.second) << " " << gauge.get() << "\n";
+        }
+        std::vector<Sample> samples;
+        for (const auto& [key, histogram] : s_histograms)
+        {
+            writeType(key.first, "summary");
+            samples.clear();
+            getHistogramSamples(key, histogram, samples);
+            for (const Sample& sample : samples)
+                file << sample.name << " " << sample.value << "\n";
+        }
+        file << "# EOF\n";
+        if (!file)
+            return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    return !error;
+}
+
+}  // namespace lonelycube
@@ -0,0 +1,84 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+#include "core/latencyHistogram.h"
+#include <atomic>
+
+namespace lonelycube {
+
+class Counter
+{
+private:
+    std::atomic<uint64_t> m_value{ 0 };
+
+public:
+    inline void add(uint64_t amount = 1)
+    {
+        m_value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    inline uint64_t get() const
+    {
+        return m_value.load(std::memory_order_relaxed);
+    }
+};
+
+class Gauge
+{
+private:
+    std::atomic<double> m_value{ 0.0 };
+
+public:
+    inline void set(double value)
+    {
+        m_value.store(value, std::memory_order_relaxed);
+    }
+
+    inline double get() const
+    {
+        return m_value.load(std::memory_order_relaxed);
+    }
+};
+
+// Named counters, gauges and latency histograms that can be reported together. Looking a metric
+// up takes a lock, but the returned reference stays valid for the rest of the program, so callers
+// should keep it and update it without locking. labels are written inside the braces of an
+// OpenMetrics sample, such as player="3", and metrics with the same name but different labels
+// are reported separately.
+class MetricsRegistry
+{
+public:
+    static Counter& getCounter(const std::string& name, const std::string& labels = "");
+    static Gauge& getGauge(const std::string& name, const std::string& labels = "");
+    static LatencyHistogram& getHistogram(const std::string& name, const std::string& labels = "");
+
+    // Returns a line for every metric, in order of name
+    static std::vector<std::string> getSummary();
+    // Appends a row of timestamp,metric,value for every value, writing the header if the file is
+    // new. Returns false if the file couldn't be written.
+    static bool appendCsv(const std::string& path);
+    // Replaces the file with the current values in the OpenMetrics text format. Returns false if
+    // the file couldn't be written.
+    static bool writeOpenMetrics(const std::string& path);
+};
+
+}  // namespace lonelycube
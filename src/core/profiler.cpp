@@ -0,0 +1,186 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/profiler.h"
+
+#include "core/pch.h"
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+
+namespace lonelycube {
+
+static constexpr uint64_t ZONES_PER_THREAD = 1 << 14;
+
+// The fields are atomic so that a trace can be written while the thread is still recording
+struct RecordedZone
+{
+    std::atomic<const char*> name;
+    std::atomic<int64_t> start;
+    std::atomic<int64_t> end;
+};
+
+struct ThreadBuffer
+{
+    std::array<RecordedZone, ZONES_PER_THREAD> zones;
+    // Only written by the thread that owns the buffer
+    std::atomic<uint64_t> numZonesRecorded{ 0 };
+    // The rest are guarded by s_buffersMtx
+    std::string threadName;
+    bool inUse = true;
+};
+
+static std::mutex s_buffersMtx;
+static std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+
+// Gives the thread's buffer back when the thread exits so that it can be reused by a new thread,
+// while keeping the zones in it until then
+struct ThreadBufferOwner
+{
+    ThreadBuffer* buffer = nullptr;
+
+    ThreadBuffer* get()
+    {
+        if (buffer == nullptr)
+        {
+            std::lock_guard<std::mutex> lock(s_buffersMtx);
+            size_t bufferNum = 0;
+            while (bufferNum < s_buffers.size() && s_buffers[bufferNum]->inUse)
+                bufferNum++;
+            if (bufferNum == s_buffers.size())
+                s_buffers.push_back(std::make_unique<ThreadBuffer>());
+            buffer = s_buffers[bufferNum].get();
+            buffer->inUse = true;
+            buffer->numZonesRecorded = 0;
+            buffer->threadName = "Thread " + std::to_string(bufferNum + 1);
+        }
+        return buffer;
+    }
+
+    ~ThreadBufferOwner()
+    {
+        if (buffer != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(s_buffersMtx);
+            buffer->inUse = false;
+        }
+    }
+};
+
+static thread_local ThreadBufferOwner t_buffer;
+
+int64_t Profiler::now()
+{
+    static const auto startTime = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - startTime
+    ).count();
+}
+
+void Profiler::recordZone(const char* name, int64_t start, int64_t end)
+{
+    ThreadBuffer* buffer = t_buffer.get();
+    uint64_t zoneNum = buffer->numZonesRecorded.load(std::memory_order_relaxed);
+    RecordedZone& zone = buffer->zones[zoneNum % ZONES_PER_THREAD];
+    zone.name.store(name, std::memory_order_relaxed);
+    zone.start.store(start, std::memory_order_relaxed);
+    zone.end.store(end, std::memory_order_relaxed);
+    buffer->numZonesRecorded.store(zoneNum + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const std::string& name)
+{
+    ThreadBuffer* buffer = t_buffer.get();
+    std::lock_guard<std::mutex> lock(s_buffersMtx);
+    buffer->threadName = name;
+}
+
+static void writeJsonString(std::ofstream& file, const std::string& string)
+{
+    file << '"';
+    for (char character : string)
+    {
+        if (character == '"' || character == '\\')
+            file << '\\' << character;
+        else if (static_cast<unsigned char>(character) >= 0x20)
+            file << character;
+    }
+    file << '"';
+}
+
+bool Profiler::writeChromeTrace(const std::string& path)
+{
+    std::ofstream file(path);
+    if (!file)
+        return false;
+
+    struct Zone
+    {
+        const char* name;
+        int64_t start;
+        int64_t end;
+    };
+    std::vector<Zone> zones;
+
+    file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+    bool firstEvent = true;
+    std::lock_guard<std::mutex> lock(s_buffersMtx);
+    for (size_t threadNum = 0; threadNum < s_buffers.size(); threadNum++)
+    {
+        const ThreadBuffer& buffer = *s_buffers[threadNum];
+        file << (firstEvent ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+            << "\"tid\":" << threadNum + 1 << ",\"args\":{\"name\":";
+        writeJsonString(file, buffer.threadName);
+        file << "}}";
+        firstEvent = false;
+
+        // The thread may record more zones while they are being copied, so only keep the ones
+        // that can't have been overwritten by the time the copy finished
+        uint64_t end = buffer.numZonesRecorded.load(std::memory_order_acquire);
+        uint64_t begin = end > ZONES_PER_THREAD ? end - ZONES_PER_THREAD : 0;
+        zones.clear();
+        for (uint64_t zoneNum = begin; zoneNum < end; zoneNum++)
+        {
+            const RecordedZone& zone = buffer.zones[zoneNum % ZONES_PER_THREAD];
+            zones.push_back({
+                zone.name.load(std::memory_order_relaxed),
+                zone.start.load(std::memory_order_relaxed),
+                zone.end.load(std::memory_order_relaxed)
+            });
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t numZonesRecorded = buffer.numZonesRecorded.load(std::memory_order_relaxed);
+        uint64_t firstIntactZone = numZonesRecorded >= ZONES_PER_THREAD ?
+            numZonesRecorded - ZONES_PER_THREAD + 1 : 0;
+
+        for (uint64_t zoneNum = std::max(begin, firstIntactZone); zoneNum < end; zoneNum++)
+        {
+            const Zone& zone = zones[zoneNum - begin];
+            file << ",\n{\"name\":";
+            writeJsonString(file, zone.name);
+            file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadNum + 1 << ",\"ts\":"
+                << zone.start / 1000.0 << ",\"dur\":" << (zone.end - zone.start) / 1000.0 << "}";
+        }
+    }
+    file << "\n]}\n";
+
+    return static_cast<bool>(file);
+}
+
+}  // namespace lonelycube
@@ -0,0 +1,67 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+#define PROFILE_ZONE_CONCAT_INNER(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_INNER(a, b)
+// Records the time from here to the end of the enclosing scope under the given name, which must
+// be a string literal
+#define PROFILE_ZONE(name) \
+    ::lonelycube::ProfileZone PROFILE_ZONE_CONCAT(profileZone, __LINE__)(name)
+
+namespace lonelycube {
+
+// Records how long named zones of code take on every thread. Each thread writes to its own ring
+// buffer, so recording a zone doesn't take a lock and is cheap enough to leave enabled in release
+// builds. The most recent zones of every thread can be written out at any time as a Chrome trace,
+// which can be opened in chrome://tracing or https://ui.perfetto.dev.
+class Profiler
+{
+public:
+    // Returns the number of nanoseconds since the profiler was first used
+    static int64_t now();
+    // name must outlive the profiler, as only the pointer is stored
+    static void recordZone(const char* name, int64_t start, int64_t end);
+    // Names the calling thread in traces
+    static void setThreadName(const std::string& name);
+    // Returns false if the file couldn't be written
+    static bool writeChromeTrace(const std::string& path);
+};
+
+class ProfileZone
+{
+private:
+    const char* m_name;
+    int64_t m_start;
+
+public:
+    inline ProfileZone(const char* name) : m_name(name), m_start(Profiler::now()) {}
+
+    inline ~ProfileZone()
+    {
+        Profiler::recordZone(m_name, m_start, Profiler::now());
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+};
+
+}  // namespace lonelycube
@@ -0,0 +1,139 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+#include "core/utils/iVec3.h"
+#include "core/utils/vec3.h"
+
+namespace lonelycube {
+
+struct RaycastHit
+{
+    IVec3 blockCoords;
+    // Points out of the face of the block's bounding box that the ray hit, so the block next to
+    // that face is at blockCoords + normal. It is zero if the ray started inside the block.
+    IVec3 normal;
+    uint8_t blockType;
+    float distance;
+};
+
+// Walks along a ray through every block it passes through, in order, using the voxel traversal
+// algorithm of Amanatides and Woo, and tests the ray exactly against the bounding box of each
+// block's model. Returns false if nothing is hit within maxDistance (measured in multiples of
+// direction's length), or if the ray reaches a block that isn't loaded first.
+//
+// getBlock(const IVec3& position, uint8_t& blockType) returns false if the position isn't
+// loaded. getBlockBounds(blockType, Vec3& min, Vec3& max) returns false for blocks that can't
+// be hit, and otherwise sets the bounding box of the block, within the unit cube.
+template<typename GetBlock, typename GetBlockBounds>
+bool raycastBlocks(
+    const IVec3& startBlock, const Vec3& startSubBlock, const Vec3& direction, float maxDistance,
+    GetBlock getBlock, GetBlockBounds getBlockBounds, RaycastHit* hit
+) {
+    constexpr float INF = std::numeric_limits<float>::infinity();
+
+    IVec3 startVoxel = startBlock + IVec3(startSubBlock);
+    Vec3 origin = startSubBlock - Vec3(std::floor(startSubBlock.x), std::floor(startSubBlock.y),
+        std::floor(startSubBlock.z));
+
+    IVec3 voxel = startVoxel;
+    IVec3 step;
+    Vec3 tMax, tDelta;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        step[axis] = direction[axis] > 0.0f ? 1 : (direction[axis] < 0.0f ? -1 : 0);
+        tDelta[axis] = step[axis] == 0 ? INF : 1.0f / std::abs(direction[axis]);
+        if (step[axis] > 0)
+            tMax[axis] = (1.0f - origin[axis]) * tDelta[axis];
+        else if (step[axis] < 0)
+            tMax[axis] = origin[axis] * tDelta[axis];
+        else
+            tMax[axis] = INF;
+    }
+
+    float t = 0.0f;
+    IVec3 voxelEntryNormal(0, 0, 0);
+    while (t <= maxDistance)
+    {
+        uint8_t blockType;
+        if (!getBlock(voxel, blockType))
+            return false;
+
+        Vec3 boundsMin, boundsMax;
+        if (getBlockBounds(blockType, boundsMin, boundsMax))
+        {
+            // Slab test against the bounding box, with the ray's origin relative to this voxel
+            float tNear = -INF;
+            float tFar = INF;
+            int nearAxis = -1;
+            for (int axis = 0; axis < 3; axis++)
+            {
+                float rayStart = startVoxel[axis] - voxel[axis] + origin[axis];
+                if (step[axis] == 0)
+                {
+                    if (rayStart < boundsMin[axis] || rayStart > boundsMax[axis])
+                        tFar = -INF;
+                    continue;
+                }
+                float t1 = (boundsMin[axis] - rayStart) / direction[axis];
+                float t2 = (boundsMax[axis] - rayStart) / direction[axis];
+                if (t1 > t2)
+                    std::swap(t1, t2);
+                if (t1 > tNear)
+                {
+                    tNear = t1;
+                    nearAxis = axis;
+                }
+                tFar = std::min(tFar, t2);
+            }
+
+            if (tNear <= tFar && tFar >= 0.0f && tNear <= maxDistance)
+            {
+                hit->blockCoords = voxel;
+                hit->blockType = blockType;
+                if (tNear >= 0.0f)
+                {
+                    hit->normal = IVec3(0, 0, 0);
+                    hit->normal[nearAxis] = -step[nearAxis];
+                    hit->distance = tNear;
+                }
+                else
+                {
+                    // The ray started inside the bounding box
+                    hit->normal = voxelEntryNormal;
+                    hit->distance = 0.0f;
+                }
+                return true;
+            }
+        }
+
+        int axis = tMax.x < tMax.y ? (tMax.x < tMax.z ? 0 : 2) : (tMax.y < tMax.z ? 1 : 2);
+        t = tMax[axis];
+        tMax[axis] += tDelta[axis];
+        voxel[axis] += step[axis];
+        voxelEntryNormal = IVec3(0, 0, 0);
+        voxelEntryNormal[axis] = -step[axis];
+    }
+
+    return false;
+}
+
+}  // namespace lonelycube
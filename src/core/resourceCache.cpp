@@ -0,0 +1,161 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/resourceCache.h"
+
+#include "core/pch.h"
+
+#include "core/log.h"
+
+namespace lonelycube {
+
+struct SourceFileStamp
+{
+    uint64_t size;
+    int64_t modificationTime;
+};
+
+// Missing files get a stamp too, so that creating one makes the cache stale
+static SourceFileStamp getSourceFileStamp(const std::filesystem::path& path)
+{
+    std::error_code error;
+    SourceFileStamp stamp{ std::numeric_limits<uint64_t>::max(), 0 };
+    uint64_t size = std::filesystem::file_size(path, error);
+    if (error)
+        return stamp;
+    auto modificationTime = std::filesystem::last_write_time(path, error);
+    if (error)
+        return stamp;
+    stamp.size = size;
+    stamp.modificationTime = modificationTime.time_since_epoch().count();
+    return stamp;
+}
+
+ResourceCacheWriter::ResourceCacheWriter(
+    uint32_t magic, uint32_t version, const std::vector<std::filesystem::path>& sourceFiles
+) {
+    write(magic);
+    write(version);
+    write(static_cast<uint32_t>(sourceFiles.size()));
+    for (const std::filesystem::path& path : sourceFiles)
+    {
+        writeString(path.generic_string());
+        write(getSourceFileStamp(path));
+    }
+}
+
+void ResourceCacheWriter::writeBytes(const void* data, size_t size)
+{
+    if (size == 0)
+        return;
+    size_t position = m_data.size();
+    m_data.resize(position + size);
+    std::memcpy(m_data.data() + position, data, size);
+}
+
+void ResourceCacheWriter::writeString(const std::string& string)
+{
+    write(static_cast<uint32_t>(string.size()));
+    writeBytes(string.data(), string.size());
+}
+
+bool ResourceCacheWriter::save(const std::filesystem::path& cachePath) const
+{
+    std::error_code error;
+    if (cachePath.has_parent_path())
+        std::filesystem::create_directories(cachePath.parent_path(), error);
+
+    // Give the temporary file a unique name in case another process or thread is saving the
+    // same cache
+    std::filesystem::path tempPath = cachePath;
+    tempPath += ".tmp" + std::to_string(
+        std::hash<std::thread::id>()(std::this_thread::get_id())
+        ^ std::chrono::steady_clock::now().time_since_epoch().count()
+    );
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(m_data.data()), m_data.size());
+        if (!file)
+        {
+            LOG("Failed to write " + tempPath.string());
+            return false;
+        }
+    }
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error)
+    {
+        LOG("Failed to save " + cachePath.string() + ": " + error.message());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+ResourceCacheReader::ResourceCacheReader() : m_position(0), m_failed(false) {}
+
+bool ResourceCacheReader::open(
+    const std::filesystem::path& cachePath, uint32_t magic, uint32_t version,
+    const std::vector<std::filesystem::path>& sourceFiles
+) {
+    m_position = 0;
+    m_failed = false;
+    if (!m_file.open(cachePath))
+        return false;
+
+    if (read<uint32_t>() != magic || read<uint32_t>() != version
+        || read<uint32_t>() != sourceFiles.size())
+    {
+        return false;
+    }
+    for (const std::filesystem::path& path : sourceFiles)
+    {
+        if (readString() != path.generic_string())
+            return false;
+        SourceFileStamp cachedStamp = read<SourceFileStamp>();
+        SourceFileStamp stamp = getSourceFileStamp(path);
+        if (cachedStamp.size != stamp.size
+            || cachedStamp.modificationTime != stamp.modificationTime)
+        {
+            return false;
+        }
+    }
+    return !m_failed;
+}
+
+const uint8_t* ResourceCacheReader::readBytes(size_t size)
+{
+    if (m_failed || size > m_file.getSize() - m_position)
+    {
+        m_failed = true;
+        return nullptr;
+    }
+    const uint8_t* bytes = m_file.getData() + m_position;
+    m_position += size;
+    return bytes;
+}
+
+std::string ResourceCacheReader::readString()
+{
+    uint32_t size = read<uint32_t>();
+    const uint8_t* bytes = readBytes(size);
+    if (bytes == nullptr)
+        return "";
+    return std::string(reinterpret_cast<const char*>(bytes), size);
+}
+
+}  // namespace lonelycube
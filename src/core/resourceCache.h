@@ -0,0 +1,96 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+#include <type_traits>
+
+#include "core/utils/mappedFile.h"
+
+namespace lonelycube {
+
+// Binary caches of resources that are slow to parse or decode. Every cache starts with a magic
+// number, a format version and the size and modification time of each of the source files it
+// was built from, so a cache is only used while all of them are unchanged. Values are stored in
+// the native byte order, as caches are never shared between machines.
+class ResourceCacheWriter
+{
+private:
+    std::vector<uint8_t> m_data;
+
+public:
+    ResourceCacheWriter(
+        uint32_t magic, uint32_t version, const std::vector<std::filesystem::path>& sourceFiles
+    );
+
+    void writeBytes(const void* data, size_t size);
+    void writeString(const std::string& string);
+    template<typename T>
+    void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        writeBytes(&value, sizeof(T));
+    }
+
+    // Writes to a temporary file that then replaces the cache, so that a cache is never left
+    // half written. Returns false if it couldn't be written
+    bool save(const std::filesystem::path& cachePath) const;
+};
+
+class ResourceCacheReader
+{
+private:
+    MappedFile m_file;
+    size_t m_position;
+    bool m_failed;
+
+public:
+    ResourceCacheReader();
+
+    // Maps the cache, and returns false unless it was written with the same magic number and
+    // version from the current versions of sourceFiles
+    bool open(
+        const std::filesystem::path& cachePath, uint32_t magic, uint32_t version,
+        const std::vector<std::filesystem::path>& sourceFiles
+    );
+
+    // Returns a pointer into the mapped cache, which is valid until the reader is destroyed, or
+    // nullptr if there aren't enough bytes left
+    const uint8_t* readBytes(size_t size);
+    std::string readString();
+    template<typename T>
+    T read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value{};
+        const uint8_t* bytes = readBytes(sizeof(T));
+        if (bytes != nullptr)
+            std::memcpy(&value, bytes, sizeof(T));
+        return value;
+    }
+
+    // Whether any read ran past the end of the cache
+    inline bool failed() const
+    {
+        return m_failed;
+    }
+};
+
+}  // namespace lonelycube
@@ -20,6 +20,7 @@
 
 #include "core/log.h"
 #include <unordered_map>
+#include "core/resourceCache.h"
 #include "core/resourcePack.h"
 
 namespace lonelycube {
@@ -37,7 +38,46 @@ bool ResourcePack::isTrue(std::basic_istream<char>& stream) const {
     return false;
 }
 
-ResourcePack::ResourcePack(std::filesystem::path resourcePackPath) {
+ResourcePack::ResourcePack(std::filesystem::path resourcePackPath) : m_loadedFromCache(false) {
+    // Every file of the block table is a source of the cache, so adding or removing one also
+    // makes the cache stale
+    std::vector<std::filesystem::path> sourceFiles;
+    std::error_code error;
+    for (const auto& entry :
+        std::filesystem::recursive_directory_iterator(resourcePackPath/"blocks", error)) {
+        if (entry.is_regular_file(error)) {
+            sourceFiles.push_back(entry.path());
+        }
+    }
+    std::sort(sourceFiles.begin(), sourceFiles.end());
+
+    std::array<int, 256> modelIndices;
+    std::filesystem::path cachePath = getCachePath(resourcePackPath);
+    m_loadedFromCache = loadCache(cachePath, sourceFiles, modelIndices);
+    if (!m_loadedFromCache) {
+        parse(resourcePackPath, modelIndices);
+        calculateTextureCoordinates(modelIndices);
+        saveCache(cachePath, sourceFiles, modelIndices);
+    }
+
+    // Fill in the block model pointers
+    for (int i = 0; i < 256; i++)
+        m_blockData[i].model = modelIndices[i] == -1 ? nullptr : &m_blockModels[modelIndices[i]];
+
+    buildPropertyTables();
+}
+
+std::filesystem::path ResourcePack::getCachePath(const std::filesystem::path& resourcePackPath) {
+    std::filesystem::path path = resourcePackPath.lexically_normal();
+    if (!path.has_filename()) {
+        path = path.parent_path();
+    }
+    return path.parent_path()/"cache"/(path.filename().string() + ".bin");
+}
+
+void ResourcePack::parse(
+    const std::filesystem::path& resourcePackPath, std::array<int, 256>& modelIndices
+) {
     // Parse block names
     std::ifstream stream(resourcePackPath/"blocks/blockNames.json");
     stream.ignore(std::numeric_limits<std::streamsize>::max(), '"');
@@ -55,7 +95,6 @@ ResourcePack::ResourcePack(std::filesystem::path resourcePackPath) {
     stream.close();
 
     std::vector<std::string> modelNames;
-    std::array<int, 256> modelIndices;
 
     // Parse block data
     for (int blockID = 0; blockID < 256; blockID++) {
@@ -255,10 +294,173 @@ ResourcePack::ResourcePack(std::filesystem::path resourcePackPath) {
             stream.ignore(std::numeric_limits<std::streamsize>::max(), '"');
         }
     }
+}
 
-    // Fill in the block model pointers
-    for (int i = 0; i < 256; i++)
-        m_blockData[i].model = modelIndices[i] == -1 ? nullptr : &m_blockModels[modelIndices[i]];
+void ResourcePack::calculateTextureCoordinates(const std::array<int, 256>& modelIndices) {
+    for (int blockID = 0; blockID < 256; blockID++) {
+        BlockData& blockData = m_blockData[blockID];
+        blockData.faceTextureCoordinates.clear();
+        if (modelIndices[blockID] == -1) {
+            continue;
+        }
+        const Model& model = m_blockModels[modelIndices[blockID]];
+        blockData.faceTextureCoordinates.resize(model.faces.size() * 8);
+        for (std::size_t faceNum = 0; faceNum < model.faces.size(); faceNum++) {
+            // Faces without a texture of their own use the first texture in the atlas
+            int textureIndex = faceNum < blockData.faceTextureIndices.size()
+                ? blockData.faceTextureIndices[faceNum] : 0;
+            getTextureCoordinates(
+                &blockData.faceTextureCoordinates[faceNum * 8], model.faces[faceNum].UVcoords,
+                textureIndex
+            );
+        }
+    }
+}
+
+void ResourcePack::buildPropertyTables() {
+    for (int blockID = 0; blockID < 256; blockID++) {
+        const BlockData& blockData = m_blockData[blockID];
+        uint8_t flags = 0;
+        flags |= blockData.transparent * FLAG_TRANSPARENT;
+        flags |= blockData.dimsLight * FLAG_DIMS_LIGHT;
+        flags |= blockData.castsAmbientOcclusion * FLAG_CASTS_AMBIENT_OCCLUSION;
+        flags |= blockData.collidable * FLAG_COLLIDABLE;
+
+        uint8_t cullMask = 0;
+        if (blockData.model != nullptr) {
+            bool allFacesCulled = !blockData.model->faces.empty();
+            for (const Face& face : blockData.model->faces) {
+                if (face.cullFace >= 0) {
+                    cullMask |= 1 << face.cullFace;
+                }
+                else {
+                    allFacesCulled = false;
+                }
+            }
+
+            // The first and sixth bounding box vertices are the minimum and maximum corners
+            const float* boundingBox = blockData.model->boundingBoxVertices;
+            bool fillsBlock = true;
+            for (int axis = 0; axis < 3; axis++) {
+                fillsBlock &= boundingBox[axis] == -0.5f && boundingBox[15 + axis] == 0.5f;
+            }
+            flags |= (allFacesCulled && cullMask == 0b111111 && fillsBlock) * FLAG_FULL_CUBE;
+        }
+
+        m_blockFlags[blockID] = flags;
+        m_blockLights[blockID] = blockData.blockLight;
+        m_cullMasks[blockID] = cullMask;
+    }
+}
+
+bool ResourcePack::loadCache(
+    const std::filesystem::path& cachePath, const std::vector<std::filesystem::path>& sourceFiles,
+    std::array<int, 256>& modelIndices
+) {
+    ResourceCacheReader reader;
+    if (!reader.open(cachePath, CACHE_MAGIC, CACHE_VERSION, sourceFiles)
+        || reader.read<uint32_t>() != sizeof(Face)) {
+        return false;
+    }
+
+    // Counts are checked against the bytes left by reading the data before resizing, so that a
+    // truncated cache can't cause a huge allocation
+    uint32_t numModels = reader.read<uint32_t>();
+    for (uint32_t modelNum = 0; modelNum < numModels && !reader.failed(); modelNum++) {
+        uint32_t numFaces = reader.read<uint32_t>();
+        const uint8_t* faces = reader.readBytes(static_cast<size_t>(numFaces) * sizeof(Face));
+        const uint8_t* boundingBox = reader.readBytes(sizeof(Model::boundingBoxVertices));
+        if (reader.failed()) {
+            break;
+        }
+        Model& model = m_blockModels.emplace_back();
+        model.faces.resize(numFaces);
+        std::memcpy(model.faces.data(), faces, numFaces * sizeof(Face));
+        std::memcpy(model.boundingBoxVertices, boundingBox, sizeof(model.boundingBoxVertices));
+    }
+
+    bool valid = !reader.failed();
+    for (int blockID = 0; blockID < 256 && valid; blockID++) {
+        BlockData& blockData = m_blockData[blockID];
+        blockData.name = reader.readString();
+        modelIndices[blockID] = reader.read<int32_t>();
+        uint32_t numTextureIndices = reader.read<uint32_t>();
+        const uint8_t* textureIndices = reader.readBytes(
+            static_cast<size_t>(numTextureIndices) * sizeof(uint16_t)
+        );
+        uint32_t numTextureCoordinates = reader.read<uint32_t>();
+        const uint8_t* textureCoordinates = reader.readBytes(
+            static_cast<size_t>(numTextureCoordinates) * sizeof(float)
+        );
+        blockData.blockLight = reader.read<uint8_t>();
+        blockData.transparent = reader.read<uint8_t>();
+        blockData.dimsLight = reader.read<uint8_t>();
+        blockData.castsAmbientOcclusion = reader.read<uint8_t>();
+        blockData.collidable = reader.read<uint8_t>();
+        if (reader.failed() || modelIndices[blockID] < -1
+            || modelIndices[blockID] >= static_cast<int>(m_blockModels.size())) {
+            valid = false;
+            break;
+        }
+        blockData.faceTextureIndices.resize(numTextureIndices);
+        std::memcpy(
+            blockData.faceTextureIndices.data(), textureIndices,
+            numTextureIndices * sizeof(uint16_t)
+        );
+        blockData.faceTextureCoordinates.resize(numTextureCoordinates);
+        std::memcpy(
+            blockData.faceTextureCoordinates.data(), textureCoordinates,
+            numTextureCoordinates * sizeof(float)
+        );
+    }
+
+    if (!valid) {
+        LOG("Ignoring invalid resource pack cache " + cachePath.string());
+        m_blockModels.clear();
+        m_blockData = {};
+        return false;
+    }
+    return true;
+}
+
+void ResourcePack::saveCache(
+    const std::filesystem::path& cachePath, const std::vector<std::filesystem::path>& sourceFiles,
+    const std::array<int, 256>& modelIndices
+) const {
+    ResourceCacheWriter writer(CACHE_MAGIC, CACHE_VERSION, sourceFiles);
+    writer.write(static_cast<uint32_t>(sizeof(Face)));
+
+    writer.write(static_cast<uint32_t>(m_blockModels.size()));
+    for (const Model& model : m_blockModels) {
+        writer.write(static_cast<uint32_t>(model.faces.size()));
+        writer.writeBytes(model.faces.data(), model.faces.size() * sizeof(Face));
+        writer.writeBytes(model.boundingBoxVertices, sizeof(model.boundingBoxVertices));
+    }
+
+    for (int blockID = 0; blockID < 256; blockID++) {
+        const BlockData& blockData = m_blockData[blockID];
+        writer.writeString(blockData.name);
+        writer.write(static_cast<int32_t>(modelIndices[blockID]));
+        writer.write(static_cast<uint32_t>(blockData.faceTextureIndices.size()));
+        writer.writeBytes(
+            blockData.faceTextureIndices.data(),
+            blockData.faceTextureIndices.size() * sizeof(uint16_t)
+        );
+        writer.write(static_cast<uint32_t>(blockData.faceTextureCoordinates.size()));
+        writer.writeBytes(
+            blockData.faceTextureCoordinates.data(),
+            blockData.faceTextureCoordinates.size() * sizeof(float)
+        );
+        writer.write(blockData.blockLight);
+        writer.write(static_cast<uint8_t>(blockData.transparent));
+        writer.write(static_cast<uint8_t>(blockData.dimsLight));
+        writer.write(static_cast<uint8_t>(blockData.castsAmbientOcclusion));
+        writer.write(static_cast<uint8_t>(blockData.collidable));
+    }
+
+    if (writer.save(cachePath)) {
+        LOG("Built resource pack cache " + cachePath.string());
+    }
 }
 
 void ResourcePack::getTextureCoordinates(
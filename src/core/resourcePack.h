@@ -39,6 +39,8 @@ struct BlockData {
     std::string name;
     Model* model;
     std::vector<uint16_t> faceTextureIndices;
+    // The texture atlas coordinates of the corners of each face, 8 floats per face
+    std::vector<float> faceTextureCoordinates;
     uint8_t blockLight;
     bool transparent;
     bool dimsLight;
@@ -46,16 +48,48 @@ struct BlockData {
     bool collidable;
 };
 
+// The block table and models parsed from a resource pack's JSON files. They are also compiled
+// into a binary cache, which is loaded instead until any of the JSON files change.
 class ResourcePack {
 private:
+    static constexpr uint32_t CACHE_MAGIC = 0x4b50434c;  // "LCPK"
+    static constexpr uint32_t CACHE_VERSION = 1;
+
+    // Bits of m_blockFlags
+    static constexpr uint8_t FLAG_TRANSPARENT = 1 << 0;
+    static constexpr uint8_t FLAG_DIMS_LIGHT = 1 << 1;
+    static constexpr uint8_t FLAG_CASTS_AMBIENT_OCCLUSION = 1 << 2;
+    static constexpr uint8_t FLAG_COLLIDABLE = 1 << 3;
+    static constexpr uint8_t FLAG_FULL_CUBE = 1 << 4;
+
     std::vector<Model> m_blockModels;
     std::array<BlockData, 256> m_blockData;
+    // Dense copies of the block properties read in hot loops, so that looking one up touches a
+    // byte of a small table rather than a whole BlockData
+    std::array<uint8_t, 256> m_blockFlags;
+    std::array<uint8_t, 256> m_blockLights;
+    std::array<uint8_t, 256> m_cullMasks;
+    bool m_loadedFromCache;
 
     bool isTrue(std::basic_istream<char>& stream) const;
+    void parse(const std::filesystem::path& resourcePackPath, std::array<int, 256>& modelIndices);
+    void calculateTextureCoordinates(const std::array<int, 256>& modelIndices);
+    void buildPropertyTables();
+    bool loadCache(
+        const std::filesystem::path& cachePath,
+        const std::vector<std::filesystem::path>& sourceFiles, std::array<int, 256>& modelIndices
+    );
+    void saveCache(
+        const std::filesystem::path& cachePath,
+        const std::vector<std::filesystem::path>& sourceFiles,
+        const std::array<int, 256>& modelIndices
+    ) const;
 
 public:
     static void getTextureCoordinates(
         float* coords, const float* textureBox, const int textureNum);
+    // Where the binary cache of the resource pack is kept, in a cache folder next to it
+    static std::filesystem::path getCachePath(const std::filesystem::path& resourcePackPath);
 
     ResourcePack(std::filesystem::path resourcePackPath);
     const BlockData& getBlockData(int blockType) const
@@ -66,6 +100,43 @@ public:
     {
         return m_blockModels.at(modelIndex);
     }
+
+    inline bool isTransparent(uint8_t blockType) const
+    {
+        return m_blockFlags[blockType] & FLAG_TRANSPARENT;
+    }
+    inline bool dimsLight(uint8_t blockType) const
+    {
+        return m_blockFlags[blockType] & FLAG_DIMS_LIGHT;
+    }
+    inline bool castsAmbientOcclusion(uint8_t blockType) const
+    {
+        return m_blockFlags[blockType] & FLAG_CASTS_AMBIENT_OCCLUSION;
+    }
+    inline bool isCollidable(uint8_t blockType) const
+    {
+        return m_blockFlags[blockType] & FLAG_COLLIDABLE;
+    }
+    // Whether the block's model fills the whole block and every one of its faces is culled by
+    // an opaque neighbour
+    inline bool isFullCube(uint8_t blockType) const
+    {
+        return m_blockFlags[blockType] & FLAG_FULL_CUBE;
+    }
+    inline uint8_t getBlockLight(uint8_t blockType) const
+    {
+        return m_blockLights[blockType];
+    }
+    // Bit n is set if the block's model has a face that is culled by an opaque neighbour in
+    // direction n, using the same direction numbers as Face::cullFace
+    inline uint8_t getCullMask(uint8_t blockType) const
+    {
+        return m_cullMasks[blockType];
+    }
+    bool wasLoadedFromCache() const
+    {
+        return m_loadedFromCache;
+    }
 };
 
 }  // namespace lonelycube
@@ -21,6 +21,7 @@
 #include "core/pch.h"
 
 #include "core/chunk.h"
+#include "core/profiler.h"
 #include "core/utils/iVec3.h"
 
 namespace lonelycube {
@@ -82,7 +83,7 @@ ServerPlayer::ServerPlayer(
     uint64_t gameTick
 ) : m_renderDistance(renderDistance), m_renderDiameter(renderDistance * 2 + 1),
     m_targetBufferSize(0), m_currentNumLoadedChunks(0), m_numChunkRequests(0), m_playerID(playerID),
-    m_peer(peer), m_lastPacketTick(gameTick)
+    m_peer(peer), m_lastPacketTick(gameTick), m_chunksToSendSorted(true)
 {
     m_blockPos[0] = blockPos[0];
     m_blockPos[1] = blockPos[1];
@@ -94,6 +95,9 @@ ServerPlayer::ServerPlayer(
     m_playerChunkPos[0] = playerChunkPos.x;
     m_playerChunkPos[1] = playerChunkPos.y;
     m_playerChunkPos[2] = playerChunkPos.z;
+    m_unloadRegionMin = playerChunkPos;
+    m_unloadRegionMax = playerChunkPos;
+    m_loadedChunks = ToroidalChunkGrid(m_renderDiameter);
     calculateMaxNumChunks();
     initChunkLoadingOrder();
 }
@@ -102,7 +106,8 @@ ServerPlayer::ServerPlayer(
 ServerPlayer::ServerPlayer(
     uint32_t playerID, int* blockPos, float* subBlockPos, int renderDistance, bool multiplayer
 ) : m_renderDistance(renderDistance), m_renderDiameter(renderDistance * 2 + 1),
-    m_targetBufferSize(90), m_currentNumLoadedChunks(0), m_numChunkRequests(0), m_playerID(playerID)
+    m_targetBufferSize(90), m_currentNumLoadedChunks(0), m_numChunkRequests(0), m_playerID(playerID),
+    m_chunksToSendSorted(true)
 {
     m_blockPos[0] = blockPos[0];
     m_blockPos[1] = blockPos[1];
@@ -114,6 +119,9 @@ ServerPlayer::ServerPlayer(
     m_playerChunkPos[0] = playerChunkPos.x;
     m_playerChunkPos[1] = playerChunkPos.y;
     m_playerChunkPos[2] = playerChunkPos.z;
+    m_unloadRegionMin = playerChunkPos;
+    m_unloadRegionMax = playerChunkPos;
+    m_loadedChunks = ToroidalChunkGrid(m_renderDiameter);
     calculateMaxNumChunks();
     initChunkLoadingOrder();
 }
@@ -126,9 +134,16 @@ void ServerPlayer::updatePlayerPos(const IVec3& blockPos, const Vec3& subBlockPo
     m_subBlockPos[1] = subBlockPos[1];
     m_subBlockPos[2] = subBlockPos[2];
     IVec3 playerChunkPos = Chunk::getChunkCoords(blockPos);
+    if (playerChunkPos != getChunkPosition())
+        m_chunksToSendSorted = false;
     m_playerChunkPos[0] = playerChunkPos[0];
     m_playerChunkPos[1] = playerChunkPos[1];
     m_playerChunkPos[2] = playerChunkPos[2];
+    for (int i = 0; i < 3; i++)
+    {
+        m_unloadRegionMin[i] = std::min(m_unloadRegionMin[i], playerChunkPos[i]);
+        m_unloadRegionMax[i] = std::max(m_unloadRegionMax[i], playerChunkPos[i]);
+    }
 }
 
 bool ServerPlayer::updateNextUnloadedChunk()
@@ -147,35 +162,118 @@ void ServerPlayer::getNextChunkCoords(int* chunkCoords, uint64_t currentGameTick
     chunkCoords[0] = m_chunkLoadingOrder[m_nextUnloadedChunk].x + m_playerChunkPos[0];
     chunkCoords[1] = m_chunkLoadingOrder[m_nextUnloadedChunk].y + m_playerChunkPos[1];
     chunkCoords[2] = m_chunkLoadingOrder[m_nextUnloadedChunk].z + m_playerChunkPos[2];
-    m_loadedChunks[chunkCoords] = currentGameTick;
+    setChunkLoaded(chunkCoords, currentGameTick);
     m_nextUnloadedChunk++;
 }
 
+static int integerSqrt(int value)
+{
+    int root = std::sqrt(static_cast<float>(value));
+    while (root * root > value)
+        root--;
+    while ((root + 1) * (root + 1) <= value)
+        root++;
+    return root;
+}
+
+void ServerPlayer::findChunksOutOfRange()
+{
+    IVec3 playerChunkPos = getChunkPosition();
+    bool regionWiderThanGrid = false;
+    for (int i = 0; i < 3; i++)
+        regionWiderThanGrid |= m_unloadRegionMax[i] - m_unloadRegionMin[i] >= m_renderDiameter;
+
+    if (regionWiderThanGrid)
+    {
+        // The player has moved far enough that there is little overlap between their old and
+        // new render distances, so it is quicker to check every loaded chunk
+        m_loadedChunks.forEachChunk([&](const IVec3& chunkPosition) {
+            IVec3 offset = chunkPosition - playerChunkPos;
+            if (offset.x * offset.x + offset.y * offset.y + offset.z * offset.z
+                >= m_maxLoadedChunkDistance)
+            {
+                m_chunksToUnload.push_back(chunkPosition);
+            }
+        });
+        for (std::size_t i = 0; i < m_chunksToUnload.size(); i++)
+            m_loadedChunks.erase(m_chunksToUnload[i]);
+        return;
+    }
+
+    // Only visit the chunks that were within render distance of one of the player's previous
+    // positions but are not within render distance of their current position. For each column
+    // of chunks, these are the z-range covered by the old positions minus the z-range covered
+    // by the current one.
+    for (int x = m_unloadRegionMin.x - m_renderDistance;
+        x <= m_unloadRegionMax.x + m_renderDistance; x++)
+    {
+        int oldX = std::max({ m_unloadRegionMin.x - x, x - m_unloadRegionMax.x, 0 });
+        int newX = x - playerChunkPos.x;
+        for (int y = m_unloadRegionMin.y - m_renderDistance;
+            y <= m_unloadRegionMax.y + m_renderDistance; y++)
+        {
+            int oldY = std::max({ m_unloadRegionMin.y - y, y - m_unloadRegionMax.y, 0 });
+            int oldRemaining = m_maxLoadedChunkDistance - 1 - oldX * oldX - oldY * oldY;
+            if (oldRemaining < 0)
+                continue;
+            int oldHalfHeight = integerSqrt(oldRemaining);
+
+            int newY = y - playerChunkPos.y;
+            int newRemaining = m_maxLoadedChunkDistance - 1 - newX * newX - newY * newY;
+            int newMinZ = std::numeric_limits<int>::max();
+            int newMaxZ = std::numeric_limits<int>::min();
+            if (newRemaining >= 0)
+            {
+                int newHalfHeight = integerSqrt(newRemaining);
+                newMinZ = playerChunkPos.z - newHalfHeight;
+                newMaxZ = playerChunkPos.z + newHalfHeight;
+            }
+
+            for (int z = m_unloadRegionMin.z - oldHalfHeight;
+                z <= m_unloadRegionMax.z + oldHalfHeight; z++)
+            {
+                if (z >= newMinZ && z <= newMaxZ)
+                {
+                    z = newMaxZ;
+                    continue;
+                }
+                IVec3 chunkPosition(x, y, z);
+                if (m_loadedChunks.erase(chunkPosition))
+                    m_chunksToUnload.push_back(chunkPosition);
+            }
+        }
+    }
+}
+
 void ServerPlayer::beginUnloadingChunksOutOfRange()
 {
-    m_processedChunk = m_loadedChunks.begin();
+    findChunksOutOfRange();
+    m_unloadRegionMin = getChunkPosition();
+    m_unloadRegionMax = getChunkPosition();
+}
+
+void ServerPlayer::beginUnloadingAllChunks()
+{
+    m_loadedChunks.forEachChunk([&](const IVec3& chunkPosition) {
+        m_chunksToUnload.push_back(chunkPosition);
+    });
+    m_loadedChunks.clear();
 }
 
 bool ServerPlayer::checkIfNextChunkShouldUnload(IVec3* chunkPosition, bool* chunkOutOfRange)
 {
-    if (m_processedChunk == m_loadedChunks.end()) {
+    if (m_chunksToUnload.empty()) {
         m_nextUnloadedChunk = 0;
         m_currentNumLoadedChunks = 0;
         *chunkOutOfRange = false;
         return false;
     }
 
-    int a = m_processedChunk->first.x - m_playerChunkPos[0];
-    int b = m_processedChunk->first.y - m_playerChunkPos[1];
-    int c = m_processedChunk->first.z - m_playerChunkPos[2];
-    *chunkOutOfRange = a * a + b * b + c * c >= m_maxLoadedChunkDistance;
-    if (*chunkOutOfRange) {
-        *chunkPosition = m_processedChunk->first;
-        m_processedChunk = m_loadedChunks.erase(m_processedChunk);
-    }
-    else {
-        m_processedChunk++;
-    }
+    *chunkPosition = m_chunksToUnload.back();
+    m_chunksToUnload.pop_back();
+    // The chunk may have been loaded again since it was queued, in which case the player must
+    // stay subscribed to it
+    *chunkOutOfRange = !m_loadedChunks.contains(*chunkPosition);
 
     return true;
 }
@@ -199,13 +297,48 @@ void ServerPlayer::setChunkLoadingTarget(int target, uint64_t currentTickNum)
 
     // If the server thinks the target chunk was already sent to the client
     // a long time ago, resend it because the client has probably unloaded it
-    auto it = m_loadedChunks.find(m_chunkLoadingOrder[target] + m_playerChunkPos);
-    if (it != m_loadedChunks.end() && it->second + constants::TICKS_PER_SECOND < currentTickNum)
+    IVec3 chunkPosition = m_chunkLoadingOrder[target] + m_playerChunkPos;
+    uint64_t sendTick;
+    if (m_loadedChunks.getTick(chunkPosition, &sendTick)
+        && sendTick + constants::TICKS_PER_SECOND < currentTickNum)
     {
         LOG("Resending " + std::to_string(target));
-        m_loadedChunks.erase(it);
+        m_loadedChunks.erase(chunkPosition);
         m_nextUnloadedChunk = target;
     }
 }
 
+void ServerPlayer::queueChunkToSend(const IVec3& chunkPosition)
+{
+    m_chunksToSend.push_back({ chunkPosition, Profiler::now() });
+    m_chunksToSendSorted = false;
+}
+
+bool ServerPlayer::getNextChunkToSend(IVec3* chunkPosition, int64_t* queueTime)
+{
+    if (m_chunksToSend.empty())
+        return false;
+
+    // Keep the queue sorted with the closest chunk to the player at the back
+    if (!m_chunksToSendSorted)
+    {
+        IVec3 playerChunkPos = getChunkPosition();
+        std::sort(m_chunksToSend.begin(), m_chunksToSend.end(),
+            [&](const ChunkToSend& a, const ChunkToSend& b) {
+                IVec3 aOffset = a.position - playerChunkPos;
+                IVec3 bOffset = b.position - playerChunkPos;
+                int aDistance = aOffset.x * aOffset.x + aOffset.y * aOffset.y + aOffset.z * aOffset.z;
+                int bDistance = bOffset.x * bOffset.x + bOffset.y * bOffset.y + bOffset.z * bOffset.z;
+                return aDistance > bDistance;
+            }
+        );
+        m_chunksToSendSorted = true;
+    }
+
+    *chunkPosition = m_chunksToSend.back().position;
+    *queueTime = m_chunksToSend.back().queueTime;
+    m_chunksToSend.pop_back();
+    return true;
+}
+
 }  // namespace lonelycube
@@ -22,14 +22,22 @@
 
 #include "core/pch.h"
 
+#include "core/chunkSendScheduler.h"
 #include "core/constants.h"
 #include "core/log.h"
+#include "core/toroidalChunkGrid.h"
 #include "core/utils/iVec3.h"
 
 namespace lonelycube {
 
 class ServerPlayer {
 private:
+    struct ChunkToSend
+    {
+        IVec3 position;
+        int64_t queueTime;
+    };
+
     int m_renderDistance;
     int m_renderDiameter;
     int m_maxLoadedChunkDistance;
@@ -49,11 +57,18 @@ private:
     uint32_t m_playerID;
     ENetPeer* m_peer;
     uint64_t m_lastPacketTick;
-    std::map<IVec3, uint64_t> m_loadedChunks;
-    std::map<IVec3, uint64_t>::iterator m_processedChunk;
+    ToroidalChunkGrid m_loadedChunks;
+    std::vector<IVec3> m_chunksToUnload;
+    // The bounding box of the player's chunk positions since chunks were last unloaded
+    IVec3 m_unloadRegionMin;
+    IVec3 m_unloadRegionMax;
+    ChunkSendScheduler m_chunkSendScheduler;
+    std::vector<ChunkToSend> m_chunksToSend;
+    bool m_chunksToSendSorted;
 
     void initChunkLoadingOrder();
     void calculateMaxNumChunks();
+    void findChunksOutOfRange();
 
 public:
     ServerPlayer() {};
@@ -69,13 +84,19 @@ public:
     bool updateNextUnloadedChunk();
     void getNextChunkCoords(int* chunkCoords, uint64_t currentGameTick);
     void beginUnloadingChunksOutOfRange();
+    void beginUnloadingAllChunks();
     bool checkIfNextChunkShouldUnload(IVec3* chunkPosition, bool* chunkOutOfRange);
     bool updateChunkLoadingTarget();
     void setChunkLoadingTarget(int target, uint64_t currentTickNum);
+    void queueChunkToSend(const IVec3& chunkPosition);
+    // queueTime is set to when the chunk was queued, from Profiler::now
+    bool getNextChunkToSend(IVec3* chunkPosition, int64_t* queueTime);
 
     inline void setChunkLoaded(const IVec3& chunkPosition, uint64_t currentGameTick)
     {
-        m_loadedChunks[chunkPosition] = currentGameTick;
+        IVec3 evictedChunk;
+        if (m_loadedChunks.insert(chunkPosition, currentGameTick, &evictedChunk))
+            m_chunksToUnload.push_back(evictedChunk);
     }
 
     inline uint32_t getID() const {
@@ -86,6 +107,11 @@ public:
         return m_peer;
     }
 
+    inline ChunkSendScheduler& getChunkSendScheduler()
+    {
+        return m_chunkSendScheduler;
+    }
+
     inline void getChunkPosition(int* position) {
         position[0] = m_playerChunkPos[0];
         position[1] = m_playerChunkPos[1];
@@ -26,15 +26,19 @@
 #include "core/block.h"
 #include "core/chunk.h"
 #include "core/chunkManager.h"
+#include "core/chunkPipelineStats.h"
 #include "core/compression.h"
 #include "core/constants.h"
 #include "core/entities/entityManager.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/packet.h"
+#include "core/profiler.h"
 #include "core/random.h"
 #include "core/resourcePack.h"
 #include "core/serverPlayer.h"
 #include "core/terrainGen.h"
+#include <bit>
 #include <chrono>
 
 namespace lonelycube {
@@ -52,20 +56,34 @@ private:
     std::chrono::time_point<std::chrono::steady_clock> m_timeOfLastTick;
 
     // World
+    struct ChunkBeingLoaded
+    {
+        uint32_t subscribers;  // The players that will be given the chunk once it has loaded
+        bool generating;
+        int64_t queueTime;
+    };
     std::unordered_map<uint32_t, ServerPlayer> m_players;
     std::queue<IVec3> m_chunksToBeLoaded;
-    std::unordered_set<IVec3> m_chunksBeingLoaded;
+    std::unordered_map<IVec3, ChunkBeingLoaded> m_chunksBeingLoaded;
     std::unordered_set<uint32_t> m_playersUnloadingChunks;
 
     EntityManager m_entityManager;
 
+    // Metrics, which are only updated by the physical server
+    std::array<Counter*, constants::MAX_PLAYERS> m_bytesSentCounters;
+
     // Synchronisation
     std::mutex m_playersMtx;
     std::mutex m_chunksToBeLoadedMtx;
     std::mutex m_chunksBeingLoadedMtx;
     std::mutex& m_networkingMtx;
-    bool m_threadsWait;
-    std::vector<bool> m_threadWaiting;
+
+    static constexpr int UNLOAD_BATCH_SIZE = 256;
+    // A byte of block type, five bits of sky light and four bits of block light for each block
+    static constexpr int UNCOMPRESSED_CHUNK_SIZE = constants::CHUNK_SIZE * constants::CHUNK_SIZE
+        * constants::CHUNK_SIZE * 17 / 8;
+
+    void unsubscribeFromChunk(uint32_t playerID, const IVec3& chunkPosition);
 
 public:
     ServerWorld(uint64_t seed, std::mutex& networkingMtx);
@@ -87,14 +105,13 @@ public:
     std::unordered_map<uint32_t, ServerPlayer>& getPlayers() {
         return m_players;
     }
-    void waitIfRequired(uint8_t threadNum);
-    void pauseChunkLoaderThreads();
-    void releaseChunkLoaderThreads();
     void findChunksToLoad();  // Must be called with m_chunksToBeLoadedMtx locked
     bool loadNextChunk(IVec3* chunkPosition);
+    void sendQueuedChunks();
     void loadChunkFromPacket(Packet<uint8_t, 9 * constants::CHUNK_SIZE *
         constants::CHUNK_SIZE * constants::CHUNK_SIZE>& payload, IVec3& chunkPosition);
     bool isChunkLoaded(IVec3 chunkPosition);
+    size_t getChunkLoadQueueLength();
     void broadcastBlockReplaced(int* blockCoords, int blockType, int originalPlayerID);
     float getTimeSinceLastTick();
     inline int8_t getNumChunkLoaderThreads() {
@@ -122,15 +139,14 @@ public:
 template<bool integrated>
 ServerWorld<integrated>::ServerWorld(uint64_t seed, std::mutex& networkingMtx)
     : m_seed(seed), m_gameTick(0), m_resourcePack("res/resourcePack"), m_entityManager(10000,
-    chunkManager, m_resourcePack), m_networkingMtx(networkingMtx), m_threadsWait(false)
+    chunkManager, m_resourcePack), m_networkingMtx(networkingMtx)
 {
     PCG_SeedRandom32(m_seed);
     seedNoise();
     m_players.reserve(32);
 
     m_numChunkLoadingThreads = std::max(1u, std::min(32u, std::thread::hardware_concurrency()));
-    m_threadWaiting.resize(m_numChunkLoadingThreads);
-    std::fill(m_threadWaiting.begin(), m_threadWaiting.end(), false);
+    m_bytesSentCounters.fill(nullptr);
 }
 
 template<bool integrated>
@@ -138,9 +154,7 @@ void ServerWorld<integrated>::updatePlayerPos(
     uint32_t playerID, const IVec3& blockPosition, const Vec3& subBlockPosition,
     bool playerMovedChunk
 ) {
-    // LOG("r waiting for mutex");
-    // std::lock_guard<std::mutex> lock(m_playersMtx);
-    // LOG("r aquired mutex");
+    std::lock_guard<std::mutex> lock(m_playersMtx);
     ServerPlayer& player = m_players.at(playerID);
     player.updatePlayerPos(blockPosition, subBlockPosition);
     if (playerMovedChunk)
@@ -154,60 +168,98 @@ void ServerWorld<integrated>::updatePlayerPos(
 template<bool integrated>
 void ServerWorld<integrated>::unloadChunksOutOfRange()
 {
-    IVec3 chunkPosition;
-    bool chunkOutOfRange;
-    m_playersMtx.lock();
-    auto itr = m_playersUnloadingChunks.begin();
-    auto startTime = std::chrono::steady_clock::now();
-    while (itr != m_playersUnloadingChunks.end())
+    std::unique_lock<std::mutex> playersLock(m_playersMtx);
+    while (!m_playersUnloadingChunks.empty())
     {
-        ServerPlayer& player = m_players.at(*itr);
-        player.beginUnloadingChunksOutOfRange();
-        m_playersMtx.unlock();
-        while (player.checkIfNextChunkShouldUnload(&chunkPosition, &chunkOutOfRange))
+        uint32_t playerID = *m_playersUnloadingChunks.begin();
+        m_playersUnloadingChunks.erase(m_playersUnloadingChunks.begin());
+        auto playerIt = m_players.find(playerID);
+        if (playerIt == m_players.end())
+            continue;
+        playerIt->second.beginUnloadingChunksOutOfRange();
+
+        // Unsubscribe from the chunks in batches so that the chunk loader threads can carry on
+        // finding and adding chunks in between
+        bool chunksRemaining = true;
+        while (chunksRemaining)
         {
-            if (chunkOutOfRange)
             {
-                auto itr = chunkManager.getWorldChunks().find(chunkPosition);
-                itr->second.decrementPlayerCount();
-                if (itr->second.hasNoPlayers())
+                std::lock_guard<std::shared_mutex> lock1(chunkManager.mutex);
+                std::lock_guard<std::mutex> lock2(m_chunksBeingLoadedMtx);
+                IVec3 chunkPosition;
+                bool chunkOutOfRange;
+                for (int i = 0; i < UNLOAD_BATCH_SIZE && (chunksRemaining =
+                    playerIt->second.checkIfNextChunkShouldUnload(&chunkPosition, &chunkOutOfRange));
+                    i++)
                 {
-                    itr->second.unload();
-                    chunkManager.getWorldChunks().erase(itr);
+                    if (chunkOutOfRange)
+                        unsubscribeFromChunk(playerID, chunkPosition);
                 }
             }
+            playersLock.unlock();
+            playersLock.lock();
+            playerIt = m_players.find(playerID);
+            if (playerIt == m_players.end())
+                break;
         }
-        m_playersMtx.lock();
-        itr = m_playersUnloadingChunks.erase(itr);
     }
-    m_playersMtx.unlock();
+    playersLock.unlock();
+}
+
+// Must be called with chunkManager.mutex and m_chunksBeingLoadedMtx locked
+template<bool integrated>
+void ServerWorld<integrated>::unsubscribeFromChunk(uint32_t playerID, const IVec3& chunkPosition)
+{
+    // The subscribers of chunks that are still loading are kept with the load request until
+    // the chunk has been generated
+    auto beingLoaded = m_chunksBeingLoaded.find(chunkPosition);
+    if (beingLoaded != m_chunksBeingLoaded.end())
+    {
+        beingLoaded->second.subscribers &= ~(1u << playerID);
+        if (beingLoaded->second.subscribers == 0 && !beingLoaded->second.generating)
+            m_chunksBeingLoaded.erase(beingLoaded);
+        return;
+    }
+
+    auto it = chunkManager.getWorldChunks().find(chunkPosition);
+    if (it == chunkManager.getWorldChunks().end())
+        return;
+    it->second.removeSubscriber(playerID);
+    // Chunk loader threads only use chunks outside of the chunk map lock while generating
+    // them, and those are still in m_chunksBeingLoaded, so the chunk can be freed straight away
+    if (it->second.hasNoPlayers())
+    {
+        it->second.unload();
+        chunkManager.getWorldChunks().erase(it);
+    }
 }
 
 template<bool integrated>
 void ServerWorld<integrated>::findChunksToLoad() {
     std::lock_guard<std::mutex> lock1(m_playersMtx);
-    std::lock_guard<std::mutex> lock2(chunkManager.mutex);
+    std::lock_guard<std::shared_mutex> lock2(chunkManager.mutex);
     std::lock_guard<std::mutex> lock3(m_chunksBeingLoadedMtx);
     for (auto& [playerID, player] : m_players) {
         if (player.updateNextUnloadedChunk() && (player.wantsMoreChunks() || integrated)) {
-            int chunkPosition[3];
-            player.getNextChunkCoords(chunkPosition, m_gameTick);
-            auto it = chunkManager.getWorldChunks().find(IVec3(chunkPosition));
+            int chunkCoords[3];
+            player.getNextChunkCoords(chunkCoords, m_gameTick);
+            IVec3 chunkPosition(chunkCoords);
+            // Chunks that are still being generated are handed to their subscribers by
+            // loadNextChunk once they have finished
+            auto beingLoaded = m_chunksBeingLoaded.find(chunkPosition);
+            if (beingLoaded != m_chunksBeingLoaded.end()) {
+                beingLoaded->second.subscribers |= 1u << playerID;
+                continue;
+            }
+            auto it = chunkManager.getWorldChunks().find(chunkPosition);
             if (it != chunkManager.getWorldChunks().end()) {
-                it->second.incrementPlayerCount();
-                if (!integrated) {
-                    Packet<uint8_t, 9 * constants::CHUNK_SIZE * constants::CHUNK_SIZE
-                        * constants::CHUNK_SIZE> payload(0, PacketType::ChunkSent, 0);
-                    Compression::compressChunk(payload, it->second);
-                    payload.setPeerID(playerID);
-                    ENetPacket* packet = enet_packet_create((const void*)(&payload), payload.getSize(), ENET_PACKET_FLAG_RELIABLE);
-                    std::lock_guard<std::mutex> lock(m_networkingMtx);
-                    enet_peer_send(player.getPeer(), 0, packet);
-                }
+                it->second.addSubscriber(playerID);
+                if (!integrated)
+                    player.queueChunkToSend(chunkPosition);
             }
-            else if (!m_chunksBeingLoaded.contains(IVec3(chunkPosition))) {
-                m_chunksToBeLoaded.emplace(chunkPosition);
-                m_chunksBeingLoaded.emplace(chunkPosition);
+            else {
+                m_chunksToBeLoaded.push(chunkPosition);
+                m_chunksBeingLoaded[chunkPosition] = { 1u << playerID, false, Profiler::now() };
             }
         }
     }
@@ -218,9 +270,22 @@ bool ServerWorld<integrated>::loadNextChunk(IVec3* chunkPosition) {
     m_chunksToBeLoadedMtx.lock();
     if (m_chunksToBeLoaded.empty())
         findChunksToLoad();
-    if (!m_chunksToBeLoaded.empty()) {
+    bool chunkFound = false;
+    while (!chunkFound && !m_chunksToBeLoaded.empty()) {
         *chunkPosition = m_chunksToBeLoaded.front();
         m_chunksToBeLoaded.pop();
+        // Skip requests that every player has since moved away from, and duplicate requests
+        // for chunks that are already being generated
+        std::lock_guard<std::mutex> lock(m_chunksBeingLoadedMtx);
+        auto it = m_chunksBeingLoaded.find(*chunkPosition);
+        if (it != m_chunksBeingLoaded.end() && !it->second.generating) {
+            it->second.generating = true;
+            chunkFound = true;
+            ChunkPipelineStats::record(ChunkStage::Queue, it->second.queueTime, Profiler::now());
+        }
+    }
+    if (chunkFound) {
+        PROFILE_ZONE("Load chunk");
         m_chunksToBeLoadedMtx.unlock();
         chunkManager.mutex.lock();
         Chunk::s_checkingNeighbourSkyRelightsMtx.lock();
@@ -228,26 +293,33 @@ bool ServerWorld<integrated>::loadNextChunk(IVec3* chunkPosition) {
         Chunk::s_checkingNeighbourSkyRelightsMtx.unlock();
         Chunk& chunk = chunkManager.getChunk(*chunkPosition);
         chunkManager.mutex.unlock();
+        int64_t generateStart = Profiler::now();
         TerrainGen().generateTerrain(chunk, m_seed);
+        chunk.setLoadedTime(Profiler::now());
+        ChunkPipelineStats::record(ChunkStage::Generate, generateStart, chunk.getLoadedTime());
+        chunk.setSkyLightBeingRelit(false);
+        chunk.setBlockLightBeingRelit(false);
+        std::lock_guard<std::mutex> lock(m_playersMtx);
         m_chunksBeingLoadedMtx.lock();
-        m_chunksBeingLoaded.erase(*chunkPosition);
+        auto beingLoaded = m_chunksBeingLoaded.find(*chunkPosition);
+        uint32_t subscribers = beingLoaded->second.subscribers;
+        m_chunksBeingLoaded.erase(beingLoaded);
         m_chunksBeingLoadedMtx.unlock();
-        Packet<uint8_t, 9 * constants::CHUNK_SIZE * constants::CHUNK_SIZE
-            * constants::CHUNK_SIZE> payload(0, PacketType::ChunkSent, 0);
-        if (!integrated) {
-            Compression::compressChunk(payload, chunk);
+        chunk.setSubscribers(subscribers);
+        if (subscribers == 0) {
+            // Every player moved out of range of the chunk while it was being generated
+            std::lock_guard<std::shared_mutex> lock2(chunkManager.mutex);
+            chunk.unload();
+            chunkManager.getWorldChunks().erase(*chunkPosition);
+            return false;
         }
-        chunk.setSkyLightBeingRelit(false);
-        chunk.setBlockLightBeingRelit(false);
-        for (auto& [playerID, player] : m_players) {
-            if (player.hasChunkLoaded(*chunkPosition)) {
-                chunk.incrementPlayerCount();
-                if (!integrated) {
-                    payload.setPeerID(playerID);
-                    ENetPacket* packet = enet_packet_create((const void*)(&payload), payload.getSize(), ENET_PACKET_FLAG_RELIABLE);
-                    std::lock_guard<std::mutex> lock(m_networkingMtx);
-                    enet_peer_send(player.getPeer(), 0, packet);
-                }
+        if (!integrated) {
+            while (subscribers) {
+                uint32_t playerID = std::countr_zero(subscribers);
+                subscribers &= subscribers - 1;
+                auto playerIt = m_players.find(playerID);
+                if (playerIt != m_players.end())
+                    playerIt->second.queueChunkToSend(*chunkPosition);
             }
         }
         return true;
@@ -262,6 +334,7 @@ bool ServerWorld<integrated>::loadNextChunk(IVec3* chunkPosition) {
 template<bool integrated>
 void ServerWorld<integrated>::loadChunkFromPacket(Packet<uint8_t, 9 * constants::CHUNK_SIZE *
     constants::CHUNK_SIZE * constants::CHUNK_SIZE>& payload, IVec3& chunkPosition) {
+    PROFILE_ZONE("Load chunk from packet");
     Compression::getChunkPosition(payload, chunkPosition);
     chunkManager.mutex.lock();
     Chunk::s_checkingNeighbourSkyRelightsMtx.lock();
@@ -278,12 +351,16 @@ void ServerWorld<integrated>::loadChunkFromPacket(Packet<uint8_t, 9 * constants:
     Chunk::s_checkingNeighbourSkyRelightsMtx.unlock();
     Chunk& chunk = chunkManager.getChunk(chunkPosition);
     chunkManager.mutex.unlock();
+    int64_t decompressStart = Profiler::now();
     Compression::decompressChunk(payload, chunk);
+    chunk.setLoadedTime(Profiler::now());
+    ChunkPipelineStats::record(ChunkStage::Decompress, decompressStart, chunk.getLoadedTime());
     chunk.setSkyLightBeingRelit(false);
     chunk.setBlockLightBeingRelit(false);
     if (integrated)
     {
         std::lock_guard<std::mutex> lock(m_playersMtx);
+        chunk.addSubscriber(0);
         m_players.at(0).setChunkLoaded(chunkPosition, m_gameTick);
     }
 }
@@ -297,9 +374,16 @@ uint32_t ServerWorld<integrated>::addPlayer(
     uint32_t playerID = 0;
     while (m_players.contains(playerID))
         playerID++;
+    assert(playerID < constants::MAX_PLAYERS);
     m_players[playerID] = {
         playerID, blockPosition, subBlockPosition, renderDistance, peer, m_gameTick
     };
+    if (m_bytesSentCounters[playerID] == nullptr)
+    {
+        m_bytesSentCounters[playerID] = &MetricsRegistry::getCounter(
+            "bytes_sent", "player=\"" + std::to_string(playerID) + "\""
+        );
+    }
 
     return playerID;
 }
@@ -316,85 +400,131 @@ void ServerWorld<integrated>::addPlayer(
 template<bool integrated>
 void ServerWorld<integrated>::disconnectPlayer(uint32_t playerID) {
     LOG(std::to_string(chunkManager.getWorldChunks().size()));
-    pauseChunkLoaderThreads();
 
     std::lock_guard<std::mutex> lock1(m_playersMtx);
-    std::lock_guard<std::mutex> lock2(chunkManager.mutex);
-    std::lock_guard<std::mutex> lock3(m_chunksToBeLoadedMtx);
-    std::lock_guard<std::mutex> lock4(m_chunksBeingLoadedMtx);
+    std::lock_guard<std::shared_mutex> lock2(chunkManager.mutex);
+    std::lock_guard<std::mutex> lock3(m_chunksBeingLoadedMtx);
     ServerPlayer& player = m_players.at(playerID);
 
-    int blockPosition[3];
-    player.getChunkPosition(blockPosition);
-    blockPosition[0] += player.getRenderDistance() * 4 * constants::CHUNK_SIZE;
-    float subBlockPosition[3] = { 0.0f, 0.0f, 0.0f };
-    player.updatePlayerPos(blockPosition, subBlockPosition);
-
     IVec3 chunkPosition;
     bool chunkOutOfRange;
     int i = 0;
-    player.beginUnloadingChunksOutOfRange();
+    player.beginUnloadingAllChunks();
     while (player.checkIfNextChunkShouldUnload(&chunkPosition, &chunkOutOfRange))
     {
-        if (chunkManager.chunkLoaded(chunkPosition)) {
-            auto it = chunkManager.getWorldChunks().find(chunkPosition);
-            if (it != chunkManager.getWorldChunks().end()) {
-                it->second.decrementPlayerCount();
-                if (it->second.hasNoPlayers()) {
-                    it->second.unload();
-                    chunkManager.getWorldChunks().erase(it);
-                }
-            }
-        }
+        unsubscribeFromChunk(playerID, chunkPosition);
         i++;
     }
     LOG(std::to_string(i) + " chunks checked");
-    while (!m_chunksToBeLoaded.empty()) {
-        m_chunksToBeLoaded.pop();
-    }
-    m_chunksBeingLoaded.clear();
 
     m_players.erase(playerID);
-    releaseChunkLoaderThreads();
     LOG(std::to_string(playerID) + " disconnected");
     LOG(std::to_string(chunkManager.getWorldChunks().size()));
 }
 
 template<bool integrated>
-void ServerWorld<integrated>::waitIfRequired(uint8_t threadNum) {
-    while (m_threadsWait) {
-        while (m_threadsWait) {
-            m_threadWaiting[threadNum] = true;
-            std::this_thread::sleep_for(std::chrono::milliseconds(4));
-            m_threadWaiting[threadNum] = false;
-        }
+void ServerWorld<integrated>::sendQueuedChunks()
+{
+    static Counter& chunksSent = MetricsRegistry::getCounter("chunks_sent");
+    static Counter& uncompressedChunkBytes = MetricsRegistry::getCounter(
+        "chunk_bytes_uncompressed"
+    );
+    static Counter& compressedChunkBytes = MetricsRegistry::getCounter("chunk_bytes_compressed");
+    static Gauge& compressionRatio = MetricsRegistry::getGauge("chunk_compression_ratio");
+
+    Packet<uint8_t, 9 * constants::CHUNK_SIZE * constants::CHUNK_SIZE
+        * constants::CHUNK_SIZE> payload(0, PacketType::ChunkSent, 0);
+    std::unique_lock<std::mutex> playersLock(m_playersMtx);
+    std::vector<uint32_t> playerIDs;
+    playerIDs.reserve(m_players.size());
+    for (auto& [playerID, player] : m_players)
+    {
+        playerIDs.push_back(playerID);
+        std::lock_guard<std::mutex> lock(m_networkingMtx);
+        player.getChunkSendScheduler().update(player.getPeer());
     }
-}
 
-template<bool integrated>
-void ServerWorld<integrated>::pauseChunkLoaderThreads() {
-    // Wait for all the chunk loader threads to finish their jobs
-    m_threadsWait = true;
-    bool allThreadsWaiting = false;
-    while (!allThreadsWaiting) {
-        std::this_thread::sleep_for(std::chrono::microseconds(100));
-        for (int8_t threadNum = 0; threadNum < m_numChunkLoadingThreads; threadNum++) {
-            allThreadsWaiting |= !m_threadWaiting[threadNum];
+    // m_playersMtx is released while each chunk is compressed so that the chunk loader threads
+    // aren't held up, so the player has to be looked up again afterwards in case they left
+    for (uint32_t playerID : playerIDs)
+    {
+        while (true)
+        {
+            auto playerIt = m_players.find(playerID);
+            if (playerIt == m_players.end())
+                break;
+            ServerPlayer& player = playerIt->second;
+            IVec3 chunkPosition;
+            int64_t queueTime;
+            if (!player.getChunkSendScheduler().canSend()
+                || !player.getNextChunkToSend(&chunkPosition, &queueTime))
+            {
+                break;
+            }
+            // The chunk will have been unloaded for the player if they moved away from it
+            // while it was queued
+            if (!player.hasChunkLoaded(chunkPosition))
+                continue;
+            playersLock.unlock();
+
+            PROFILE_ZONE("Send chunk");
+            int64_t compressStart = Profiler::now();
+            ChunkPipelineStats::record(ChunkStage::SendQueue, queueTime, compressStart);
+            bool chunkFound;
+            {
+                std::shared_lock<std::shared_mutex> lock(chunkManager.mutex);
+                auto it = chunkManager.getWorldChunks().find(chunkPosition);
+                chunkFound = it != chunkManager.getWorldChunks().end();
+                if (chunkFound)
+                    Compression::compressChunk(payload, it->second);
+            }
+            playersLock.lock();
+            if (!chunkFound)
+                continue;
+            int64_t sendStart = Profiler::now();
+            ChunkPipelineStats::record(ChunkStage::Compress, compressStart, sendStart);
+
+            playerIt = m_players.find(playerID);
+            if (playerIt == m_players.end())
+                break;
+            if (!playerIt->second.hasChunkLoaded(chunkPosition))
+                continue;
+            payload.setPeerID(playerID);
+            ENetPacket* packet = enet_packet_create((const void*)(&payload), payload.getSize(), ENET_PACKET_FLAG_RELIABLE);
+            {
+                std::lock_guard<std::mutex> lock(m_networkingMtx);
+                if (enet_peer_send(playerIt->second.getPeer(), 0, packet) < 0)
+                {
+                    enet_packet_destroy(packet);
+                    continue;
+                }
+                // ENet can't free the packet until the networking mutex is released, so it is
+                // safe to start counting it towards the bytes in flight after sending it
+                playerIt->second.getChunkSendScheduler().trackPacket(packet);
+            }
+            ChunkPipelineStats::record(ChunkStage::Send, sendStart, Profiler::now());
+
+            chunksSent.add();
+            uncompressedChunkBytes.add(UNCOMPRESSED_CHUNK_SIZE);
+            compressedChunkBytes.add(payload.getSize());
+            compressionRatio.set(
+                static_cast<double>(uncompressedChunkBytes.get()) / compressedChunkBytes.get()
+            );
+            m_bytesSentCounters[playerID]->add(payload.getSize());
         }
-        allThreadsWaiting = !allThreadsWaiting;
     }
 }
 
-template<bool integrated>
-void ServerWorld<integrated>::releaseChunkLoaderThreads() {
-    m_threadsWait = false;
-}
-
 template<bool integrated>
 void ServerWorld<integrated>::tick() {
+    PROFILE_ZONE("Tick");
     m_timeOfLastTick = std::chrono::steady_clock::now();
     m_entityManager.tick();
 
+    // The integrated server's chunks are unloaded by the client once it has unmeshed them
+    if (!integrated)
+        unloadChunksOutOfRange();
+
     if (!integrated) {
         auto it = m_players.begin();
         while (it != m_players.end()) {
@@ -411,7 +541,7 @@ void ServerWorld<integrated>::tick() {
 template<bool integrated>
 bool ServerWorld<integrated>::isChunkLoaded(IVec3 chunkPosition)
 {
-    // std::lock_guard<std::mutex> lock1(chunkManager.mutex);
+    // std::lock_guard<std::shared_mutex> lock1(chunkManager.mutex);
     if (chunkManager.chunkLoaded(chunkPosition))
     {
         // std::lock_guard<std::mutex> lock2(m_chunksBeingLoadedMtx);
@@ -429,20 +559,37 @@ void ServerWorld<integrated>::broadcastBlockReplaced(int* blockCoords, int block
     }
     payload[3] = blockType;
     IVec3 chunkPosition = Chunk::getChunkCoords(blockCoords);
+    uint32_t subscribers;
+    {
+        std::shared_lock<std::shared_mutex> lock(chunkManager.mutex);
+        auto it = chunkManager.getWorldChunks().find(chunkPosition);
+        if (it == chunkManager.getWorldChunks().end())
+            return;
+        subscribers = it->second.getSubscribers() & ~(1u << originalPlayerID);
+    }
     std::lock_guard<std::mutex> lock(m_networkingMtx);
-    for (auto& [playerID, player] : m_players) {
-        if ((playerID != originalPlayerID) && (player.hasChunkLoaded(chunkPosition))) {
-            ENetPacket* packet = enet_packet_create((const void*)(&payload), payload.getSize(), ENET_PACKET_FLAG_RELIABLE);
-            enet_peer_send(player.getPeer(), 0, packet);
-        }
+    while (subscribers) {
+        uint32_t playerID = std::countr_zero(subscribers);
+        subscribers &= subscribers - 1;
+        ENetPacket* packet = enet_packet_create((const void*)(&payload), payload.getSize(), ENET_PACKET_FLAG_RELIABLE);
+        enet_peer_send(m_players.at(playerID).getPeer(), 0, packet);
+        if (!integrated)
+            m_bytesSentCounters[playerID]->add(payload.getSize());
     }
 }
 
+template<bool integrated>
+size_t ServerWorld<integrated>::getChunkLoadQueueLength()
+{
+    std::lock_guard<std::mutex> lock(m_chunksToBeLoadedMtx);
+    return m_chunksToBeLoaded.size();
+}
+
 template<bool integrated>
 float ServerWorld<integrated>::getTimeSinceLastTick()
 {
     auto currentTime = std::chrono::steady_clock::now();
-    return std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - m_timeOfLastTick).count() * 0.001f;
+    return std::chrono::duration<float>(currentTime - m_timeOfLastTick).count();
 }
 
 template<bool integrated>
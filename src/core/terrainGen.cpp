@@ -22,6 +22,7 @@
 
 #include "core/block.h"
 #include "core/constants.h"
+#include "core/profiler.h"
 #include "core/random.h"
 
 namespace lonelycube {
@@ -226,6 +227,7 @@ int TerrainGen::sumNoisesAndCalculateHeight(int minX, int minZ, int x, int z, in
 }
 
 void TerrainGen::generateTerrain(Chunk& chunk, uint64_t seed) {
+    PROFILE_ZONE("Generate terrain");
     chunk.setSkyLightToBeOutdated();
 
     //calculate coordinates of the chunk
@@ -0,0 +1,160 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+#include "core/utils/iVec3.h"
+#include <bit>
+
+namespace lonelycube {
+
+// A fixed size set of chunk positions indexed by the chunk coordinates modulo the diameter of
+// the grid, so any cube of chunks that is no wider than the grid maps onto distinct slots.
+// Each slot also stores which wrap of the grid its chunk is in, so a chunk left over from an
+// old player position is never mistaken for the chunk that now shares its slot.
+class ToroidalChunkGrid
+{
+private:
+    struct Slot
+    {
+        uint64_t tick;
+        int32_t wrap[3];
+    };
+
+    int m_diameter;
+    std::vector<uint64_t> m_occupied;
+    std::vector<Slot> m_slots;
+
+    inline static int floorDiv(int a, int b)
+    {
+        return a >= 0 ? a / b : (a + 1) / b - 1;
+    }
+
+    inline uint32_t getSlotIndex(const IVec3& chunkPosition, int32_t* wrap) const
+    {
+        uint32_t index = 0;
+        for (int i = 2; i >= 0; i--)
+        {
+            int quotient = floorDiv(chunkPosition[i], m_diameter);
+            wrap[i] = quotient;
+            index = index * m_diameter + chunkPosition[i] - quotient * m_diameter;
+        }
+        return index;
+    }
+
+    inline bool isOccupied(uint32_t index) const
+    {
+        return (m_occupied[index / 64] >> (index % 64)) & 1;
+    }
+
+    inline bool slotHoldsChunk(uint32_t index, const int32_t* wrap) const
+    {
+        const Slot& slot = m_slots[index];
+        return isOccupied(index) && slot.wrap[0] == wrap[0] && slot.wrap[1] == wrap[1]
+            && slot.wrap[2] == wrap[2];
+    }
+
+    inline IVec3 getChunkInSlot(uint32_t index) const
+    {
+        const Slot& slot = m_slots[index];
+        return {
+            static_cast<int>(index % m_diameter) + slot.wrap[0] * m_diameter,
+            static_cast<int>(index / m_diameter % m_diameter) + slot.wrap[1] * m_diameter,
+            static_cast<int>(index / (m_diameter * m_diameter)) + slot.wrap[2] * m_diameter
+        };
+    }
+
+public:
+    ToroidalChunkGrid() : m_diameter(1) {}
+    ToroidalChunkGrid(int diameter) : m_diameter(diameter),
+        m_occupied((diameter * diameter * diameter + 63) / 64, 0),
+        m_slots(diameter * diameter * diameter) {}
+
+    inline bool contains(const IVec3& chunkPosition) const
+    {
+        int32_t wrap[3];
+        return slotHoldsChunk(getSlotIndex(chunkPosition, wrap), wrap);
+    }
+
+    // Returns false if the chunk is not in the grid
+    inline bool getTick(const IVec3& chunkPosition, uint64_t* tick) const
+    {
+        int32_t wrap[3];
+        uint32_t index = getSlotIndex(chunkPosition, wrap);
+        if (!slotHoldsChunk(index, wrap))
+            return false;
+        *tick = m_slots[index].tick;
+        return true;
+    }
+
+    // Returns true if a different chunk had to be evicted from the slot to make room, in which
+    // case its position is written to evictedChunk
+    inline bool insert(const IVec3& chunkPosition, uint64_t tick, IVec3* evictedChunk)
+    {
+        int32_t wrap[3];
+        uint32_t index = getSlotIndex(chunkPosition, wrap);
+        bool evicted = isOccupied(index) && !slotHoldsChunk(index, wrap);
+        if (evicted)
+            *evictedChunk = getChunkInSlot(index);
+        m_occupied[index / 64] |= 1ull << (index % 64);
+        m_slots[index] = { tick, { wrap[0], wrap[1], wrap[2] } };
+        return evicted;
+    }
+
+    // Returns false if the chunk was not in the grid
+    inline bool erase(const IVec3& chunkPosition)
+    {
+        int32_t wrap[3];
+        uint32_t index = getSlotIndex(chunkPosition, wrap);
+        if (!slotHoldsChunk(index, wrap))
+            return false;
+        m_occupied[index / 64] &= ~(1ull << (index % 64));
+        return true;
+    }
+
+    // Calls the function with the position of every chunk in the grid, skipping empty words of
+    // the occupancy bitset
+    template<typename Function>
+    void forEachChunk(Function function) const
+    {
+        for (uint32_t word = 0; word < m_occupied.size(); word++)
+        {
+            uint64_t bits = m_occupied[word];
+            while (bits)
+            {
+                uint32_t index = word * 64 + std::countr_zero(bits);
+                function(getChunkInSlot(index));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    inline void clear()
+    {
+        std::fill(m_occupied.begin(), m_occupied.end(), 0);
+    }
+
+    inline int getDiameter() const
+    {
+        return m_diameter;
+    }
+};
+
+}  // namespace lonelycube
@@ -0,0 +1,60 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+namespace lonelycube {
+
+// A read-only view of a whole file mapped into memory, so that only the pages that are used are
+// read from disk
+class MappedFile
+{
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+#ifdef _WIN32
+    void* m_mapping;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Returns false if the file doesn't exist, is empty or couldn't be mapped
+    bool open(const std::filesystem::path& path);
+    void close();
+
+    inline bool isOpen() const
+    {
+        return m_data != nullptr;
+    }
+    inline const uint8_t* getData() const
+    {
+        return m_data;
+    }
+    inline size_t getSize() const
+    {
+        return m_size;
+    }
+};
+
+}  // namespace lonelycube
@@ -0,0 +1,108 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/workerPool.h"
+
+#include "core/pch.h"
+
+#include "core/profiler.h"
+
+namespace lonelycube {
+
+WorkerPool::WorkerPool(int numThreads) : m_function(nullptr), m_count(0), m_rangeSize(1),
+    m_nextRangeStart(0), m_numThreadsWorking(0), m_jobNum(0), m_running(true)
+{
+    // The thread calling parallelFor also does work, so it counts as one of the threads
+    for (int threadNum = 1; threadNum < numThreads; threadNum++)
+        m_threads.emplace_back(&WorkerPool::workerThread, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_running = false;
+    }
+    m_workAvailable.notify_all();
+    for (std::thread& thread : m_threads)
+        thread.join();
+}
+
+void WorkerPool::runRanges()
+{
+    size_t rangeStart;
+    while ((rangeStart = m_nextRangeStart.fetch_add(m_rangeSize)) < m_count)
+        (*m_function)(rangeStart, std::min(rangeStart + m_rangeSize, m_count));
+}
+
+void WorkerPool::workerThread()
+{
+    Profiler::setThreadName("Worker");
+    uint64_t lastJobNum = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mtx);
+            m_workAvailable.wait(lock, [&]() { return !m_running || m_jobNum != lastJobNum; });
+            if (!m_running)
+                return;
+            lastJobNum = m_jobNum;
+        }
+
+        runRanges();
+
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (--m_numThreadsWorking == 0)
+            m_workFinished.notify_one();
+    }
+}
+
+void WorkerPool::parallelFor(
+    size_t count, size_t minRangeSize, const std::function<void(size_t, size_t)>& function
+) {
+    // Split the work into a few ranges per thread so that threads which finish early can help
+    // with the rest
+    size_t maxNumRanges = getNumThreads() * 4;
+    size_t numRanges = std::min(maxNumRanges, (count + minRangeSize - 1) / minRangeSize);
+    if (numRanges <= 1 || m_threads.empty())
+    {
+        if (count > 0)
+            function(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> parallelForLock(m_parallelForMtx);
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_function = &function;
+        m_count = count;
+        m_rangeSize = (count + numRanges - 1) / numRanges;
+        m_nextRangeStart = 0;
+        m_numThreadsWorking = m_threads.size();
+        m_jobNum++;
+    }
+    m_workAvailable.notify_all();
+
+    runRanges();
+
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_workFinished.wait(lock, [&]() { return m_numThreadsWorking == 0; });
+    m_function = nullptr;
+}
+
+}  // namespace lonelycube
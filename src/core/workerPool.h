@@ -0,0 +1,65 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+#include <atomic>
+
+namespace lonelycube {
+
+// A fixed set of threads that sleep until parallelFor hands them a job. The range of indices
+// is split into chunks that the workers, and the thread that called parallelFor, take in turn
+// until there are none left.
+class WorkerPool
+{
+private:
+    std::vector<std::thread> m_threads;
+    std::mutex m_mtx;
+    std::condition_variable m_workAvailable;
+    std::condition_variable m_workFinished;
+    const std::function<void(size_t, size_t)>* m_function;
+    size_t m_count;
+    size_t m_rangeSize;
+    std::atomic<size_t> m_nextRangeStart;
+    int m_numThreadsWorking;
+    uint64_t m_jobNum;
+    bool m_running;
+    std::mutex m_parallelForMtx;
+
+    void workerThread();
+    void runRanges();
+
+public:
+    WorkerPool(int numThreads);
+    ~WorkerPool();
+    // Calls function(begin, end) for consecutive ranges that cover [0, count), with each range
+    // holding at least minRangeSize indices (other than the last), and returns once all of
+    // them have been processed
+    void parallelFor(
+        size_t count, size_t minRangeSize, const std::function<void(size_t, size_t)>& function
+    );
+
+    inline int getNumThreads() const
+    {
+        return m_threads.size() + 1;
+    }
+};
+
+}  // namespace lonelycube
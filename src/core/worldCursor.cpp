@@ -0,0 +1,73 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/worldCursor.h"
+
+#include "core/pch.h"
+
+namespace lonelycube {
+
+WorldCursor::WorldCursor(const std::unordered_map<IVec3, Chunk>& chunks)
+    : m_chunks(chunks), m_position{ 0, 0, 0 }, m_positionInChunk{ 0, 0, 0 }, m_blockNum(0),
+    m_chunk(nullptr), m_centreChunk{ 0, 0, 0 }, m_chunksFound(0) {}
+
+WorldCursor::WorldCursor(ChunkManager& chunkManager)
+    : WorldCursor(chunkManager.getWorldChunks()) {}
+
+void WorldCursor::moveTo(const IVec3& position)
+{
+    for (int axis = 0; axis < 3; axis++)
+        m_position[axis] = position[axis];
+    findChunk();
+}
+
+void WorldCursor::findChunk()
+{
+    int chunkPosition[3];
+    bool inCache = m_chunksFound != 0;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        chunkPosition[axis] = m_position[axis] >= 0 ? m_position[axis] / constants::CHUNK_SIZE :
+            (m_position[axis] + 1) / constants::CHUNK_SIZE - 1;
+        m_positionInChunk[axis] = m_position[axis] - chunkPosition[axis] * constants::CHUNK_SIZE;
+        inCache &= std::abs(chunkPosition[axis] - m_centreChunk[axis]) <= 1;
+    }
+    m_blockNum = m_positionInChunk[1] * constants::CHUNK_SIZE * constants::CHUNK_SIZE
+        + m_positionInChunk[2] * constants::CHUNK_SIZE + m_positionInChunk[0];
+
+    // Centre the cache on the new chunk once the cursor has moved out of it
+    if (!inCache)
+    {
+        for (int axis = 0; axis < 3; axis++)
+            m_centreChunk[axis] = chunkPosition[axis];
+        m_chunksFound = 0;
+    }
+
+    int cacheIndex = (chunkPosition[1] - m_centreChunk[1] + 1) * 9
+        + (chunkPosition[2] - m_centreChunk[2] + 1) * 3 + chunkPosition[0] - m_centreChunk[0] + 1;
+    if (!(m_chunksFound & (1u << cacheIndex)))
+    {
+        auto chunkIterator = m_chunks.find(IVec3(chunkPosition));
+        m_chunkCache[cacheIndex] = chunkIterator == m_chunks.end() ? nullptr
+            : &chunkIterator->second;
+        m_chunksFound |= 1u << cacheIndex;
+    }
+    m_chunk = m_chunkCache[cacheIndex];
+}
+
+}  // namespace lonelycube
@@ -0,0 +1,128 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+#include "core/chunk.h"
+#include "core/chunkManager.h"
+#include "core/constants.h"
+#include "core/utils/iVec3.h"
+
+namespace lonelycube {
+
+// Reads blocks and light from the world one position at a time, remembering the chunk that the
+// position is in and the chunks around it so that reading nearby blocks doesn't look each chunk
+// up in the hash map again. The cursor holds pointers into the chunk map, so it must only be
+// used while chunks can't be added or removed, such as while chunkManager.mutex is held, and
+// must not be kept after it is released. Unloaded chunks read as air with no light, like
+// ChunkManager::getBlock. The cursor doesn't point at anything until it is first moved to a
+// position with moveTo.
+class WorldCursor
+{
+private:
+    const std::unordered_map<IVec3, Chunk>& m_chunks;
+    int m_position[3];
+    int m_positionInChunk[3];
+    uint32_t m_blockNum;
+    const Chunk* m_chunk;
+    // The 3x3x3 chunks around m_centreChunk, which are looked up the first time they are needed.
+    // Bit n of m_chunksFound is set once m_chunkCache[n] has been looked up
+    int m_centreChunk[3];
+    std::array<const Chunk*, 27> m_chunkCache;
+    uint32_t m_chunksFound;
+
+    void findChunk();
+
+public:
+    WorldCursor(const std::unordered_map<IVec3, Chunk>& chunks);
+    WorldCursor(ChunkManager& chunkManager);
+
+    void moveTo(const IVec3& position);
+
+    // Moves the cursor by distance blocks along one axis, which only needs to find a new chunk
+    // if the cursor leaves the one it is in
+    inline void move(const int axis, const int distance)
+    {
+        static constexpr uint32_t strides[3] = {
+            1, constants::CHUNK_SIZE * constants::CHUNK_SIZE, constants::CHUNK_SIZE
+        };
+        m_position[axis] += distance;
+        m_positionInChunk[axis] += distance;
+        if (m_positionInChunk[axis] >= 0 && m_positionInChunk[axis] < constants::CHUNK_SIZE)
+            m_blockNum += distance * static_cast<int>(strides[axis]);
+        else
+            findChunk();
+    }
+
+    inline void move(const IVec3& offset)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (offset[axis] != 0)
+                move(axis, offset[axis]);
+        }
+    }
+
+    inline IVec3 getPosition() const
+    {
+        return IVec3(m_position);
+    }
+
+    inline bool chunkLoaded() const
+    {
+        return m_chunk != nullptr;
+    }
+
+    inline uint8_t getBlock() const
+    {
+        return m_chunk == nullptr ? 0 : m_chunk->getBlock(m_blockNum);
+    }
+
+    inline uint8_t getSkyLight() const
+    {
+        return m_chunk == nullptr ? 0 : m_chunk->getSkyLight(m_blockNum);
+    }
+
+    inline uint8_t getBlockLight() const
+    {
+        return m_chunk == nullptr ? 0 : m_chunk->getBlockLight(m_blockNum);
+    }
+
+    // Shorthands for moving the cursor to a position and reading it
+    inline uint8_t getBlock(const IVec3& position)
+    {
+        moveTo(position);
+        return getBlock();
+    }
+
+    inline uint8_t getSkyLight(const IVec3& position)
+    {
+        moveTo(position);
+        return getSkyLight();
+    }
+
+    inline uint8_t getBlockLight(const IVec3& position)
+    {
+        moveTo(position);
+        return getBlockLight();
+    }
+};
+
+}  // namespace lonelycube
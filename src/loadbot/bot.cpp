@@ -0,0 +1,348 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "loadbot/bot.h"
+
+#include "core/pch.h"
+
+#include "core/chunk.h"
+#include "core/compression.h"
+#include "core/log.h"
+#include "core/random.h"
+
+namespace lonelycube::loadbot {
+
+static constexpr float PI = 3.14159265f;
+static constexpr int EDIT_RANGE = 8;
+static constexpr std::chrono::seconds EDIT_LIFETIME{ 10 };
+
+void BlockEditTracker::editSent(const IVec3& blockPosition)
+{
+    auto currentTime = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(m_mtx);
+    // Edits that nobody else had loaded are never received, so forget old ones
+    if (m_editSendTimes.size() > 4096)
+    {
+        std::erase_if(m_editSendTimes, [&](const auto& edit) {
+            return currentTime - edit.second > EDIT_LIFETIME;
+        });
+    }
+    m_editSendTimes[blockPosition] = currentTime;
+}
+
+bool BlockEditTracker::editReceived(
+    const IVec3& blockPosition, std::chrono::microseconds* latency
+) {
+    auto currentTime = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(m_mtx);
+    auto it = m_editSendTimes.find(blockPosition);
+    if (it == m_editSendTimes.end())
+        return false;
+    *latency = std::chrono::duration_cast<std::chrono::microseconds>(currentTime - it->second);
+    return true;
+}
+
+Bot::Bot(
+    uint32_t botNum, uint32_t numBots, const BotSettings& settings, LoadBotStats& stats,
+    BlockEditTracker& editTracker
+) : m_botNum(botNum), m_settings(settings), m_stats(stats),
+    m_editTracker(editTracker), m_host(nullptr), m_peer(nullptr), m_clientID(-1),
+    m_randomState(PCG_Hash32(botNum)), m_tickNum(0), m_editsDue(0.0f),
+    m_chunkPacket(std::make_unique<Packet<uint8_t, 9 * constants::CHUNK_SIZE *
+        constants::CHUNK_SIZE * constants::CHUNK_SIZE>>()),
+    m_timeToFullRenderDistance(-1), m_roundTripTime(0)
+{
+    // Spread the bots out evenly so that straight line flights go in different directions
+    // and orbiting bots start at different points of the circle
+    m_heading = 2.0f * PI * botNum / numBots;
+    m_position[0] = 0.0;
+    m_position[1] = 0.0;
+    m_position[2] = 0.0;
+    if (m_settings.movementMode == MovementMode::Orbit)
+    {
+        m_position[0] = m_settings.orbitRadius * std::cos(m_heading);
+        m_position[2] = m_settings.orbitRadius * std::sin(m_heading);
+    }
+
+    int blockPosition[3];
+    float subBlockPosition[3];
+    for (int i = 0; i < 3; i++)
+    {
+        blockPosition[i] = std::floor(m_position[i]);
+        subBlockPosition[i] = m_position[i] - blockPosition[i];
+    }
+    m_player = ServerPlayer(
+        0, blockPosition, subBlockPosition, m_settings.renderDistance, true
+    );
+}
+
+Bot::~Bot()
+{
+    if (m_host != nullptr)
+        enet_host_destroy(m_host);
+}
+
+bool Bot::connect()
+{
+    m_host = enet_host_create(NULL, 1, 2, 0, 0);
+    if (m_host == NULL)
+        return false;
+
+    ENetAddress address;
+    enet_address_set_host(&address, m_settings.serverIP.c_str());
+    address.port = 5555;
+
+    m_peer = enet_host_connect(m_host, &address, 2, 0);
+    if (m_peer == NULL)
+        return false;
+
+    ENetEvent event;
+    if ((enet_host_service(m_host, &event, 5000) <= 0) || (event.type != ENET_EVENT_TYPE_CONNECT))
+    {
+        enet_peer_reset(m_peer);
+        m_peer = nullptr;
+        return false;
+    }
+
+    Packet<int, 1> payload(0, PacketType::ClientConnection, 1);
+    payload[0] = m_settings.renderDistance;
+    ENetPacket* packet = enet_packet_create(
+        (const void*)(&payload), payload.getSize(), ENET_PACKET_FLAG_RELIABLE
+    );
+    enet_peer_send(m_peer, 0, packet);
+    return true;
+}
+
+void Bot::disconnect()
+{
+    if (m_peer == nullptr)
+        return;
+
+    enet_peer_disconnect(m_peer, m_clientID);
+    ENetEvent event;
+    while (enet_host_service(m_host, &event, 3000) > 0)
+    {
+        if (event.type == ENET_EVENT_TYPE_RECEIVE)
+        {
+            enet_packet_destroy(event.packet);
+        }
+        else if (event.type == ENET_EVENT_TYPE_DISCONNECT)
+        {
+            m_peer = nullptr;
+            return;
+        }
+    }
+    enet_peer_reset(m_peer);
+    m_peer = nullptr;
+}
+
+float Bot::random()
+{
+    m_randomState = PCG_Hash32(m_randomState);
+    return (m_randomState >> 8) * (1.0f / (1 << 24));
+}
+
+void Bot::receivePacket(ENetPacket* packet)
+{
+    m_stats.bytesReceived += packet->dataLength;
+
+    Packet<int, 0> head;
+    memcpy(&head, packet->data, head.getSize());
+    switch (head.getPacketType())
+    {
+    case PacketType::ClientConnection:
+    {
+        Packet<uint16_t, 1> payload;
+        memcpy(&payload, packet->data, packet->dataLength);
+        m_clientID = payload[0];
+        m_connectTime = std::chrono::steady_clock::now();
+        LOG("Bot " + std::to_string(m_botNum) + " connected with clientID "
+            + std::to_string(m_clientID));
+    }
+    break;
+    case PacketType::ChunkSent:
+    {
+        // Decode the chunk so the bot costs the same to serve as a real client, but don't
+        // keep it, as nothing is ever rendered
+        memcpy(m_chunkPacket.get(), packet->data, packet->dataLength);
+        IVec3 chunkPosition;
+        Compression::getChunkPosition(*m_chunkPacket, chunkPosition);
+        Chunk chunk(chunkPosition);
+        Compression::decompressChunk(*m_chunkPacket, chunk);
+        chunk.unload();
+        m_player.setChunkLoaded(chunkPosition, m_tickNum);
+        m_stats.chunksReceived++;
+    }
+    break;
+    case PacketType::BlockReplaced:
+    {
+        Packet<int, 4> payload;
+        memcpy(&payload, packet->data, packet->dataLength);
+        IVec3 blockPosition(payload.getPayloadAddress());
+        std::chrono::microseconds latency;
+        if (m_editTracker.editReceived(blockPosition, &latency))
+        {
+            uint64_t latencyMicroseconds = latency.count();
+            m_stats.blockEditsReceived++;
+            m_stats.totalEditLatency += latencyMicroseconds;
+            uint64_t maxLatency = m_stats.maxEditLatency;
+            while (latencyMicroseconds > maxLatency
+                && !m_stats.maxEditLatency.compare_exchange_weak(maxLatency, latencyMicroseconds));
+        }
+    }
+    break;
+
+    default:
+        break;
+    }
+    enet_packet_destroy(packet);
+}
+
+void Bot::move()
+{
+    float distance = m_settings.speed / constants::TICKS_PER_SECOND;
+    switch (m_settings.movementMode)
+    {
+    case MovementMode::RandomWalk:
+        // Pick a new direction every couple of seconds
+        if (m_tickNum % (2 * constants::TICKS_PER_SECOND) == 0)
+            m_heading = random() * 2.0f * PI;
+        [[fallthrough]];
+    case MovementMode::StraightLine:
+        m_position[0] += distance * std::cos(m_heading);
+        m_position[2] += distance * std::sin(m_heading);
+        break;
+    case MovementMode::Orbit:
+        m_heading += distance / m_settings.orbitRadius;
+        m_position[0] = m_settings.orbitRadius * std::cos(m_heading);
+        m_position[2] = m_settings.orbitRadius * std::sin(m_heading);
+        break;
+    }
+}
+
+void Bot::sendPosition()
+{
+    Packet<int64_t, 6> payload(m_clientID, PacketType::ClientPosition, 6);
+    for (int i = 0; i < 3; i++)
+        payload[i] = std::floor(m_position[i]);
+    // Also send the request for the chunks that the server should send
+    m_player.updateChunkLoadingTarget();
+    payload[3] = m_player.incrementNumChunkRequests();
+    payload[4] = m_player.getChunkLoadingTarget();
+    payload[5] = m_player.getTargetBufferSize();
+    ENetPacket* packet = enet_packet_create((const void*)(&payload), payload.getSize(), 0);
+    enet_peer_send(m_peer, 1, packet);
+}
+
+void Bot::sendBlockEdit()
+{
+    IVec3 blockPosition;
+    for (int i = 0; i < 3; i++)
+    {
+        blockPosition[i] = std::floor(m_position[i])
+            + static_cast<int>(random() * (2 * EDIT_RANGE + 1)) - EDIT_RANGE;
+    }
+    // Only edit blocks the bot can see, like a real player would
+    if (!m_player.hasChunkLoaded(Chunk::getChunkCoords(blockPosition)))
+        return;
+
+    Packet<int, 4> payload(m_clientID, PacketType::BlockReplaced, 4);
+    for (int i = 0; i < 3; i++)
+        payload[i] = blockPosition[i];
+    payload[3] = random() < 0.5f ? 0 : 3;  // Air or stone
+    m_editTracker.editSent(blockPosition);
+    ENetPacket* packet = enet_packet_create(
+        (const void*)(&payload), payload.getSize(), ENET_PACKET_FLAG_RELIABLE
+    );
+    enet_peer_send(m_peer, 0, packet);
+    m_stats.blockEditsSent++;
+}
+
+void Bot::tick()
+{
+    m_tickNum++;
+
+    IVec3 oldChunkPosition = m_player.getChunkPosition();
+    move();
+    IVec3 blockPosition;
+    Vec3 subBlockPosition;
+    for (int i = 0; i < 3; i++)
+    {
+        blockPosition[i] = std::floor(m_position[i]);
+        subBlockPosition[i] = m_position[i] - blockPosition[i];
+    }
+    m_player.updatePlayerPos(blockPosition, subBlockPosition);
+    if (m_player.getChunkPosition() != oldChunkPosition)
+    {
+        m_player.beginUnloadingChunksOutOfRange();
+        IVec3 chunkPosition;
+        bool chunkOutOfRange;
+        while (m_player.checkIfNextChunkShouldUnload(&chunkPosition, &chunkOutOfRange));
+    }
+
+    if (m_timeToFullRenderDistance < 0 && !m_player.updateNextUnloadedChunk())
+    {
+        m_timeToFullRenderDistance = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - m_connectTime
+        ).count();
+    }
+
+    sendPosition();
+
+    m_editsDue += m_settings.editsPerSecond / constants::TICKS_PER_SECOND;
+    while (m_editsDue >= 1.0f)
+    {
+        sendBlockEdit();
+        m_editsDue -= 1.0f;
+    }
+
+    m_roundTripTime = m_peer->roundTripTime;
+}
+
+void Bot::run(const std::atomic<bool>& running)
+{
+    auto nextTick = std::chrono::steady_clock::now() +
+        std::chrono::nanoseconds(1000000000 / constants::TICKS_PER_SECOND);
+    while (running)
+    {
+        ENetEvent event;
+        if (enet_host_service(m_host, &event, 1) > 0)
+        {
+            if (event.type == ENET_EVENT_TYPE_RECEIVE)
+            {
+                receivePacket(event.packet);
+            }
+            else if (event.type == ENET_EVENT_TYPE_DISCONNECT)
+            {
+                LOG("Bot " + std::to_string(m_botNum) + " was disconnected by the server");
+                m_peer = nullptr;
+                m_clientID = -1;
+                return;
+            }
+        }
+
+        if (std::chrono::steady_clock::now() >= nextTick)
+        {
+            if (isConnected())
+                tick();
+            nextTick += std::chrono::nanoseconds(1000000000 / constants::TICKS_PER_SECOND);
+        }
+    }
+}
+
+}  // namespace lonelycube::loadbot
@@ -0,0 +1,131 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "enet/enet.h"
+
+#include "core/pch.h"
+
+#include "core/constants.h"
+#include "core/packet.h"
+#include "core/serverPlayer.h"
+#include "core/utils/iVec3.h"
+
+#include <atomic>
+
+namespace lonelycube::loadbot {
+
+enum class MovementMode
+{
+    RandomWalk, StraightLine, Orbit
+};
+
+struct BotSettings
+{
+    std::string serverIP;
+    int renderDistance;
+    MovementMode movementMode;
+    float speed;  // blocks per second
+    float orbitRadius;
+    float editsPerSecond;
+};
+
+// Counters shared by all of the bots, read by the main thread to print the report
+struct LoadBotStats
+{
+    std::atomic<uint64_t> chunksReceived{ 0 };
+    std::atomic<uint64_t> bytesReceived{ 0 };
+    std::atomic<uint64_t> blockEditsSent{ 0 };
+    std::atomic<uint64_t> blockEditsReceived{ 0 };
+    std::atomic<uint64_t> totalEditLatency{ 0 };  // microseconds
+    std::atomic<uint64_t> maxEditLatency{ 0 };  // microseconds
+};
+
+// Remembers when each block edit was sent so that the bots that receive the server's
+// broadcast of it can measure how long the server took to relay it
+class BlockEditTracker
+{
+private:
+    std::mutex m_mtx;
+    std::unordered_map<IVec3, std::chrono::steady_clock::time_point> m_editSendTimes;
+
+public:
+    void editSent(const IVec3& blockPosition);
+    // Returns false if the edit was not sent by one of the bots
+    bool editReceived(const IVec3& blockPosition, std::chrono::microseconds* latency);
+};
+
+// A simulated player that speaks the same protocol as the multiplayer client, without
+// rendering or meshing anything. Received chunks are decompressed and thrown away, and the
+// bot uses its own ServerPlayer to work out which chunks to ask the server for, just like
+// the client's integrated server does.
+class Bot
+{
+private:
+    uint32_t m_botNum;
+    const BotSettings& m_settings;
+    LoadBotStats& m_stats;
+    BlockEditTracker& m_editTracker;
+    ENetHost* m_host;
+    ENetPeer* m_peer;
+    std::atomic<int> m_clientID;
+    ServerPlayer m_player;
+    double m_position[3];
+    float m_heading;
+    uint32_t m_randomState;
+    uint64_t m_tickNum;
+    float m_editsDue;
+    std::unique_ptr<Packet<uint8_t, 9 * constants::CHUNK_SIZE * constants::CHUNK_SIZE *
+        constants::CHUNK_SIZE>> m_chunkPacket;
+    std::chrono::steady_clock::time_point m_connectTime;
+    std::atomic<int64_t> m_timeToFullRenderDistance;  // milliseconds, -1 until reached
+    std::atomic<uint32_t> m_roundTripTime;
+
+    float random();
+    void receivePacket(ENetPacket* packet);
+    void move();
+    void sendPosition();
+    void sendBlockEdit();
+    void tick();
+
+public:
+    Bot(
+        uint32_t botNum, uint32_t numBots, const BotSettings& settings, LoadBotStats& stats,
+        BlockEditTracker& editTracker
+    );
+    ~Bot();
+    bool connect();
+    void run(const std::atomic<bool>& running);
+    void disconnect();
+
+    inline bool isConnected() const
+    {
+        return m_clientID >= 0;
+    }
+    inline int64_t getTimeToFullRenderDistance() const
+    {
+        return m_timeToFullRenderDistance;
+    }
+    inline uint32_t getRoundTripTime() const
+    {
+        return m_roundTripTime;
+    }
+};
+
+}  // namespace lonelycube::loadbot
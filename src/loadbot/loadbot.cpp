@@ -0,0 +1,219 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/pch.h"
+
+#include <enet/enet.h>
+#include <iomanip>
+
+#include "loadbot/bot.h"
+
+using namespace lonelycube;
+
+using namespace lonelycube::loadbot;
+
+static void printUsage()
+{
+    std::cout << "Usage: loadbot [options]\n"
+        << "  --bots <n>               Number of simulated players (default 8)\n"
+        << "  --server <ip>            Address of the server (default 127.0.0.1)\n"
+        << "  --render-distance <n>    Render distance of each bot in chunks (default 8)\n"
+        << "  --duration <seconds>     How long to run for (default 60)\n"
+        << "  --mode <mode>            random, straight or orbit (default random)\n"
+        << "  --speed <blocks/s>       Movement speed (default 10)\n"
+        << "  --orbit-radius <blocks>  Radius of the orbit mode's circle (default 256)\n"
+        << "  --edits <edits/s>        Block edits per second per bot (default 1)\n";
+}
+
+static bool parseArguments(
+    int argc, char** argv, BotSettings& settings, int& numBots, int& duration
+) {
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if (argument == "--help")
+            return false;
+        if (i + 1 >= argc)
+        {
+            std::cout << "Missing value for " << argument << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        try
+        {
+            if (argument == "--bots")
+                numBots = std::stoi(value);
+            else if (argument == "--server")
+                settings.serverIP = value;
+            else if (argument == "--render-distance")
+                settings.renderDistance = std::stoi(value);
+            else if (argument == "--duration")
+                duration = std::stoi(value);
+            else if (argument == "--speed")
+                settings.speed = std::stof(value);
+            else if (argument == "--orbit-radius")
+                settings.orbitRadius = std::stof(value);
+            else if (argument == "--edits")
+                settings.editsPerSecond = std::stof(value);
+            else if (argument == "--mode")
+            {
+                if (value == "random")
+                    settings.movementMode = MovementMode::RandomWalk;
+                else if (value == "straight")
+                    settings.movementMode = MovementMode::StraightLine;
+                else if (value == "orbit")
+                    settings.movementMode = MovementMode::Orbit;
+                else
+                {
+                    std::cout << "Unknown movement mode " << value << "\n";
+                    return false;
+                }
+            }
+            else
+            {
+                std::cout << "Unknown option " << argument << "\n";
+                return false;
+            }
+        }
+        catch (const std::exception&)
+        {
+            std::cout << "Invalid value " << value << " for " << argument << "\n";
+            return false;
+        }
+    }
+
+    if (numBots < 1 || numBots > static_cast<int>(constants::MAX_PLAYERS))
+    {
+        std::cout << "The number of bots must be between 1 and " << constants::MAX_PLAYERS
+            << "\n";
+        return false;
+    }
+    if (settings.renderDistance < 1 || settings.orbitRadius <= 0.0f)
+    {
+        std::cout << "The render distance and orbit radius must be positive\n";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    BotSettings settings{ "127.0.0.1", 8, MovementMode::RandomWalk, 10.0f, 256.0f, 1.0f };
+    int numBots = 8;
+    int duration = 60;
+    if (!parseArguments(argc, argv, settings, numBots, duration))
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (enet_initialize() != 0)
+    {
+        std::cout << "Failed to initialise ENet\n";
+        return 1;
+    }
+
+    LoadBotStats stats;
+    BlockEditTracker editTracker;
+    std::vector<std::unique_ptr<Bot>> bots;
+    for (int botNum = 0; botNum < numBots; botNum++)
+    {
+        bots.push_back(std::make_unique<Bot>(botNum, numBots, settings, stats, editTracker));
+        if (!bots.back()->connect())
+        {
+            std::cout << "Bot " << botNum << " failed to connect to " << settings.serverIP
+                << "\n";
+            bots.pop_back();
+            break;
+        }
+    }
+    if (bots.empty())
+    {
+        enet_deinitialize();
+        return 1;
+    }
+
+    std::atomic<bool> running = true;
+    std::vector<std::thread> botThreads;
+    for (auto& bot : bots)
+        botThreads.emplace_back(&Bot::run, bot.get(), std::cref(running));
+
+    // Print a line of statistics every second
+    auto startTime = std::chrono::steady_clock::now();
+    uint64_t lastChunksReceived = 0;
+    uint64_t lastBytesReceived = 0;
+    std::cout << std::fixed << std::setprecision(1);
+    for (int second = 1; second <= duration; second++)
+    {
+        std::this_thread::sleep_until(startTime + std::chrono::seconds(second));
+
+        int numConnected = 0;
+        int numFullyLoaded = 0;
+        uint64_t totalRoundTripTime = 0;
+        for (auto& bot : bots)
+        {
+            numConnected += bot->isConnected();
+            numFullyLoaded += bot->getTimeToFullRenderDistance() >= 0;
+            totalRoundTripTime += bot->getRoundTripTime();
+        }
+        uint64_t chunksReceived = stats.chunksReceived;
+        uint64_t bytesReceived = stats.bytesReceived;
+        uint64_t editsReceived = stats.blockEditsReceived;
+        std::cout << "t=" << second << "s"
+            << " bots=" << numConnected << "/" << bots.size()
+            << " full=" << numFullyLoaded << "/" << bots.size()
+            << " chunks/s=" << chunksReceived - lastChunksReceived
+            << " MB/s=" << (bytesReceived - lastBytesReceived) / 1048576.0
+            << " rtt=" << totalRoundTripTime / bots.size() << "ms"
+            << " edit_latency_avg="
+            << (editsReceived ? stats.totalEditLatency / 1000.0 / editsReceived : 0.0) << "ms"
+            << " edit_latency_max=" << stats.maxEditLatency / 1000.0 << "ms\n";
+        lastChunksReceived = chunksReceived;
+        lastBytesReceived = bytesReceived;
+    }
+
+    running = false;
+    for (auto& thread : botThreads)
+        thread.join();
+    for (auto& bot : bots)
+        bot->disconnect();
+
+    double elapsedTime = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime
+    ).count();
+    std::cout << "Summary over " << elapsedTime << "s with " << bots.size() << " bots:\n"
+        << "  chunks received: " << stats.chunksReceived << " ("
+        << stats.chunksReceived / elapsedTime << "/s)\n"
+        << "  bytes received: " << stats.bytesReceived << " ("
+        << stats.bytesReceived / elapsedTime / 1048576.0 << " MB/s)\n"
+        << "  block edits sent: " << stats.blockEditsSent << ", broadcasts received: "
+        << stats.blockEditsReceived << "\n";
+    for (uint32_t botNum = 0; botNum < bots.size(); botNum++)
+    {
+        int64_t timeToFullRenderDistance = bots[botNum]->getTimeToFullRenderDistance();
+        std::cout << "  bot " << botNum << " time to full render distance: ";
+        if (timeToFullRenderDistance >= 0)
+            std::cout << timeToFullRenderDistance << "ms\n";
+        else
+            std::cout << "not reached\n";
+    }
+
+    bots.clear();
+    enet_deinitialize();
+    return 0;
+}
@@ -21,8 +21,11 @@
 #include <enet/enet.h>
 
 #include "core/chunk.h"
+#include "core/chunkPipelineStats.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/packet.h"
+#include "core/profiler.h"
 #include "core/serverWorld.h"
 #include "server/serverNetworking.h"
 #include "core/resourceMonitor.h"
@@ -38,12 +41,27 @@ static void receiveCommands(bool* running) {
         if (command == "quit") {
             *running = false;
         }
+        else if (command == "profile") {
+            std::string tracePath = "trace_" + std::to_string(std::time(nullptr)) + ".json";
+            if (Profiler::writeChromeTrace(tracePath))
+                std::cout << "Wrote profiler trace to " << tracePath << "\n";
+            else
+                std::cout << "Failed to write profiler trace to " << tracePath << "\n";
+        }
+        else if (command == "stats") {
+            std::cout << "Metrics:\n";
+            for (const std::string& line : MetricsRegistry::getSummary())
+                std::cout << "  " << line << "\n";
+            std::cout << "Chunk pipeline latencies:\n";
+            for (const std::string& line : ChunkPipelineStats::getSummary())
+                std::cout << "  " << line << "\n";
+        }
     }
 }
 
 static void chunkLoaderThread(ServerWorld<false>* mainWorld, bool* running, int8_t threadNum) {
+    Profiler::setThreadName("Chunk loader " + std::to_string(threadNum));
     while (*running) {
-        mainWorld->waitIfRequired(threadNum);
         IVec3 chunkPosition;
         if (mainWorld->loadNextChunk(&chunkPosition)) {
 
@@ -51,7 +69,48 @@ static void chunkLoaderThread(ServerWorld<false>* mainWorld, bool* running, int8
     }
 }
 
+static void updateWorldMetrics(ServerWorld<false>& mainWorld) {
+    static Gauge& chunkLoadQueueLength = MetricsRegistry::getGauge("chunk_load_queue_length");
+    static Gauge& chunksLoaded = MetricsRegistry::getGauge("chunks_loaded");
+    static Gauge& players = MetricsRegistry::getGauge("players");
+
+    chunkLoadQueueLength.set(mainWorld.getChunkLoadQueueLength());
+    {
+        std::shared_lock<std::shared_mutex> lock(mainWorld.chunkManager.mutex);
+        chunksLoaded.set(mainWorld.chunkManager.getWorldChunks().size());
+    }
+    players.set(mainWorld.getPlayers().size());
+}
+
+static void writeMetrics(const std::string& path) {
+    bool written;
+    if (path.ends_with(".csv"))
+        written = MetricsRegistry::appendCsv(path);
+    else
+        written = MetricsRegistry::writeOpenMetrics(path);
+    if (!written)
+        std::cout << "Failed to write metrics to " << path << "\n";
+}
+
 int main (int argc, char** argv) {
+    Profiler::setThreadName("Main");
+
+    // Metrics are appended to a CSV file, or otherwise written in the OpenMetrics text format,
+    // every interval if a file is given
+    std::string metricsPath;
+    int metricsInterval = 10;
+    for (int i = 1; i < argc; i += 2) {
+        std::string argument = argv[i];
+        if (argument != "--metrics-file" && argument != "--metrics-interval")
+            std::cout << "Unknown option " << argument << "\n";
+        else if (i + 1 == argc)
+            std::cout << "Missing value for option " << argument << "\n";
+        else if (argument == "--metrics-file")
+            metricsPath = argv[i + 1];
+        else
+            metricsInterval = std::max(1, std::atoi(argv[i + 1]));
+    }
+
     ENetEvent event;
     ENetAddress address;
     ServerNetworking networking;
@@ -77,15 +136,26 @@ int main (int argc, char** argv) {
 
     // Gameloop
     std::thread(receiveCommands, &running).detach();
+    LatencyHistogram& tickDuration = MetricsRegistry::getHistogram("tick_duration");
     auto nextTick = std::chrono::steady_clock::now() + std::chrono::nanoseconds(1000000000 / constants::TICKS_PER_SECOND);
+    auto nextMetricsWrite = std::chrono::steady_clock::now()
+        + std::chrono::seconds(metricsInterval);
     while(running) {
         auto currentTime = std::chrono::steady_clock::now();
         if (currentTime >= nextTick) {
+            int64_t tickStart = Profiler::now();
             mainWorld.tick();
+            tickDuration.record(Profiler::now() - tickStart);
+            updateWorldMetrics(mainWorld);
             nextTick += std::chrono::nanoseconds(1000000000 / constants::TICKS_PER_SECOND);
         }
+        if (!metricsPath.empty() && currentTime >= nextMetricsWrite) {
+            writeMetrics(metricsPath);
+            nextMetricsWrite += std::chrono::seconds(metricsInterval);
+        }
 
         networking.receiveEvents(mainWorld);
+        mainWorld.sendQueuedChunks();
     }
 
     chunkLoaderThreadsRunning[0] = false;
@@ -25,6 +25,7 @@
 
 #include "core/log.h"
 #include "core/packet.h"
+#include "core/profiler.h"
 #include "core/serverWorld.h"
 
 namespace lonelycube::server {
@@ -43,10 +44,8 @@ bool ServerNetworking::initServer(ENetAddress& address) {
     // Bind the server to port 5555
     address.port = 5555;
 
-    const int MAX_PLAYERS = 32;
-
     m_host = enet_host_create (&address,    // the address to bind the server host to
-                    MAX_PLAYERS,  // allow up to 32 clients and/or outgoing connections
+                    constants::MAX_PLAYERS,  // allow up to 32 clients and/or outgoing connections
                     2,  // allow up to 2 channels to be used, 0 and 1
                     0,  // assume any amount of incoming bandwidth
                     0); // assume any amount of outgoing bandwidth
@@ -60,6 +59,7 @@ bool ServerNetworking::initServer(ENetAddress& address) {
 }
 
 void ServerNetworking::receivePacket(ENetPacket* packet, ENetPeer* peer, ServerWorld<false>& mainWorld) {
+    PROFILE_ZONE("Receive packet");
     Packet<int, 0> head;
     memcpy(&head, packet->data, head.getSize());
     switch (head.getPacketType()) {
@@ -101,17 +101,10 @@ void ServerNetworking::receivePacket(ENetPacket* packet, ENetPeer* peer, ServerW
             };
             IVec3 newPlayerChunkCoords = Chunk::getChunkCoords(newPlayerPos);
             bool unloadNeeded = newPlayerChunkCoords != oldPlayerChunkCoords;
-            if (unloadNeeded) {
-                mainWorld.pauseChunkLoaderThreads();
-            }
 
             float subBlockPosition[3] = { 0.0f, 0.0f, 0.0f };
             mainWorld.updatePlayerPos(playerID, newPlayerPos, subBlockPosition, unloadNeeded);
             mainWorld.setPlayerChunkLoadingTarget(playerID, payload[3], payload[4], payload[5]);
-
-            if (unloadNeeded) {
-                mainWorld.releaseChunkLoaderThreads();
-            }
         }
     }
     break;
@@ -19,6 +19,7 @@
 #include "core/entities/ECS.h"
 #include "core/entities/ECSView.h"
 #include "core/utils/iVec3.h"
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
 using namespace lonelycube;
@@ -170,3 +171,107 @@ TEST_CASE("Components can be constructed in place using any available constructo
     REQUIRE( ecs.get<Name>(entity2).name == "Lonely Cube" );
     REQUIRE( ecs.get<Name>(entity3).name == "Lonely Cube" );
 }
+
+TEST_CASE( "Components can be removed and entities destroyed while iterating over them", "[ECS]" )
+{
+    ECS ecs(1000);
+    std::vector<EntityId> entities;
+    for (int i = 0; i < 600; i++)
+    {
+        EntityId entity = ecs.newEntity();
+        ecs.assign<int>(entity, i);
+        if (i % 2 == 0)
+            ecs.assign<std::string>(entity, "Entity " + std::to_string(i));
+        entities.push_back(entity);
+    }
+
+    SECTION( "Removing a component keeps the other components of that type intact" )
+    {
+        for (int i = 0; i < 600; i += 3)
+            ecs.remove<int>(entities[i]);
+
+        int count = 0;
+        for (EntityId entity : ECSView<int>(ecs))
+        {
+            REQUIRE( ecs.getEntityIndex(entity) % 3 != 0 );
+            REQUIRE( ecs.get<int>(entity) == static_cast<int>(ecs.getEntityIndex(entity)) );
+            count++;
+        }
+        REQUIRE( count == 400 );
+        REQUIRE( ecs.entityHasComponent<int>(entities[3]) == false );
+        REQUIRE( ecs.entityHasComponent<std::string>(entities[6]) == true );
+        REQUIRE( ecs.get<std::string>(entities[6]) == "Entity 6" );
+    }
+    SECTION( "Entities can be destroyed while iterating over a view" )
+    {
+        int visited = 0;
+        for (EntityId entity : ECSView<int>(ecs))
+        {
+            if (ecs.get<int>(entity) % 4 != 1)
+                ecs.destroyEntity(entity);
+            visited++;
+        }
+        REQUIRE( visited == 600 );
+
+        int count = 0;
+        for (EntityId entity : ECSView<int>(ecs))
+        {
+            REQUIRE( ecs.get<int>(entity) % 4 == 1 );
+            count++;
+        }
+        REQUIRE( count == 150 );
+        REQUIRE( ECSView<std::string>(ecs).begin() == ECSView<std::string>(ecs).end() );
+    }
+    SECTION( "A view over a component that no entity has ever had is empty" )
+    {
+        REQUIRE( ECSView<int, float>(ecs).begin() == ECSView<int, float>(ecs).end() );
+    }
+}
+
+TEST_CASE( "Iterating over ECSViews", "[.][benchmark]" )
+{
+    struct Position
+    {
+        float x, y, z;
+    };
+    struct Velocity
+    {
+        float x, y, z;
+    };
+    struct Rare
+    {
+        int value;
+    };
+
+    ECS ecs(10000);
+    for (int i = 0; i < 10000; i++)
+    {
+        EntityId entity = ecs.newEntity();
+        ecs.assign<Position>(entity, 0.0f, 0.0f, 0.0f);
+        if (i % 2 == 0)
+            ecs.assign<Velocity>(entity, 1.0f, 2.0f, 3.0f);
+        if (i % 200 == 0)
+            ecs.assign<Rare>(entity, i);
+    }
+
+    BENCHMARK( "10000 entities, 5000 with both components" )
+    {
+        for (EntityId entity : ECSView<Position, Velocity>(ecs))
+        {
+            Position& position = ecs.get<Position>(entity);
+            const Velocity& velocity = ecs.get<Velocity>(entity);
+            position.x += velocity.x;
+            position.y += velocity.y;
+            position.z += velocity.z;
+        }
+        return ecs.get<Position>(ecs.getEntityId(0)).x;
+    };
+
+    BENCHMARK( "10000 entities, 50 with the rare component" )
+    {
+        int sum = 0;
+        for (EntityId entity : ECSView<Position, Rare>(ecs))
+            sum += ecs.get<Rare>(entity).value;
+        return sum;
+    };
+}
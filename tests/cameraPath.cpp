@@ -0,0 +1,71 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "client/cameraPath.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace lonelycube::client;
+
+TEST_CASE("Camera paths pass through their keyframes", "[CameraPath]")
+{
+    CameraPath path(42, 8);
+    path.addKeyframe({ 0.0, { 0.0, 100.0, 0.0 }, 0.0f, 0.0f });
+    path.addKeyframe({ 1.0, { 10.0, 100.0, 0.0 }, 90.0f, -10.0f });
+    path.addKeyframe({ 3.0, { 10.0, 120.0, 10.0 }, 180.0f, 10.0f });
+    REQUIRE(path.getDuration() == 3.0);
+
+    CameraKeyframe keyframe = path.sample(1.0);
+    REQUIRE(keyframe.position[0] == Catch::Approx(10.0));
+    REQUIRE(keyframe.yaw == Catch::Approx(90.0f));
+    REQUIRE(keyframe.pitch == Catch::Approx(-10.0f));
+
+    // Between keyframes the camera stays between them
+    keyframe = path.sample(2.0);
+    REQUIRE(keyframe.position[1] > 100.0);
+    REQUIRE(keyframe.position[1] < 120.0);
+    REQUIRE(keyframe.yaw > 90.0f);
+    REQUIRE(keyframe.yaw < 180.0f);
+
+    // Times outside of the path are clamped to its ends
+    REQUIRE(path.sample(-1.0).position[0] == 0.0);
+    REQUIRE(path.sample(5.0).position[2] == 10.0);
+}
+
+TEST_CASE("Camera paths can be saved and loaded", "[CameraPath]")
+{
+    std::string filePath = (std::filesystem::temp_directory_path() / "lonelyCubePath.txt").string();
+    CameraPath path(1234567, 12);
+    path.addKeyframe({ 0.0, { -5.5, 80.25, 3.0 }, 45.0f, -20.0f });
+    path.addKeyframe({ 0.5, { -4.5, 80.25, 3.0 }, 50.0f, -20.0f });
+    REQUIRE(path.save(filePath));
+
+    CameraPath loadedPath;
+    REQUIRE(loadedPath.load(filePath));
+    std::filesystem::remove(filePath);
+    REQUIRE(loadedPath.getSeed() == 1234567);
+    REQUIRE(loadedPath.getRenderDistance() == 12);
+    REQUIRE(loadedPath.getNumKeyframes() == 2);
+    CameraKeyframe keyframe = loadedPath.sample(0.0);
+    REQUIRE(keyframe.position[0] == -5.5);
+    REQUIRE(keyframe.position[1] == 80.25);
+    REQUIRE(keyframe.yaw == 45.0f);
+
+    REQUIRE_FALSE(loadedPath.load("nonexistentPath.txt"));
+}
@@ -0,0 +1,114 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/entities/entityManager.h"
+
+#include "core/chunkManager.h"
+#include "core/entities/ECS.h"
+#include "core/entities/ECSView.h"
+#include "core/entities/components/itemComponent.h"
+#include "core/entities/components/meshComponent.h"
+#include "core/entities/components/physicsComponent.h"
+#include "core/entities/components/transformComponent.h"
+#include "core/resourcePack.h"
+#include "testResourcePack.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace lonelycube;
+
+namespace {
+
+constexpr uint8_t DIRT = 1;
+
+// Items start at rest, unlike the ones EntityManager::addItem throws, so they all fall the same
+// distance in a tick and stay the same distance apart
+struct TestWorld
+{
+    std::filesystem::path resourcePackPath;
+    ResourcePack resourcePack;
+    ChunkManager chunkManager;
+    EntityManager entityManager;
+
+    TestWorld() : resourcePackPath(createResourcePack("lonelycubeEntityManagerTest")),
+        resourcePack(resourcePackPath), entityManager(100, chunkManager, resourcePack) {}
+
+    ~TestWorld()
+    {
+        std::filesystem::remove_all(resourcePackPath.parent_path());
+    }
+
+    EntityId addItem(const IVec3& blockCoords, const Vec3& subBlockCoords, int count)
+    {
+        ECS& ecs = entityManager.getECS();
+        EntityId entity = ecs.newEntity();
+        ecs.assign<TransformComponent>(
+            entity, blockCoords, subBlockCoords, 0.25f, Vec3(0.0f, 0.0f, 0.0f)
+        );
+        ecs.assign<PhysicsComponent>(entity, Vec3(0.0f, 0.0f, 0.0f), Vec3(0.0f, 0.0f, 0.0f));
+        const BlockData& blockData = resourcePack.getBlockData(DIRT);
+        ecs.assign<MeshComponent>(entity, DIRT, blockData.model, &blockData.faceTextureIndices[0]);
+        ecs.assign<ItemComponent>(entity, DIRT, 1000).count = count;
+        entityManager.getPhysicsEngine().addEntity(entity);
+        return entity;
+    }
+
+    std::vector<int> getStackSizes()
+    {
+        ECS& ecs = entityManager.getECS();
+        std::vector<int> stackSizes;
+        for (EntityId entity : ECSView<ItemComponent>(ecs))
+            stackSizes.push_back(ecs.get<ItemComponent>(entity).count);
+        std::sort(stackSizes.begin(), stackSizes.end());
+        return stackSizes;
+    }
+};
+
+}  // namespace
+
+TEST_CASE("Nearby item stacks merge", "[EntityManager]")
+{
+    TestWorld world;
+    world.addItem(IVec3(2, 10, 3), Vec3(0.3f, 0.5f, 0.5f), 3);
+    world.addItem(IVec3(2, 10, 3), Vec3(0.6f, 0.6f, 0.4f), 5);
+    world.entityManager.tick();
+    REQUIRE(world.getStackSizes() == std::vector<int>{ 8 });
+}
+
+TEST_CASE("Item stacks that are too far apart or too big don't merge", "[EntityManager]")
+{
+    TestWorld world;
+    world.addItem(IVec3(2, 10, 3), Vec3(0.1f, 0.5f, 0.5f), 3);
+    world.addItem(IVec3(2, 10, 3), Vec3(0.7f, 0.5f, 0.5f), 5);
+    // Close enough along x and z, but not along y
+    world.addItem(IVec3(2, 11, 3), Vec3(0.1f, 0.2f, 0.5f), 7);
+    world.addItem(IVec3(-8, 10, 3), Vec3(0.5f, 0.5f, 0.5f), 40);
+    world.addItem(IVec3(-8, 10, 3), Vec3(0.6f, 0.5f, 0.5f), 30);
+    world.entityManager.tick();
+    REQUIRE(world.getStackSizes() == std::vector<int>{ 3, 5, 7, 30, 40 });
+}
+
+TEST_CASE("Item stacks in neighbouring cells of the spatial hash merge", "[EntityManager]")
+{
+    TestWorld world;
+    world.addItem(IVec3(4, 10, 3), Vec3(0.9f, 0.5f, 0.5f), 1);
+    world.addItem(IVec3(5, 10, 3), Vec3(0.2f, 0.5f, 0.5f), 2);
+    world.addItem(IVec3(-1, 10, -1), Vec3(0.9f, 0.5f, 0.8f), 4);
+    world.addItem(IVec3(0, 10, 0), Vec3(0.1f, 0.5f, 0.1f), 8);
+    world.entityManager.tick();
+    REQUIRE(world.getStackSizes() == std::vector<int>{ 3, 12 });
+}
@@ -0,0 +1,230 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/hitboxCollision.h"
+#include "core/utils/iVec3.h"
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace lonelycube;
+
+namespace {
+
+constexpr uint8_t AIR = 0;
+constexpr uint8_t STONE = 3;
+constexpr uint8_t WATER = 4;
+
+const Vec3 PLAYER_SIZE(0.6f, 1.8f, 0.6f);
+
+struct TestWorld
+{
+    std::unordered_map<IVec3, uint8_t> blocks;
+    int numLookups = 0;
+
+    HitboxContacts move(
+        IVec3& minBlock, Vec3& minOffset, Vec3& velocity, float DT, bool wasTouchingWater = false
+    ) {
+        auto getBlock = [&](const IVec3& position) {
+            numLookups++;
+            auto it = blocks.find(position);
+            return it == blocks.end() ? AIR : it->second;
+        };
+        auto isCollidable = [](uint8_t blockType) { return blockType == STONE; };
+        return moveHitbox(
+            minBlock, minOffset, PLAYER_SIZE, velocity, DT, wasTouchingWater, 0.9f, getBlock,
+            isCollidable
+        );
+    }
+
+    void fill(const IVec3& min, const IVec3& max, uint8_t blockType)
+    {
+        for (int x = min.x; x <= max.x; x++)
+        {
+            for (int y = min.y; y <= max.y; y++)
+            {
+                for (int z = min.z; z <= max.z; z++)
+                    blocks[IVec3(x, y, z)] = blockType;
+            }
+        }
+    }
+};
+
+}  // namespace
+
+TEST_CASE( "A falling hitbox lands flush on the ground", "[hitboxCollision]" ) {
+    TestWorld world;
+    world.fill({ -2, 0, -2 }, { 2, 0, 2 }, STONE);
+    IVec3 minBlock(0, 2, 0);
+    Vec3 minOffset(0.2f, 0.5f, 0.2f);
+    Vec3 velocity(0.0f, -10.0f, 0.0f);
+
+    HitboxContacts contacts = world.move(minBlock, minOffset, velocity, 1.0f);
+    REQUIRE( contacts.touchingGround );
+    REQUIRE( velocity.y == 0.0f );
+    REQUIRE( minBlock.y + minOffset.y == Catch::Approx(1.0f) );
+
+    // Standing still on the ground keeps touching it without sinking into it
+    velocity.y = -0.1f;
+    contacts = world.move(minBlock, minOffset, velocity, 1.0f / 60.0f);
+    REQUIRE( contacts.touchingGround );
+    REQUIRE( minBlock.y + minOffset.y == Catch::Approx(1.0f) );
+}
+
+TEST_CASE( "A fast hitbox doesn't pass through a thin floor", "[hitboxCollision]" ) {
+    TestWorld world;
+    world.fill({ -1, -50, -1 }, { 1, -50, 1 }, STONE);
+    IVec3 minBlock(0, 50, 0);
+    Vec3 minOffset(0.2f, 0.0f, 0.2f);
+    Vec3 velocity(0.0f, -100000.0f, 0.0f);
+
+    HitboxContacts contacts = world.move(minBlock, minOffset, velocity, 1.0f);
+    REQUIRE( contacts.touchingGround );
+    REQUIRE( minBlock.y + minOffset.y == Catch::Approx(-49.0f) );
+}
+
+TEST_CASE( "Hitting a ceiling stops upwards movement", "[hitboxCollision]" ) {
+    TestWorld world;
+    world.fill({ 0, 3, 0 }, { 0, 3, 0 }, STONE);
+    IVec3 minBlock(0, 0, 0);
+    Vec3 minOffset(0.2f, 0.0f, 0.2f);
+    Vec3 velocity(0.0f, 8.0f, 0.0f);
+
+    HitboxContacts contacts = world.move(minBlock, minOffset, velocity, 1.0f);
+    REQUIRE( !contacts.touchingGround );
+    REQUIRE( velocity.y == 0.0f );
+    REQUIRE( minBlock.y + minOffset.y + PLAYER_SIZE.y == Catch::Approx(3.0f) );
+}
+
+TEST_CASE( "A hitbox slides along a wall it moves diagonally into", "[hitboxCollision]" ) {
+    TestWorld world;
+    world.fill({ 1, 0, -5 }, { 1, 2, 5 }, STONE);
+    IVec3 minBlock(0, 0, 0);
+    Vec3 minOffset(0.2f, 0.0f, 0.2f);
+    Vec3 velocity(2.0f, 0.0f, 2.0f);
+
+    world.move(minBlock, minOffset, velocity, 1.0f);
+    REQUIRE( velocity.x == 0.0f );
+    REQUIRE( velocity.z == 2.0f );
+    REQUIRE( minBlock.x + minOffset.x + PLAYER_SIZE.x == Catch::Approx(1.0f) );
+    REQUIRE( minBlock.z + minOffset.z == Catch::Approx(2.2f) );
+}
+
+TEST_CASE( "A hitbox is stopped by a block it only catches with its corner", "[hitboxCollision]" ) {
+    TestWorld world;
+    world.fill({ 1, 0, 1 }, { 1, 0, 1 }, STONE);
+    IVec3 minBlock(0, 0, 0);
+    Vec3 minOffset(0.2f, 0.0f, 0.2f);
+    Vec3 velocity(0.5f, 0.0f, 0.5f);
+
+    // x is resolved first and is clear, which leaves the corner over the block on the z axis
+    world.move(minBlock, minOffset, velocity, 1.0f);
+    REQUIRE( velocity.x == 0.5f );
+    REQUIRE( velocity.z == 0.0f );
+    REQUIRE( minBlock.x + minOffset.x == Catch::Approx(0.7f) );
+    REQUIRE( minBlock.z + minOffset.z + PLAYER_SIZE.z == Catch::Approx(1.0f) );
+
+    // Moving past the block's corner without overlapping it isn't blocked
+    minBlock = IVec3(0, 0, 0);
+    minOffset = Vec3(0.2f, 0.0f, 0.4f);
+    velocity = Vec3(0.0f, 0.0f, 3.0f);
+    world.move(minBlock, minOffset, velocity, 1.0f);
+    REQUIRE( velocity.z == 3.0f );
+}
+
+TEST_CASE( "A hitbox flush against a wall can move away from it", "[hitboxCollision]" ) {
+    TestWorld world;
+    world.fill({ -1, 0, -5 }, { -1, 2, 5 }, STONE);
+    IVec3 minBlock(0, 0, 0);
+    Vec3 minOffset(0.0f, 0.0f, 0.2f);
+    Vec3 velocity(-1.0f, 0.0f, 0.0f);
+
+    world.move(minBlock, minOffset, velocity, 1.0f);
+    REQUIRE( velocity.x == 0.0f );
+    REQUIRE( minBlock.x + minOffset.x == Catch::Approx(0.0f) );
+
+    velocity = Vec3(1.0f, 0.0f, 0.0f);
+    world.move(minBlock, minOffset, velocity, 0.5f);
+    REQUIRE( velocity.x == 1.0f );
+    REQUIRE( minBlock.x + minOffset.x == Catch::Approx(0.5f) );
+}
+
+TEST_CASE( "A hitbox can't move further into a block placed inside it", "[hitboxCollision]" ) {
+    TestWorld world;
+    world.fill({ 0, 0, 0 }, { 0, 0, 0 }, STONE);
+    IVec3 minBlock(0, 0, 0);
+    Vec3 minOffset(0.7f, 0.5f, 0.2f);
+    Vec3 velocity(-1.0f, -1.0f, 0.0f);
+
+    // The block holds up the hitbox and the left face is in it, so neither axis can move
+    HitboxContacts contacts = world.move(minBlock, minOffset, velocity, 0.25f);
+    REQUIRE( contacts.touchingGround );
+    REQUIRE( velocity.x == 0.0f );
+    REQUIRE( velocity.y == 0.0f );
+    REQUIRE( minBlock.x + minOffset.x == Catch::Approx(0.7f) );
+    REQUIRE( minBlock.y + minOffset.y == Catch::Approx(0.5f) );
+
+    // Moving away from the block on either axis isn't blocked
+    velocity = Vec3(1.0f, 1.0f, 0.0f);
+    contacts = world.move(minBlock, minOffset, velocity, 0.25f);
+    REQUIRE( !contacts.touchingGround );
+    REQUIRE( velocity.x == 1.0f );
+    REQUIRE( velocity.y == 1.0f );
+    REQUIRE( minBlock.x + minOffset.x == Catch::Approx(0.95f) );
+    REQUIRE( minBlock.y + minOffset.y == Catch::Approx(0.75f) );
+}
+
+TEST_CASE( "Collisions work at negative coordinates", "[hitboxCollision]" ) {
+    TestWorld world;
+    world.fill({ -11, -21, -11 }, { -9, -21, -9 }, STONE);
+    IVec3 minBlock(-10, -19, -10);
+    Vec3 minOffset(0.2f, 0.3f, 0.2f);
+    Vec3 velocity(0.0f, -5.0f, 0.0f);
+
+    HitboxContacts contacts = world.move(minBlock, minOffset, velocity, 1.0f);
+    REQUIRE( contacts.touchingGround );
+    REQUIRE( minBlock.y + minOffset.y == Catch::Approx(-20.0f) );
+    REQUIRE( minOffset.y >= 0.0f );
+    REQUIRE( minOffset.y < 1.0f );
+}
+
+TEST_CASE( "Water is only entered once it is deep enough", "[hitboxCollision]" ) {
+    TestWorld world;
+    world.fill({ -2, 0, -2 }, { 2, 0, 2 }, WATER);
+    IVec3 minBlock(0, 0, 0);
+    Vec3 minOffset(0.2f, 0.5f, 0.2f);
+    Vec3 velocity(0.0f, 0.0f, 0.0f);
+
+    // The water only reaches the player's feet
+    REQUIRE( !world.move(minBlock, minOffset, velocity, 1.0f, false).touchingWater );
+    REQUIRE( world.move(minBlock, minOffset, velocity, 1.0f, true).touchingWater );
+
+    minOffset.y = 0.0f;
+    minBlock.y = 0;
+    REQUIRE( world.move(minBlock, minOffset, velocity, 1.0f, false).touchingWater );
+}
+
+TEST_CASE( "Only the blocks the hitbox crosses are looked up", "[hitboxCollision]" ) {
+    TestWorld world;
+    IVec3 minBlock(0, 0, 0);
+    Vec3 minOffset(0.2f, 0.0f, 0.2f);
+    Vec3 velocity(0.0f, -10.0f, 0.0f);
+
+    world.move(minBlock, minOffset, velocity, 0.05f);
+    // The layers of 1x1 blocks the feet are in and below them, plus the blocks checked for water
+    REQUIRE( world.numLookups <= 2 + 2 );
+}
@@ -0,0 +1,66 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/latencyHistogram.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace lonelycube;
+
+TEST_CASE("Percentiles are within the histogram's precision", "[LatencyHistogram]")
+{
+    LatencyHistogram histogram;
+    REQUIRE(histogram.getPercentile(50.0) == 0);
+
+    // 1µs to 1000µs in steps of 1µs
+    for (int64_t value = 1000; value <= 1000000; value += 1000)
+        histogram.record(value);
+
+    REQUIRE(histogram.getCount() == 1000);
+    REQUIRE(histogram.getMax() == 1000000);
+    auto withinPrecision = [](int64_t value, int64_t expected) {
+        return value >= expected && value <= expected + expected / 16;
+    };
+    REQUIRE(withinPrecision(histogram.getPercentile(50.0), 500000));
+    REQUIRE(withinPrecision(histogram.getPercentile(99.0), 990000));
+    REQUIRE(histogram.getPercentile(100.0) == 1000000);
+}
+
+TEST_CASE("Small durations are counted exactly", "[LatencyHistogram]")
+{
+    LatencyHistogram histogram;
+    for (int64_t value = 0; value < 32; value++)
+        histogram.record(value);
+
+    REQUIRE(histogram.getPercentile(50.0) == 15);
+    REQUIRE(histogram.getPercentile(100.0) == 31);
+
+    histogram.reset();
+    REQUIRE(histogram.getCount() == 0);
+    REQUIRE(histogram.getPercentile(50.0) == 0);
+}
+
+TEST_CASE("Durations longer than the histogram's range are kept", "[LatencyHistogram]")
+{
+    LatencyHistogram histogram;
+    histogram.record(-5);
+    histogram.record(int64_t(1) << 50);
+
+    REQUIRE(histogram.getPercentile(50.0) == 0);
+    REQUIRE(histogram.getPercentile(100.0) == int64_t(1) << 50);
+}
@@ -0,0 +1,89 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/metrics.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace lonelycube;
+
+static std::string readFile(const std::string& path)
+{
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+TEST_CASE("Metrics with the same name and labels are shared", "[Metrics]")
+{
+    Counter& counter = MetricsRegistry::getCounter("test_shared", "player=\"1\"");
+    counter.add(3);
+    MetricsRegistry::getCounter("test_shared", "player=\"1\"").add(2);
+    MetricsRegistry::getCounter("test_shared", "player=\"2\"").add();
+
+    REQUIRE(counter.get() == 5);
+    REQUIRE(MetricsRegistry::getCounter("test_shared", "player=\"2\"").get() == 1);
+    REQUIRE(&MetricsRegistry::getGauge("test_gauge") == &MetricsRegistry::getGauge("test_gauge"));
+}
+
+TEST_CASE("Metrics are written in the OpenMetrics text format", "[Metrics]")
+{
+    MetricsRegistry::getCounter("test_openmetrics_counter", "player=\"0\"").add(7);
+    MetricsRegistry::getCounter("test_openmetrics_counter", "player=\"1\"").add(8);
+    MetricsRegistry::getGauge("test_openmetrics_gauge").set(2.5);
+    MetricsRegistry::getHistogram("test_openmetrics_duration").record(1000000);
+
+    std::string path = (std::filesystem::temp_directory_path() / "lonelyCubeMetrics.txt").string();
+    REQUIRE(MetricsRegistry::writeOpenMetrics(path));
+    std::string contents = readFile(path);
+    std::filesystem::remove(path);
+
+    REQUIRE(contents.find("# TYPE test_openmetrics_counter counter\n"
+        "test_openmetrics_counter_total{player=\"0\"} 7\n"
+        "test_openmetrics_counter_total{player=\"1\"} 8\n") != std::string::npos);
+    REQUIRE(contents.find("# TYPE test_openmetrics_gauge gauge\ntest_openmetrics_gauge 2.5\n")
+        != std::string::npos);
+    REQUIRE(contents.find("# TYPE test_openmetrics_duration summary\n") != std::string::npos);
+    REQUIRE(contents.find("test_openmetrics_duration{quantile=\"0.99\"} 0.001")
+        != std::string::npos);
+    REQUIRE(contents.find("test_openmetrics_duration_count 1\n") != std::string::npos);
+    REQUIRE(contents.ends_with("# EOF\n"));
+}
+
+TEST_CASE("Metrics are appended to CSV files", "[Metrics]")
+{
+    MetricsRegistry::getCounter("test_csv", "player=\"0\"").add(4);
+
+    std::string path = (std::filesystem::temp_directory_path() / "lonelyCubeMetrics.csv").string();
+    std::filesystem::remove(path);
+    REQUIRE(MetricsRegistry::appendCsv(path));
+    REQUIRE(MetricsRegistry::appendCsv(path));
+    std::string contents = readFile(path);
+    std::filesystem::remove(path);
+
+    REQUIRE(contents.starts_with("timestamp,metric,value\n"));
+    REQUIRE(contents.find("timestamp", 1) == std::string::npos);
+    std::string row = ",\"test_csv{player=\"\"0\"\"}\",4\n";
+    size_t firstRow = contents.find(row);
+    REQUIRE(firstRow != std::string::npos);
+    REQUIRE(contents.find(row, firstRow + 1) != std::string::npos);
+}
@@ -0,0 +1,100 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "core/entities/physicsBodies.h"
+
+#include "core/entities/ECS.h"
+#include "core/entities/components/physicsComponent.h"
+#include "core/entities/components/transformComponent.h"
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace lonelycube;
+
+namespace {
+
+EntityId addEntity(
+    ECS& ecs, PhysicsBodies& bodies, const IVec3& blockCoords, const Vec3& velocity,
+    const Vec3& angularVelocity
+) {
+    EntityId entity = ecs.newEntity();
+    ecs.assign<TransformComponent>(
+        entity, blockCoords, Vec3(0.5f, 0.5f, 0.5f), 1.0f, Vec3(0.0f, 0.0f, 0.0f)
+    );
+    ecs.assign<PhysicsComponent>(entity, velocity, angularVelocity);
+    bodies.add(entity, ecs.get<PhysicsComponent>(entity), ecs.get<TransformComponent>(entity));
+    return entity;
+}
+
+}  // namespace
+
+TEST_CASE("Bodies fall, slow down and spin", "[PhysicsBodies]")
+{
+    ECS ecs(1000);
+    PhysicsBodies bodies;
+    EntityId entity = addEntity(
+        ecs, bodies, IVec3(0, 0, 0), Vec3(1.0f, 0.0f, -2.0f), Vec3(2.0f, 1.0f, 4.0f)
+    );
+    REQUIRE(bodies.contains(entity));
+
+    const float DT = 0.5f;
+    bodies.storePreviousTransforms();
+    bodies.integrate(DT);
+
+    PhysicsComponent& physics = ecs.get<PhysicsComponent>(entity);
+    TransformComponent& transform = ecs.get<TransformComponent>(entity);
+    bodies.remove(entity, physics, transform);
+    REQUIRE(!bodies.contains(entity));
+    REQUIRE(physics.velocity.x == Catch::Approx(0.98f));
+    REQUIRE(physics.velocity.y == Catch::Approx(-20.0f * DT * 0.98f));
+    REQUIRE(physics.velocity.z == Catch::Approx(-2.0f * 0.98f));
+    REQUIRE(transform.rotation.x == Catch::Approx(1.0f));
+    REQUIRE(transform.rotation.y == Catch::Approx(0.5f));
+    REQUIRE(transform.rotation.z == Catch::Approx(2.0f));
+    REQUIRE(transform.previousRotation == Vec3(0.0f, 0.0f, 0.0f));
+}
+
+TEST_CASE("Removing a body keeps the others attached to their entities", "[PhysicsBodies]")
+{
+    ECS ecs(1000);
+    PhysicsBodies bodies;
+    std::vector<EntityId> entities;
+    for (int i = 0; i < 10; i++)
+    {
+        entities.push_back(addEntity(
+            ecs, bodies, IVec3(i, 0, 0), Vec3(0.0f, 0.0f, 0.0f), Vec3(0.0f, 0.0f, 0.0f)
+        ));
+    }
+
+    bodies.remove(
+        entities[3], ecs.get<PhysicsComponent>(entities[3]),
+        ecs.get<TransformComponent>(entities[3])
+    );
+    REQUIRE(bodies.size() == 9);
+    REQUIRE(!bodies.contains(entities[3]));
+    for (int i = 0; i < 10; i++)
+    {
+        if (i == 3)
+            continue;
+        REQUIRE(bodies.contains(entities[i]));
+        TransformComponent transform = ecs.get<TransformComponent>(entities[i]);
+        bodies.getTransform(bodies.getBody(entities[i]), transform);
+        REQUIRE(transform.blockCoords == IVec3(i, 0, 0));
+    }
+}
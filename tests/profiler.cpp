@@ -0,0 +1,90 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/profiler.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace lonelycube;
+
+namespace {
+
+std::string writeTrace()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "lonelyCubeTrace.json").string();
+    REQUIRE(Profiler::writeChromeTrace(path));
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    file.close();
+    std::filesystem::remove(path);
+    return contents.str();
+}
+
+size_t countOccurrences(const std::string& string, const std::string& substring)
+{
+    size_t count = 0;
+    for (size_t pos = string.find(substring); pos != std::string::npos;
+        pos = string.find(substring, pos + 1))
+        count++;
+    return count;
+}
+
+}  // namespace
+
+TEST_CASE("Zones on every thread are written to the trace", "[Profiler]")
+{
+    // Give this thread its buffer first, otherwise it would reuse the one the other thread
+    // released, replacing its zones
+    {
+        PROFILE_ZONE("Test \"quoted\" zone");
+    }
+    std::thread thread([]() {
+        Profiler::setThreadName("Profiler test thread");
+        for (int i = 0; i < 3; i++)
+        {
+            PROFILE_ZONE("Test thread zone");
+        }
+    });
+    thread.join();
+
+    std::string trace = writeTrace();
+    REQUIRE(trace.starts_with("{\"traceEvents\":["));
+    REQUIRE(countOccurrences(trace, "\"name\":\"Profiler test thread\"") == 1);
+    REQUIRE(countOccurrences(trace, "\"name\":\"Test thread zone\",\"ph\":\"X\"") == 3);
+    REQUIRE(countOccurrences(trace, "\"name\":\"Test \\\"quoted\\\" zone\"") == 1);
+}
+
+TEST_CASE("Only the most recent zones of a thread are kept", "[Profiler]")
+{
+    std::thread thread([]() {
+        Profiler::setThreadName("Profiler overflow thread");
+        for (int i = 0; i < 100000; i++)
+            Profiler::recordZone("Old zone", 0, 1);
+        for (int i = 0; i < 20000; i++)
+            Profiler::recordZone("New zone", 1, 2);
+    });
+    thread.join();
+
+    std::string trace = writeTrace();
+    REQUIRE(countOccurrences(trace, "\"name\":\"Old zone\"") == 0);
+    REQUIRE(countOccurrences(trace, "\"name\":\"New zone\"") > 0);
+}
@@ -0,0 +1,147 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/raycast.h"
+#include "core/utils/iVec3.h"
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace lonelycube;
+
+namespace {
+
+constexpr uint8_t AIR = 0;
+constexpr uint8_t STONE = 3;
+constexpr uint8_t SLAB = 5;
+
+struct TestWorld
+{
+    std::unordered_map<IVec3, uint8_t> blocks;
+    std::vector<IVec3> visited;
+    int unloadedBelowY = -1000;
+
+    bool raycast(
+        const IVec3& startBlock, const Vec3& startSubBlock, const Vec3& direction,
+        float maxDistance, RaycastHit* hit
+    ) {
+        auto getBlock = [&](const IVec3& position, uint8_t& blockType) {
+            visited.push_back(position);
+            if (position.y < unloadedBelowY)
+                return false;
+            auto it = blocks.find(position);
+            blockType = it == blocks.end() ? AIR : it->second;
+            return true;
+        };
+        auto getBlockBounds = [](uint8_t blockType, Vec3& min, Vec3& max) {
+            if (blockType == AIR)
+                return false;
+            min = Vec3(0.0f);
+            max = blockType == SLAB ? Vec3(1.0f, 0.5f, 1.0f) : Vec3(1.0f);
+            return true;
+        };
+        return raycastBlocks(
+            startBlock, startSubBlock, direction, maxDistance, getBlock, getBlockBounds, hit
+        );
+    }
+};
+
+}  // namespace
+
+TEST_CASE( "A ray hits the face of the block it reaches", "[raycast]" ) {
+    TestWorld world;
+    world.blocks[IVec3(0, -1, 0)] = STONE;
+    RaycastHit hit;
+
+    REQUIRE( world.raycast(IVec3(0, 1, 0), Vec3(0.5f, 0.5f, 0.5f), Vec3(0.0f, -1.0f, 0.0f),
+        4.5f, &hit) );
+    REQUIRE( hit.blockCoords == IVec3(0, -1, 0) );
+    REQUIRE( hit.normal == IVec3(0, 1, 0) );
+    REQUIRE( hit.blockType == STONE );
+    REQUIRE( hit.distance == Catch::Approx(1.5f) );
+}
+
+TEST_CASE( "A ray visits each block it crosses exactly once", "[raycast]" ) {
+    TestWorld world;
+    RaycastHit hit;
+    Vec3 direction(0.6f, 0.48f, 0.64f);
+
+    REQUIRE( !world.raycast(IVec3(-3, 7, 2), Vec3(0.1f, 0.9f, 0.3f), direction, 4.5f, &hit) );
+    for (size_t i = 1; i < world.visited.size(); i++)
+    {
+        const IVec3& previous = world.visited[i - 1];
+        const IVec3& current = world.visited[i];
+        int stepLength = std::abs(current.x - previous.x) + std::abs(current.y - previous.y)
+            + std::abs(current.z - previous.z);
+        REQUIRE( stepLength == 1 );
+    }
+    // Crossing about 4.5 * (0.6 + 0.48 + 0.64) block boundaries, plus the starting block
+    REQUIRE( world.visited.size() <= 10 );
+}
+
+TEST_CASE( "A ray hits a block it only clips the corner of", "[raycast]" ) {
+    TestWorld world;
+    world.blocks[IVec3(1, 0, 1)] = STONE;
+    RaycastHit hit;
+    Vec3 direction = Vec3(1.0f, 0.0f, 1.0f) * (1.0f / std::sqrt(2.0f));
+
+    REQUIRE( world.raycast(IVec3(0, 0, 0), Vec3(0.45f, 0.5f, 0.55f), direction, 4.5f, &hit) );
+    REQUIRE( hit.blockCoords == IVec3(1, 0, 1) );
+    REQUIRE( hit.normal == IVec3(-1, 0, 0) );
+}
+
+TEST_CASE( "Rays are tested against the exact bounding box of the block", "[raycast]" ) {
+    TestWorld world;
+    world.blocks[IVec3(2, 0, 0)] = SLAB;
+    world.blocks[IVec3(4, 0, 0)] = STONE;
+    RaycastHit hit;
+
+    // Passes over the top of the slab
+    REQUIRE( world.raycast(IVec3(0, 0, 0), Vec3(0.5f, 0.75f, 0.5f), Vec3(1.0f, 0.0f, 0.0f),
+        4.5f, &hit) );
+    REQUIRE( hit.blockCoords == IVec3(4, 0, 0) );
+
+    // Hits the top of the slab
+    Vec3 direction = Vec3(1.0f, -0.25f, 0.0f) * (1.0f / std::sqrt(1.0625f));
+    REQUIRE( world.raycast(IVec3(0, 0, 0), Vec3(0.5f, 1.0f, 0.5f), direction, 4.5f, &hit) );
+    REQUIRE( hit.blockCoords == IVec3(2, 0, 0) );
+    REQUIRE( hit.normal == IVec3(0, 1, 0) );
+}
+
+TEST_CASE( "Rays stop at their maximum distance and at unloaded blocks", "[raycast]" ) {
+    TestWorld world;
+    world.blocks[IVec3(0, 0, -6)] = STONE;
+    RaycastHit hit;
+
+    REQUIRE( !world.raycast(IVec3(0, 0, 0), Vec3(0.5f), Vec3(0.0f, 0.0f, -1.0f), 4.5f, &hit) );
+    REQUIRE( world.raycast(IVec3(0, 0, 0), Vec3(0.5f), Vec3(0.0f, 0.0f, -1.0f), 6.0f, &hit) );
+
+    world.blocks[IVec3(0, -3, 0)] = STONE;
+    world.unloadedBelowY = -1;
+    REQUIRE( !world.raycast(IVec3(0, 0, 0), Vec3(0.5f), Vec3(0.0f, -1.0f, 0.0f), 4.5f, &hit) );
+}
+
+TEST_CASE( "A ray that starts inside a block hits it with no normal", "[raycast]" ) {
+    TestWorld world;
+    world.blocks[IVec3(-1, -1, -1)] = STONE;
+    RaycastHit hit;
+
+    REQUIRE( world.raycast(IVec3(-1, -1, -1), Vec3(0.5f), Vec3(0.0f, 1.0f, 0.0f), 4.5f, &hit) );
+    REQUIRE( hit.blockCoords == IVec3(-1, -1, -1) );
+    REQUIRE( hit.normal == IVec3(0, 0, 0) );
+    REQUIRE( hit.distance == 0.0f );
+}
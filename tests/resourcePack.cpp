@@ -0,0 +1,155 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "core/resourcePack.h"
+
+#include "testResourcePack.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace lonelycube;
+
+// Adds a block whose model is a full cube, with a face culled in each direction
+static void addFullCube(const std::filesystem::path& resourcePackPath)
+{
+    writeFile(
+        resourcePackPath/"blocks/blockNames.json",
+        "[\n    \"air\",\n    \"dirt\",\n    \"stone\"\n]\n"
+    );
+    writeFile(
+        resourcePackPath/"blocks/blockData/stone.json",
+        "{\n    \"model\": \"fullCube\",\n    \"textureIndices\": [0,0,0,0,0,0]\n}\n"
+    );
+    std::string model = "{\n    \"boundingBox\": [-8,-8,-8, 8,8,8],\n    \"faces\":\n    [\n";
+    const char* directions[6] = { "negY", "posY", "negX", "posX", "negZ", "posZ" };
+    for (int faceNum = 0; faceNum < 6; faceNum++)
+    {
+        model += std::string(faceNum > 0 ? ",\n" : "") + "        {\n"
+            "            \"coordinates\": [-8,-8,-8, 8,-8,-8, 8,-8,8, -8,-8,8],\n"
+            "            \"uv\": [0,0, 16,16],\n            \"cullFace\": \""
+            + directions[faceNum] + "\"\n        }";
+    }
+    model += "\n    ]\n}\n";
+    writeFile(resourcePackPath/"blocks/blockModels/fullCube.json", model);
+}
+
+static void requireSameBlockData(const ResourcePack& a, const ResourcePack& b)
+{
+    for (int blockID = 0; blockID < 256; blockID++)
+    {
+        const BlockData& blockA = a.getBlockData(blockID);
+        const BlockData& blockB = b.getBlockData(blockID);
+        REQUIRE(blockA.name == blockB.name);
+        REQUIRE(blockA.faceTextureIndices == blockB.faceTextureIndices);
+        REQUIRE(blockA.faceTextureCoordinates == blockB.faceTextureCoordinates);
+        REQUIRE(blockA.transparent == blockB.transparent);
+        REQUIRE(blockA.dimsLight == blockB.dimsLight);
+        REQUIRE(blockA.castsAmbientOcclusion == blockB.castsAmbientOcclusion);
+        REQUIRE(blockA.collidable == blockB.collidable);
+        REQUIRE(blockA.blockLight == blockB.blockLight);
+        REQUIRE((blockA.model == nullptr) == (blockB.model == nullptr));
+        if (blockA.model == nullptr)
+            continue;
+
+        REQUIRE(blockA.model->faces.size() == blockB.model->faces.size());
+        REQUIRE(std::memcmp(
+            blockA.model->faces.data(), blockB.model->faces.data(),
+            blockA.model->faces.size() * sizeof(Face)
+        ) == 0);
+        REQUIRE(std::memcmp(
+            blockA.model->boundingBoxVertices, blockB.model->boundingBoxVertices,
+            sizeof(Model::boundingBoxVertices)
+        ) == 0);
+    }
+}
+
+TEST_CASE("The resource pack cache loads the same blocks as the JSON files", "[ResourcePack]")
+{
+    std::filesystem::path resourcePackPath = createResourcePack("lonelycubeResourcePackTest");
+    ResourcePack parsed(resourcePackPath);
+    REQUIRE(!parsed.wasLoadedFromCache());
+    REQUIRE(std::filesystem::exists(ResourcePack::getCachePath(resourcePackPath)));
+
+    ResourcePack cached(resourcePackPath);
+    REQUIRE(cached.wasLoadedFromCache());
+    requireSameBlockData(parsed, cached);
+
+    const BlockData& dirt = cached.getBlockData(1);
+    REQUIRE(dirt.name == "dirt");
+    REQUIRE(dirt.model != nullptr);
+    REQUIRE(dirt.faceTextureCoordinates.size() == 8);
+    float textureCoordinates[8];
+    ResourcePack::getTextureCoordinates(textureCoordinates, dirt.model->faces[0].UVcoords, 3);
+    REQUIRE(std::memcmp(
+        textureCoordinates, dirt.faceTextureCoordinates.data(), sizeof(textureCoordinates)
+    ) == 0);
+    REQUIRE(cached.getBlockData(0).model == nullptr);
+    REQUIRE(!cached.getBlockData(0).collidable);
+
+    std::filesystem::remove_all(resourcePackPath.parent_path());
+}
+
+TEST_CASE("Changing a source file rebuilds the resource pack cache", "[ResourcePack]")
+{
+    std::filesystem::path resourcePackPath = createResourcePack("lonelycubeResourcePackTest");
+    REQUIRE(!ResourcePack(resourcePackPath).wasLoadedFromCache());
+    REQUIRE(ResourcePack(resourcePackPath).wasLoadedFromCache());
+
+    writeFile(
+        resourcePackPath/"blocks/blockData/dirt.json",
+        "{\n    \"transparrent\": true,\n    \"model\": \"cube\",\n"
+        "    \"textureIndices\": [3]\n}\n"
+    );
+    ResourcePack changed(resourcePackPath);
+    REQUIRE(!changed.wasLoadedFromCache());
+    REQUIRE(changed.getBlockData(1).transparent);
+    REQUIRE(ResourcePack(resourcePackPath).getBlockData(1).transparent);
+
+    // Adding a file also makes the cache stale
+    writeFile(resourcePackPath/"blocks/blockModels/unused.json", "{}\n");
+    REQUIRE(!ResourcePack(resourcePackPath).wasLoadedFromCache());
+
+    std::filesystem::remove_all(resourcePackPath.parent_path());
+}
+
+TEST_CASE("The block property tables match the block data", "[ResourcePack]")
+{
+    std::filesystem::path resourcePackPath = createResourcePack("lonelycubeResourcePackTest");
+    addFullCube(resourcePackPath);
+    ResourcePack resourcePack(resourcePackPath);
+
+    for (int blockID = 0; blockID < 256; blockID++)
+    {
+        const BlockData& blockData = resourcePack.getBlockData(blockID);
+        REQUIRE(resourcePack.isTransparent(blockID) == blockData.transparent);
+        REQUIRE(resourcePack.dimsLight(blockID) == blockData.dimsLight);
+        REQUIRE(resourcePack.castsAmbientOcclusion(blockID) == blockData.castsAmbientOcclusion);
+        REQUIRE(resourcePack.isCollidable(blockID) == blockData.collidable);
+        REQUIRE(resourcePack.getBlockLight(blockID) == blockData.blockLight);
+    }
+
+    REQUIRE(resourcePack.getCullMask(0) == 0);
+    REQUIRE(!resourcePack.isFullCube(0));
+    // dirt's only face is culled by the block below it
+    REQUIRE(resourcePack.getCullMask(1) == 1);
+    REQUIRE(!resourcePack.isFullCube(1));
+    REQUIRE(resourcePack.getCullMask(2) == 0b111111);
+    REQUIRE(resourcePack.isFullCube(2));
+
+    std::filesystem::remove_all(resourcePackPath.parent_path());
+}
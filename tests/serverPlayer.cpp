@@ -0,0 +1,89 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/serverPlayer.h"
+
+#include "core/constants.h"
+#include "core/utils/iVec3.h"
+#include "core/utils/vec3.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace lonelycube;
+
+namespace {
+
+void moveToChunk(ServerPlayer& player, int chunkX)
+{
+    player.updatePlayerPos(IVec3(chunkX * constants::CHUNK_SIZE, 0, 0), Vec3(0.5f, 0.5f, 0.5f));
+}
+
+// Marks the 3x3 plane of chunks at x as loaded, as the chunk loader threads do for a player with a
+// render distance of one
+void loadPlane(ServerPlayer& player, int x, uint64_t tick)
+{
+    for (int y = -1; y <= 1; y++)
+    {
+        for (int z = -1; z <= 1; z++)
+            player.setChunkLoaded(IVec3(x, y, z), tick);
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Chunks loaded again before the unload sweep stay loaded", "[ServerPlayer]")
+{
+    int blockPosition[3] = { 0, 0, 0 };
+    float subBlockPosition[3] = { 0.5f, 0.5f, 0.5f };
+    ServerPlayer player(0, blockPosition, subBlockPosition, 1, false);
+    int chunkCoords[3];
+    while (player.updateNextUnloadedChunk())
+        player.getNextChunkCoords(chunkCoords, 1);
+
+    // Loading the chunks ahead of the player evicts the ones behind them from the grid, then
+    // moving back loads those again before the unload sweep has run
+    moveToChunk(player, 1);
+    loadPlane(player, 2, 2);
+    REQUIRE(!player.hasChunkLoaded(IVec3(-1, 0, 0)));
+    moveToChunk(player, 0);
+    loadPlane(player, -1, 3);
+    REQUIRE(player.hasChunkLoaded(IVec3(-1, 0, 0)));
+    REQUIRE(!player.hasChunkLoaded(IVec3(2, 0, 0)));
+
+    player.beginUnloadingChunksOutOfRange();
+    IVec3 chunkPosition;
+    bool chunkOutOfRange;
+    int numChunksUnloaded = 0;
+    int numChunksKept = 0;
+    while (player.checkIfNextChunkShouldUnload(&chunkPosition, &chunkOutOfRange))
+    {
+        REQUIRE(chunkOutOfRange == !player.hasChunkLoaded(chunkPosition));
+        if (chunkOutOfRange)
+        {
+            REQUIRE(chunkPosition.x == 2);
+            numChunksUnloaded++;
+        }
+        else
+        {
+            REQUIRE(chunkPosition.x == -1);
+            numChunksKept++;
+        }
+    }
+    REQUIRE(numChunksUnloaded == 9);
+    REQUIRE(numChunksKept == 9);
+    REQUIRE(player.hasChunkLoaded(IVec3(-1, 0, 0)));
+}
@@ -0,0 +1,87 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/entities/spatialHash.h"
+
+#include "core/entities/ECS.h"
+#include "core/utils/iVec3.h"
+#include "core/utils/vec3.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace lonelycube;
+
+namespace {
+
+std::vector<EntityId> findNear(
+    const SpatialHash& hash, const IVec3& blockCoords, const Vec3& subBlockCoords, float radius
+) {
+    std::vector<EntityId> entities;
+    hash.forEachNear(blockCoords, subBlockCoords, radius, [&](EntityId entity) {
+        entities.push_back(entity);
+    });
+    std::sort(entities.begin(), entities.end());
+    return entities;
+}
+
+}  // namespace
+
+TEST_CASE("Entities are found from the cells around a position", "[SpatialHash]")
+{
+    SpatialHash hash;
+    hash.insert(1, IVec3(4, 0, 0), Vec3(0.9f, 0.5f, 0.5f));
+    // Just over the border of the next cell, and of the cell on the other side of zero
+    hash.insert(2, IVec3(5, 0, 0), Vec3(0.1f, 0.5f, 0.5f));
+    hash.insert(3, IVec3(-1, 0, -1), Vec3(0.9f, 0.5f, 0.9f));
+    hash.insert(4, IVec3(0, 0, 0), Vec3(0.1f, 0.5f, 0.1f));
+    hash.insert(5, IVec3(20, 0, 0), Vec3(0.5f, 0.5f, 0.5f));
+    REQUIRE(hash.size() == 5);
+
+    REQUIRE(findNear(hash, IVec3(4, 0, 0), Vec3(0.9f, 0.5f, 0.5f), 0.5f)
+        == std::vector<EntityId>{ 1, 2 });
+    REQUIRE(findNear(hash, IVec3(0, 0, 0), Vec3(0.1f, 0.5f, 0.1f), 0.5f)
+        == std::vector<EntityId>{ 3, 4 });
+    // The search covers whole cells, so it can include entities further away than the radius
+    REQUIRE(findNear(hash, IVec3(4, 0, 0), Vec3(0.5f, 0.5f, 0.5f), 0.1f)
+        == std::vector<EntityId>{ 1 });
+    REQUIRE(findNear(hash, IVec3(10, 0, 0), Vec3(0.5f, 0.5f, 0.5f), 0.5f).empty());
+
+    hash.clear();
+    REQUIRE(hash.size() == 0);
+    REQUIRE(findNear(hash, IVec3(4, 0, 0), Vec3(0.9f, 0.5f, 0.5f), 0.5f).empty());
+}
+
+TEST_CASE("Removed entries are no longer found and are reused", "[SpatialHash]")
+{
+    SpatialHash hash;
+    const IVec3 cell(-3, 7, 2);
+    for (EntityId entity = 1; entity <= 3; entity++)
+        hash.insert(entity, cell);
+    hash.insert(4, cell + IVec3(1, 0, 0));
+
+    hash.remove(2, cell);
+    // Removing an entity from a cell it isn't in does nothing
+    hash.remove(4, cell);
+    hash.remove(1, cell - IVec3(1, 0, 0));
+    REQUIRE(hash.size() == 3);
+    REQUIRE(findNear(hash, cell, Vec3(0.5f), 0.4f) == std::vector<EntityId>{ 1, 3 });
+
+    hash.insert(5, cell);
+    REQUIRE(hash.size() == 4);
+    REQUIRE(findNear(hash, cell, Vec3(0.5f), 0.4f) == std::vector<EntityId>{ 1, 3, 5 });
+    REQUIRE(findNear(hash, cell, Vec3(0.5f), 1.0f) == std::vector<EntityId>{ 1, 3, 4, 5 });
+}
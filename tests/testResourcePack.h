@@ -0,0 +1,60 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "core/pch.h"
+
+namespace lonelycube {
+
+inline void writeFile(const std::filesystem::path& path, const std::string& contents)
+{
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
+// Writes a resource pack with air and a dirt block whose model has one face to a fresh
+// directory with the given name in the temp directory, and returns the resource pack's path.
+// The caller should remove its parent directory once finished with it.
+inline std::filesystem::path createResourcePack(const std::string& directoryName)
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / directoryName;
+    std::filesystem::remove_all(directory);
+    std::filesystem::path resourcePackPath = directory/"resourcePack";
+    writeFile(resourcePackPath/"blocks/blockNames.json", "[\n    \"air\",\n    \"dirt\"\n]\n");
+    writeFile(
+        resourcePackPath/"blocks/blockData/air.json",
+        "{\n    \"transparrent\": true,\n    \"collidable\": false\n}\n"
+    );
+    writeFile(
+        resourcePackPath/"blocks/blockData/dirt.json",
+        "{\n    \"model\": \"cube\",\n    \"textureIndices\": [3]\n}\n"
+    );
+    writeFile(
+        resourcePackPath/"blocks/blockModels/cube.json",
+        "{\n    \"boundingBox\": [-8,-8,-8, 8,8,8],\n    \"faces\":\n    [\n        {\n"
+        "            \"coordinates\": [-8,-8,-8, 8,-8,-8, 8,-8,8, -8,-8,8],\n"
+        "            \"uv\": [0,0, 16,16],\n            \"ambientOcclusion\": true,\n"
+        "            \"lighting\": \"negY\",\n            \"cullFace\": \"negY\"\n"
+        "        }\n    ]\n}\n"
+    );
+    return resourcePackPath;
+}
+
+}  // namespace lonelycube
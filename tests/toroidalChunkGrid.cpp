@@ -0,0 +1,160 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/toroidalChunkGrid.h"
+
+#include "core/utils/iVec3.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace lonelycube;
+
+namespace {
+
+constexpr int DIAMETER = 5;
+constexpr int RADIUS = DIAMETER / 2;
+
+std::unordered_set<IVec3> getChunks(const ToroidalChunkGrid& grid)
+{
+    std::unordered_set<IVec3> chunks;
+    grid.forEachChunk([&](const IVec3& chunkPosition) {
+        REQUIRE(chunks.insert(chunkPosition).second);
+    });
+    return chunks;
+}
+
+}  // namespace
+
+TEST_CASE("Chunks at negative coordinates can be found, listed and erased", "[ToroidalChunkGrid]")
+{
+    ToroidalChunkGrid grid(DIAMETER);
+    const IVec3 chunks[] = { IVec3(-1, -1, -1), IVec3(-5, 0, -6), IVec3(-12, -7, 3) };
+    IVec3 evictedChunk;
+    for (int i = 0; i < 3; i++)
+        REQUIRE(!grid.insert(chunks[i], i + 10, &evictedChunk));
+
+    for (int i = 0; i < 3; i++)
+    {
+        REQUIRE(grid.contains(chunks[i]));
+        uint64_t tick;
+        REQUIRE(grid.getTick(chunks[i], &tick));
+        REQUIRE(tick == static_cast<uint64_t>(i + 10));
+    }
+    REQUIRE(!grid.contains(IVec3(-1, -1, 0)));
+    REQUIRE(!grid.contains(IVec3(-6, 0, -6)));
+    REQUIRE(getChunks(grid) == std::unordered_set<IVec3>(std::begin(chunks), std::end(chunks)));
+
+    REQUIRE(grid.erase(IVec3(-5, 0, -6)));
+    REQUIRE(!grid.erase(IVec3(-5, 0, -6)));
+    REQUIRE(!grid.contains(IVec3(-5, 0, -6)));
+    REQUIRE(getChunks(grid) == std::unordered_set<IVec3>{ chunks[0], chunks[2] });
+}
+
+TEST_CASE("Positions one wrap apart share a slot but aren't mistaken for each other",
+    "[ToroidalChunkGrid]")
+{
+    ToroidalChunkGrid grid(DIAMETER);
+    const IVec3 chunk(2, -3, 4);
+    // -3 and 7 are both 2 modulo the diameter
+    const IVec3 aliases[] = {
+        chunk + IVec3(DIAMETER, 0, 0), IVec3(-3, -3, 4), chunk + IVec3(0, DIAMETER, 0),
+        chunk - IVec3(0, 0, DIAMETER)
+    };
+    IVec3 evictedChunk;
+    REQUIRE(!grid.insert(chunk, 1, &evictedChunk));
+    for (const IVec3& alias : aliases)
+    {
+        REQUIRE(!grid.contains(alias));
+        uint64_t tick;
+        REQUIRE(!grid.getTick(alias, &tick));
+        REQUIRE(!grid.erase(alias));
+    }
+    REQUIRE(grid.contains(chunk));
+
+    // Inserting an alias evicts the chunk in its slot, but inserting the same chunk again doesn't
+    REQUIRE(grid.insert(aliases[1], 2, &evictedChunk));
+    REQUIRE(evictedChunk == chunk);
+    REQUIRE(!grid.contains(chunk));
+    REQUIRE(grid.contains(aliases[1]));
+    REQUIRE(!grid.insert(aliases[1], 3, &evictedChunk));
+    uint64_t tick;
+    REQUIRE(grid.getTick(aliases[1], &tick));
+    REQUIRE(tick == 3);
+    REQUIRE(getChunks(grid) == std::unordered_set<IVec3>{ aliases[1] });
+}
+
+TEST_CASE("Recentring across a wrap evicts exactly the chunks that left the cube",
+    "[ToroidalChunkGrid]")
+{
+    ToroidalChunkGrid grid(DIAMETER);
+    auto insertCube = [&](const IVec3& centre, std::unordered_set<IVec3>& evictedChunks) {
+        std::unordered_set<IVec3> cube;
+        IVec3 offset;
+        for (offset.x = -RADIUS; offset.x <= RADIUS; offset.x++)
+        {
+            for (offset.y = -RADIUS; offset.y <= RADIUS; offset.y++)
+            {
+                for (offset.z = -RADIUS; offset.z <= RADIUS; offset.z++)
+                {
+                    IVec3 evictedChunk;
+                    if (grid.insert(centre + offset, 0, &evictedChunk))
+                        REQUIRE(evictedChunks.insert(evictedChunk).second);
+                    cube.insert(centre + offset);
+                }
+            }
+        }
+        return cube;
+    };
+
+    // The first cube spans x from -1 to 3 and the second from 1 to 5, so both cross a
+    // multiple of the diameter
+    std::unordered_set<IVec3> evictedChunks;
+    std::unordered_set<IVec3> oldCube = insertCube(IVec3(1, -2, 0), evictedChunks);
+    REQUIRE(evictedChunks.empty());
+    REQUIRE(getChunks(grid) == oldCube);
+
+    std::unordered_set<IVec3> newCube = insertCube(IVec3(3, -3, 0), evictedChunks);
+    REQUIRE(getChunks(grid) == newCube);
+    for (const IVec3& chunk : oldCube)
+    {
+        REQUIRE(evictedChunks.contains(chunk) == !newCube.contains(chunk));
+        REQUIRE(grid.contains(chunk) == newCube.contains(chunk));
+    }
+    for (const IVec3& chunk : evictedChunks)
+        REQUIRE(oldCube.contains(chunk));
+}
+
+TEST_CASE("Far away chunks and late ticks are stored exactly", "[ToroidalChunkGrid]")
+{
+    ToroidalChunkGrid grid(DIAMETER);
+    const IVec3 chunk(200003, -300002, 1000001);
+    // Its wrap along x differs from the chunk's by exactly 2^16
+    const IVec3 alias = chunk + IVec3(65536 * DIAMETER, 0, 0);
+    const uint64_t lateTick = (1ull << 40) + 7;
+    IVec3 evictedChunk;
+    REQUIRE(!grid.insert(chunk, lateTick, &evictedChunk));
+    REQUIRE(grid.contains(chunk));
+    REQUIRE(!grid.contains(alias));
+    uint64_t tick;
+    REQUIRE(grid.getTick(chunk, &tick));
+    REQUIRE(tick == lateTick);
+    REQUIRE(getChunks(grid) == std::unordered_set<IVec3>{ chunk });
+
+    REQUIRE(grid.insert(alias, 0, &evictedChunk));
+    REQUIRE(evictedChunk == chunk);
+    REQUIRE(getChunks(grid) == std::unordered_set<IVec3>{ alias });
+}
@@ -0,0 +1,174 @@
+/*
+  Lonely Cube, a voxel game
+  Copyright (C) 2024-2025 Bertie Cartwright
+
+  Lonely Cube is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Lonely Cube is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/worldCursor.h"
+
+#include "core/chunk.h"
+#include "core/constants.h"
+#include "core/utils/iVec3.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace lonelycube;
+
+namespace {
+
+constexpr int CS = constants::CHUNK_SIZE;
+
+uint8_t expectedBlock(const IVec3& position)
+{
+    return (position.x * 7 + position.y * 13 + position.z * 31) & 0xff;
+}
+
+uint8_t expectedSkyLight(const IVec3& position)
+{
+    return (position.x + 2 * position.y + 3 * position.z) & constants::skyLightMaxValue;
+}
+
+uint8_t expectedBlockLight(const IVec3& position)
+{
+    return (3 * position.x + position.y + 2 * position.z) & constants::blockLightMaxValue;
+}
+
+// The eight chunks around the origin, apart from the one at (0, -1, -1)
+struct TestWorld
+{
+    static inline const IVec3 missingChunk{ 0, -1, -1 };
+
+    std::unordered_map<IVec3, Chunk> chunks;
+
+    TestWorld()
+    {
+        for (int x = -1; x <= 0; x++)
+        for (int y = -1; y <= 0; y++)
+        for (int z = -1; z <= 0; z++)
+        {
+            IVec3 chunkPosition(x, y, z);
+            if (chunkPosition == missingChunk)
+                continue;
+            Chunk& chunk = chunks.emplace(chunkPosition, Chunk(chunkPosition)).first->second;
+            for (uint32_t blockNum = 0; blockNum < CS * CS * CS; blockNum++)
+            {
+                IVec3 position(
+                    x * CS + blockNum % CS, y * CS + blockNum / (CS * CS),
+                    z * CS + blockNum / CS % CS
+                );
+                chunk.setBlock(blockNum, expectedBlock(position));
+                chunk.setSkyLight(blockNum, expectedSkyLight(position));
+                chunk.setBlockLight(blockNum, expectedBlockLight(position));
+            }
+        }
+    }
+
+    ~TestWorld()
+    {
+        for (auto& [chunkPosition, chunk] : chunks)
+            chunk.unload();
+    }
+
+    bool loaded(const IVec3& position) const
+    {
+        return chunks.contains(Chunk::getChunkCoords(position));
+    }
+};
+
+void checkCursor(const WorldCursor& cursor, const IVec3& position, const TestWorld& world)
+{
+    REQUIRE(cursor.getPosition() == position);
+    if (world.loaded(position))
+    {
+        REQUIRE(cursor.chunkLoaded());
+        REQUIRE(cursor.getBlock() == expectedBlock(position));
+        REQUIRE(cursor.getSkyLight() == expectedSkyLight(position));
+        REQUIRE(cursor.getBlockLight() == expectedBlockLight(position));
+    }
+    else
+    {
+        REQUIRE(!cursor.chunkLoaded());
+        REQUIRE(cursor.getBlock() == 0);
+        REQUIRE(cursor.getSkyLight() == 0);
+        REQUIRE(cursor.getBlockLight() == 0);
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Moving the cursor to a position reads that block", "[WorldCursor]")
+{
+    TestWorld world;
+    WorldCursor cursor(world.chunks);
+    for (int x = -CS - 2; x < CS + 2; x += 3)
+    {
+        for (int y = -CS - 2; y < CS + 2; y += 5)
+        {
+            for (int z = -CS - 2; z < CS + 2; z += 7)
+            {
+                IVec3 position(x, y, z);
+                cursor.moveTo(position);
+                checkCursor(cursor, position, world);
+            }
+        }
+    }
+}
+
+TEST_CASE("Relative moves cross chunk borders", "[WorldCursor]")
+{
+    TestWorld world;
+    WorldCursor cursor(world.chunks);
+    IVec3 position(-3, -3, -3);
+    cursor.moveTo(position);
+    checkCursor(cursor, position, world);
+
+    // Walk back and forth across the borders between the chunks along each axis
+    for (int axis = 0; axis < 3; axis++)
+    {
+        for (int step = 0; step < 6; step++)
+        {
+            position[axis]++;
+            cursor.move(axis, 1);
+            checkCursor(cursor, position, world);
+        }
+        for (int step = 0; step < 6; step++)
+        {
+            position[axis]--;
+            cursor.move(axis, -1);
+            checkCursor(cursor, position, world);
+        }
+    }
+
+    IVec3 offset(5, -CS, 4);
+    position = position + offset;
+    cursor.move(offset);
+    checkCursor(cursor, position, world);
+}
+
+TEST_CASE("The cursor finds chunks again after moving far away", "[WorldCursor]")
+{
+    TestWorld world;
+    WorldCursor cursor(world.chunks);
+    IVec3 nearPosition(-5, 10, 3);
+    IVec3 farPosition(10 * CS, -4 * CS, 0);
+
+    cursor.moveTo(nearPosition);
+    checkCursor(cursor, nearPosition, world);
+    cursor.moveTo(farPosition);
+    checkCursor(cursor, farPosition, world);
+    cursor.moveTo(nearPosition);
+    checkCursor(cursor, nearPosition, world);
+    REQUIRE(cursor.getBlock(IVec3(2, -1, -1)) == 0);
+    REQUIRE(cursor.getBlock(IVec3(-1, -1, -1)) == expectedBlock(IVec3(-1, -1, -1)));
+}